@@ -0,0 +1,237 @@
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <optional>
+#include <random>
+#include <rudp.hpp>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "internal/compress.hpp"
+
+// Weighs what payload compression (RUDP_COMPRESSION) saves on the wire against what it costs in
+// CPU, for JSON log lines and for random bytes.
+//
+//   usage: rudp_bench_compression [megabytes] [link Mbit/s]
+//
+// The codec alone is timed over the corpus a segment at a time, as the library compresses it. A
+// transfer over the in-process loopback transport, with and without compression, then gives the
+// CPU time the whole process spends per megabyte and the fastest the stack can go. On a link of
+// the given rate, goodput is then whichever is lower: the link multiplied by the ratio, or that.
+
+namespace {
+[[noreturn]] void die(const char *what) {
+    perror(what);
+    exit(EXIT_FAILURE);
+}
+
+double cpu_seconds() {
+    timespec now{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) / 1e9;
+}
+
+std::vector<char> logs(size_t len) {
+    std::mt19937 gen(1);
+    const char *levels[] = {"debug", "info", "warn", "error"};
+    const char *paths[] = {"/api/v1/orders", "/api/v1/users", "/healthz", "/api/v1/search"};
+
+    std::vector<char> data;
+    data.reserve(len + 256);
+    while (data.size() < len) {
+        char line[256];
+        const int written = snprintf(
+            line, sizeof(line),
+            "{\"ts\":%u,\"level\":\"%s\",\"path\":\"%s\",\"status\":%u,\"latency_us\":%u,"
+            "\"request_id\":\"%08x\"}\n",
+            1700000000 + static_cast<unsigned>(data.size() / 64), levels[gen() % 4],
+            paths[gen() % 4], (gen() % 10 == 0) ? 500u : 200u,
+            static_cast<unsigned>(gen() % 50000), static_cast<unsigned>(gen()));
+        data.insert(data.end(), line, line + written);
+    }
+    data.resize(len);
+    return data;
+}
+
+std::vector<char> noise(size_t len) {
+    std::mt19937 gen(2);
+    std::vector<char> data(len);
+    for (char &byte : data) {
+        byte = static_cast<char>(gen());
+    }
+    return data;
+}
+
+struct codec_result {
+    double ratio;
+    double compress_mbps;
+    double decompress_mbps;
+};
+
+codec_result time_codec(const std::vector<char> &corpus) {
+    namespace internal = rudp::internal;
+    const auto *in = reinterpret_cast<const rudp::u8 *>(corpus.data());
+
+    std::vector<rudp::u8> out(corpus.size());
+    std::vector<size_t> sizes;  // NOTE: Zero for a block which did not shrink.
+    size_t compressed = 0;
+
+    const auto compress_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < corpus.size(); i += internal::MAX_LZ_BLOCK) {
+        const size_t len = std::min(internal::MAX_LZ_BLOCK, corpus.size() - i);
+        const size_t size =
+            internal::lz_compress(std::span(in + i, len), std::span(out).subspan(i, len));
+        sizes.push_back(size);
+        compressed += (size > 0) ? size : len;
+    }
+    const std::chrono::duration<double> compress_time =
+        std::chrono::steady_clock::now() - compress_start;
+
+    // NOTE: Only the blocks which shrank are ever decompressed.
+    std::vector<rudp::u8> back(internal::MAX_LZ_BLOCK);
+    size_t decompressed = 0;
+    const auto decompress_start = std::chrono::steady_clock::now();
+    for (size_t i = 0, block = 0; i < corpus.size(); i += internal::MAX_LZ_BLOCK, block++) {
+        if (sizes[block] == 0) {
+            continue;
+        }
+
+        std::optional<size_t> size =
+            internal::lz_decompress(std::span(out).subspan(i, sizes[block]), back);
+        if (!size.has_value()) {
+            die("rudp::internal::lz_decompress");
+        }
+        decompressed += size.value();
+    }
+    const std::chrono::duration<double> decompress_time =
+        std::chrono::steady_clock::now() - decompress_start;
+
+    constexpr double MEGABYTE = 1024 * 1024;
+    return {
+        .ratio = static_cast<double>(corpus.size()) / static_cast<double>(compressed),
+        .compress_mbps = static_cast<double>(corpus.size()) / MEGABYTE / compress_time.count(),
+        .decompress_mbps = (decompressed > 0) ? static_cast<double>(decompressed) / MEGABYTE /
+                                                    decompress_time.count()
+                                              : 0,
+    };
+}
+
+struct transfer_result {
+    double mbps;
+    double cpu_ms_per_mb;
+};
+
+transfer_result time_transfer(unsigned short port, bool compression,
+                              const std::vector<char> &corpus) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int serverfd = rudp::socket();
+    int clientfd = rudp::socket();
+
+    const int transport = rudp::RUDP_TRANSPORT_LOOPBACK;
+    const int enabled = compression ? 1 : 0;
+    if (rudp::setsockopt(serverfd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &transport,
+                         sizeof(transport)) < 0 ||
+        rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &transport,
+                         sizeof(transport)) < 0 ||
+        rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_COMPRESSION, &enabled,
+                         sizeof(enabled)) < 0) {
+        die("rudp::setsockopt");
+    }
+
+    if (rudp::bind(serverfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::bind");
+    }
+
+    if (rudp::listen(serverfd, 1) < 0) {
+        die("rudp::listen");
+    }
+
+    if (rudp::connect(clientfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::connect");
+    }
+
+    int acceptedfd = rudp::accept(serverfd, nullptr, nullptr);
+    if (acceptedfd < 0) {
+        die("rudp::accept");
+    }
+
+    const double cpu_start = cpu_seconds();
+    const auto start = std::chrono::steady_clock::now();
+
+    std::thread receiver([&]() {
+        std::vector<char> buf(64 * 1024);
+        size_t received = 0;
+
+        while (received < corpus.size()) {
+            ssize_t bytes = rudp::recv(acceptedfd, buf.data(), buf.size(), 0);
+            if (bytes <= 0) {
+                die("rudp::recv");
+            }
+            received += static_cast<size_t>(bytes);
+        }
+    });
+
+    constexpr size_t chunk = 64 * 1024;
+    size_t sent = 0;
+    while (sent < corpus.size()) {
+        ssize_t bytes =
+            rudp::send(clientfd, corpus.data() + sent, std::min(chunk, corpus.size() - sent), 0);
+        if (bytes <= 0) {
+            die("rudp::send");
+        }
+        sent += static_cast<size_t>(bytes);
+    }
+
+    receiver.join();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double cpu = cpu_seconds() - cpu_start;
+
+    const double megabytes = static_cast<double>(corpus.size()) / (1024 * 1024);
+    return {
+        .mbps = megabytes / elapsed.count(),
+        .cpu_ms_per_mb = cpu * 1000 / megabytes,
+    };
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const size_t megabytes = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 32;
+    const double link_mbit = (argc > 2) ? strtod(argv[2], nullptr) : 100;
+    const size_t total = megabytes * 1024 * 1024;
+
+    printf("%zu MB per run, projected onto a %.0f Mbit/s link\n\n", megabytes, link_mbit);
+    printf("%-6s %6s %12s %12s  %-4s %10s %10s %14s\n", "corpus", "ratio", "comp MB/s",
+           "decomp MB/s", "lz", "MB/s", "CPU ms/MB", "link MB/s");
+
+    const double link_mbps = link_mbit / 8 * 1e6 / (1024 * 1024);
+    unsigned short port = 9999;
+
+    for (const char *name : {"logs", "noise"}) {
+        const std::vector<char> corpus = (strcmp(name, "logs") == 0) ? logs(total) : noise(total);
+        const codec_result codec = time_codec(corpus);
+
+        for (bool compression : {false, true}) {
+            // NOTE: Sockets cannot be closed yet, so each run takes a port of its own.
+            const transfer_result transfer = time_transfer(port++, compression, corpus);
+            const double ratio = compression ? codec.ratio : 1.0;
+            const double goodput = std::min(link_mbps * ratio, transfer.mbps);
+
+            printf("%-6s %6.2f %12.0f %12.0f  %-4s %10.1f %10.2f %14.1f\n", name, codec.ratio,
+                   codec.compress_mbps, codec.decompress_mbps, compression ? "on" : "off",
+                   transfer.mbps, transfer.cpu_ms_per_mb, goodput);
+        }
+    }
+
+    return 0;
+}
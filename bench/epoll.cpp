@@ -0,0 +1,146 @@
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <rudp.hpp>
+
+// Shows that the cost of rudp::epoll_wait() follows the number of ready sockets rather than the
+// number registered. One thread ping-pongs over a single connection, waiting on both ends through
+// one epoll instance, while ever more idle sockets are registered alongside it.
+//
+//   usage: rudp_bench_epoll [round_trips]
+//
+// The loopback transport keeps the kernel out of the picture, so any growth with the idle count
+// would be the instance's own.
+
+namespace {
+constexpr size_t ping_bytes = 64;
+constexpr size_t idle_counts[] = {0, 1000, 10000, 100000};
+
+[[noreturn]] void die(const char *what) {
+    perror(what);
+    exit(EXIT_FAILURE);
+}
+
+void add(int epfd, int fd) {
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = fd}};
+    if (rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        die("rudp::epoll_ctl");
+    }
+}
+
+void await(int epfd, int fd) {
+    struct epoll_event events[16];
+
+    while (true) {
+        int n = rudp::epoll_wait(epfd, events, 16, -1);
+        if (n < 0) {
+            die("rudp::epoll_wait");
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.fd == fd) {
+                return;
+            }
+        }
+    }
+}
+
+void ping(int fd, const char *buf) {
+    if (rudp::send(fd, buf, ping_bytes, 0) != static_cast<ssize_t>(ping_bytes)) {
+        die("rudp::send");
+    }
+}
+
+void pong(int epfd, int fd, char *buf) {
+    size_t received = 0;
+    while (received < ping_bytes) {
+        await(epfd, fd);
+
+        ssize_t bytes = rudp::recv(fd, buf + received, ping_bytes - received, MSG_DONTWAIT);
+        if (bytes < 0 && errno != EAGAIN) {
+            die("rudp::recv");
+        }
+        received += (bytes > 0) ? static_cast<size_t>(bytes) : 0;
+    }
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const size_t round_trips = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000;
+    int transport = rudp::RUDP_TRANSPORT_LOOPBACK;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(9999);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int serverfd = rudp::socket();
+    int clientfd = rudp::socket();
+
+    if (rudp::setsockopt(serverfd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &transport,
+                         sizeof(transport)) < 0 ||
+        rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &transport,
+                         sizeof(transport)) < 0) {
+        die("rudp::setsockopt");
+    }
+
+    if (rudp::bind(serverfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::bind");
+    }
+
+    if (rudp::listen(serverfd, 1) < 0) {
+        die("rudp::listen");
+    }
+
+    if (rudp::connect(clientfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::connect");
+    }
+
+    int acceptedfd = rudp::accept(serverfd, nullptr, nullptr);
+    if (acceptedfd < 0) {
+        die("rudp::accept");
+    }
+
+    int epfd = rudp::epoll_create(1);
+    if (epfd < 0) {
+        die("rudp::epoll_create");
+    }
+
+    add(epfd, clientfd);
+    add(epfd, acceptedfd);
+
+    size_t idle = 0;
+    char buf[ping_bytes] = {};
+
+    for (size_t target : idle_counts) {
+        for (; idle < target; idle++) {
+            add(epfd, rudp::socket());
+        }
+
+        // NOTE: Registration reports sockets which are already ready, so the idle ones are each
+        // visited once here, off the clock.
+        struct epoll_event events[16];
+        while (rudp::epoll_wait(epfd, events, 16, 0) > 0) {
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < round_trips; i++) {
+            ping(clientfd, buf);
+            pong(epfd, acceptedfd, buf);
+            ping(acceptedfd, buf);
+            pong(epfd, clientfd, buf);
+        }
+        auto elapsed =
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+        printf("%6zu idle sockets: %.1f us per %zu byte round trip\n", idle,
+               elapsed.count() / static_cast<double>(round_trips), ping_bytes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <rudp.hpp>
+#include <vector>
+
+#include "internal/simulator.hpp"
+
+// Compares message delivery latency with and without FEC repairs, as the simulator drops a rising
+// share of datagrams in both directions. Each message is sent only once the previous one has been
+// received in full, so every figure is a single message's time from send() to its last byte.
+//
+//   usage: rudp_bench_fec [messages] [bytes] [group]
+//
+// Without FEC a lost segment waits out a retransmission timeout, which shows in the tail; with it
+// the segment is rebuilt as soon as the rest of its group and the repair arrive.
+
+namespace {
+[[noreturn]] void die(const char *what) {
+    perror(what);
+    exit(EXIT_FAILURE);
+}
+
+struct percentiles {
+    double p50;
+    double p99;
+    double max;
+};
+
+percentiles run(unsigned short port, int group, float drop, size_t messages, size_t bytes) {
+    auto &sim = rudp::internal::simulator::instance();
+    sim.reset();
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int serverfd = rudp::socket();
+    int clientfd = rudp::socket();
+
+    if (rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_FEC, &group, sizeof(group)) < 0) {
+        die("rudp::setsockopt");
+    }
+
+    if (rudp::bind(serverfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::bind");
+    }
+
+    if (rudp::listen(serverfd, 1) < 0) {
+        die("rudp::listen");
+    }
+
+    if (rudp::connect(clientfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::connect");
+    }
+
+    int acceptedfd = rudp::accept(serverfd, nullptr, nullptr);
+    if (acceptedfd < 0) {
+        die("rudp::accept");
+    }
+
+    // NOTE: Only once connected, so that the handshake is not what is measured.
+    sim.drop = drop;
+
+    std::vector<char> buf(bytes, 'x');
+    std::vector<double> latencies;
+    latencies.reserve(messages);
+
+    for (size_t i = 0; i < messages; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        if (rudp::send(clientfd, buf.data(), bytes, 0) != static_cast<ssize_t>(bytes)) {
+            die("rudp::send");
+        }
+
+        size_t received = 0;
+        while (received < bytes) {
+            ssize_t got = rudp::recv(acceptedfd, buf.data(), bytes - received, 0);
+            if (got <= 0) {
+                die("rudp::recv");
+            }
+            received += static_cast<size_t>(got);
+        }
+
+        latencies.push_back(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                .count());
+    }
+
+    // NOTE: Sockets cannot be closed yet, so each run takes a port of its own.
+    sim.reset();
+
+    if (latencies.empty()) {
+        return {};
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    return {
+        .p50 = latencies[latencies.size() / 2],
+        .p99 = latencies[latencies.size() * 99 / 100],
+        .max = latencies.back(),
+    };
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const size_t messages = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 100;
+    const size_t bytes = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 4096;
+    const int group = (argc > 3) ? atoi(argv[3]) : 4;
+
+    printf("%zu messages of %zu bytes, FEC groups of %d\n", messages, bytes, group);
+    printf("%6s  %-6s %10s %10s %10s\n", "drop", "fec", "p50 ms", "p99 ms", "max ms");
+
+    unsigned short port = 9999;
+    for (float drop : {0.05f, 0.1f, 0.2f, 0.3f}) {
+        for (int fec : {0, group}) {
+            const percentiles result = run(port++, fec, drop, messages, bytes);
+            printf("%5.0f%%  %-6s %10.2f %10.2f %10.2f\n", static_cast<double>(drop) * 100,
+                   fec ? "on" : "off", result.p50, result.p99, result.max);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <arpa/inet.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <rudp.hpp>
+#include <thread>
+#include <vector>
+
+// Measures the CPU cost per segment of a bulk transfer in order, which is the case the receive
+// path predicts. Both ends live in this process and use the loopback transport, so no datagram
+// ever reaches the kernel and the figure is the protocol stack alone, sender and receiver together.
+//
+//   usage: rudp_bench_segment_cost [segments] [bytes]
+//
+// Cycles are counted across every thread through perf_event_open() where the kernel allows it;
+// otherwise only the process CPU time is reported.
+
+namespace {
+[[noreturn]] void die(const char *what) {
+    perror(what);
+    exit(EXIT_FAILURE);
+}
+
+// NOTE: Opened before any socket, so that it is inherited by the event thread.
+int open_cycle_counter() {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+double cpu_ns() {
+    timespec now{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) * 1e9 + static_cast<double>(now.tv_nsec);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const size_t segments = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 200000;
+    const size_t bytes = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 1024;
+    const size_t total = segments * bytes;
+
+    const int counter = open_cycle_counter();
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(9999);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int transport = rudp::RUDP_TRANSPORT_LOOPBACK;
+    int serverfd = rudp::socket();
+    int clientfd = rudp::socket();
+
+    if (rudp::setsockopt(serverfd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &transport,
+                         sizeof(transport)) < 0 ||
+        rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &transport,
+                         sizeof(transport)) < 0) {
+        die("rudp::setsockopt");
+    }
+
+    if (rudp::bind(serverfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::bind");
+    }
+
+    if (rudp::listen(serverfd, 1) < 0) {
+        die("rudp::listen");
+    }
+
+    if (rudp::connect(clientfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::connect");
+    }
+
+    int acceptedfd = rudp::accept(serverfd, nullptr, nullptr);
+    if (acceptedfd < 0) {
+        die("rudp::accept");
+    }
+
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    const double start = cpu_ns();
+
+    std::thread receiver([&]() {
+        std::vector<char> buf(64 * 1024);
+        size_t received = 0;
+
+        while (received < total) {
+            ssize_t got = rudp::recv(acceptedfd, buf.data(), buf.size(), 0);
+            if (got <= 0) {
+                die("rudp::recv");
+            }
+            received += static_cast<size_t>(got);
+        }
+    });
+
+    // NOTE: One segment per send, so that the count of segments is exactly what was asked for.
+    std::vector<char> buf(bytes, 'x');
+    for (size_t i = 0; i < segments; i++) {
+        if (rudp::send(clientfd, buf.data(), bytes, 0) != static_cast<ssize_t>(bytes)) {
+            die("rudp::send");
+        }
+    }
+
+    receiver.join();
+
+    const double elapsed = cpu_ns() - start;
+    printf("%zu segments of %zu bytes: %.0f ns cpu/segment", segments, bytes,
+           elapsed / static_cast<double>(segments));
+
+    uint64_t cycles = 0;
+    if (counter >= 0 && read(counter, &cycles, sizeof(cycles)) == sizeof(cycles)) {
+        printf(", %.0f cycles/segment",
+               static_cast<double>(cycles) / static_cast<double>(segments));
+    }
+    printf("\n");
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "internal/sent_queue.hpp"
+
+// Compares the retransmission queue against the hash map it replaced, with many segments in
+// flight. Each round fills the queue, runs retransmission passes over it, looks segments up by
+// sequence number, then trims it with cumulative ACKs a window at a time.
+//
+//   usage: rudp_bench_sent_queue [in_flight] [rounds]
+//
+// The map is trimmed by erasing keys in sequence order, as it has no order of its own to follow.
+
+namespace {
+using rudp::u32;
+using rudp::internal::packet_header;
+using rudp::internal::sent_packet;
+
+using clock = std::chrono::steady_clock;
+
+constexpr u32 segment_bytes = rudp::internal::constants::MAX_DATA_BYTES;
+constexpr size_t passes = 10;
+constexpr size_t ack_every = 64;
+
+struct timings {
+    double fill;
+    double scan;
+    double find;
+    double trim;
+};
+
+sent_packet make(u32 seqnum) {
+    return {.header = packet_header{.seqnum = seqnum, .length = segment_bytes},
+            .position = seqnum,
+            .sent_at = clock::now(),
+            .retransmits = 0,
+            .policy = {}};
+}
+
+double since(clock::time_point start, size_t ops) {
+    return std::chrono::duration<double, std::nano>(clock::now() - start).count() /
+           static_cast<double>(ops);
+}
+
+void run_queue(size_t in_flight, const std::vector<u32> &lookups, timings &total) {
+    rudp::internal::sent_queue sent;
+
+    auto start = clock::now();
+    for (size_t i = 0; i < in_flight; i++) {
+        sent.push(make(static_cast<u32>(i) * segment_bytes));
+    }
+    total.fill += since(start, in_flight);
+
+    start = clock::now();
+    size_t due = 0;
+    for (size_t pass = 0; pass < passes; pass++) {
+        sent.for_each([&due, now = clock::now()](sent_packet &entry) {
+            due += static_cast<size_t>(now - entry.sent_at > std::chrono::seconds(5));
+            entry.retransmits++;
+        });
+    }
+    total.scan += since(start, passes * in_flight);
+
+    start = clock::now();
+    size_t found = 0;
+    for (u32 seqnum : lookups) {
+        found += static_cast<size_t>(sent.find(seqnum) != nullptr);
+    }
+    total.find += since(start, lookups.size());
+
+    start = clock::now();
+    for (size_t acked = 0; acked < in_flight; acked += ack_every) {
+        sent.acknowledge(static_cast<u32>(acked + ack_every) * segment_bytes,
+                         [](const sent_packet &) {});
+    }
+    total.trim += since(start, in_flight);
+
+    if (!sent.empty() || found != lookups.size() || due != 0) {
+        fprintf(stderr, "sent_queue: unexpected state\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void run_map(size_t in_flight, const std::vector<u32> &lookups, timings &total) {
+    std::unordered_map<u32, sent_packet> sent;
+
+    auto start = clock::now();
+    for (size_t i = 0; i < in_flight; i++) {
+        const u32 seqnum = static_cast<u32>(i) * segment_bytes;
+        sent[seqnum] = make(seqnum);
+    }
+    total.fill += since(start, in_flight);
+
+    start = clock::now();
+    size_t due = 0;
+    for (size_t pass = 0; pass < passes; pass++) {
+        const auto now = clock::now();
+        for (auto &[_, entry] : sent) {
+            due += static_cast<size_t>(now - entry.sent_at > std::chrono::seconds(5));
+            entry.retransmits++;
+        }
+    }
+    total.scan += since(start, passes * in_flight);
+
+    start = clock::now();
+    size_t found = 0;
+    for (u32 seqnum : lookups) {
+        found += static_cast<size_t>(sent.contains(seqnum));
+    }
+    total.find += since(start, lookups.size());
+
+    start = clock::now();
+    u32 lowest = 0;
+    for (size_t acked = 0; acked < in_flight; acked += ack_every) {
+        const u32 acknum = static_cast<u32>(acked + ack_every) * segment_bytes;
+        while (!sent.empty() && lowest < acknum) {
+            sent.erase(lowest);
+            lowest += segment_bytes;
+        }
+    }
+    total.trim += since(start, in_flight);
+
+    if (!sent.empty() || found != lookups.size() || due != 0) {
+        fprintf(stderr, "unordered_map: unexpected state\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void report(const char *name, const timings &total, size_t rounds) {
+    const auto mean = [rounds](double ns) { return ns / static_cast<double>(rounds); };
+    printf("%-14s fill %6.1f  scan %6.1f  find %6.1f  trim %6.1f  ns/segment\n", name,
+           mean(total.fill), mean(total.scan), mean(total.find), mean(total.trim));
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const size_t in_flight = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 100000;
+    const size_t rounds = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 20;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> segment(0, in_flight - 1);
+
+    std::vector<u32> lookups(in_flight);
+    for (u32 &seqnum : lookups) {
+        seqnum = static_cast<u32>(segment(gen)) * segment_bytes;
+    }
+
+    timings queue{};
+    timings map{};
+    for (size_t round = 0; round < rounds; round++) {
+        run_queue(in_flight, lookups, queue);
+        run_map(in_flight, lookups, map);
+    }
+
+    printf("%zu segments in flight, %zu rounds\n", in_flight, rounds);
+    report("sent_queue", queue, rounds);
+    report("unordered_map", map, rounds);
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include <arpa/inet.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <rudp.hpp>
+#include <vector>
+
+// Compares the same-host shared memory fast path against plain UDP over loopback, with the client
+// and server in separate processes as they would be in practice.
+//
+//   usage: rudp_bench_shm [megabytes] [round_trips]
+//
+// Latency is the mean of many 64 byte ping-pongs, throughput is a bulk transfer which the server
+// acknowledges with a single byte once it has everything.
+
+namespace {
+constexpr size_t ping_bytes = 64;
+
+[[noreturn]] void die(const char *what) {
+    perror(what);
+    exit(EXIT_FAILURE);
+}
+
+void send_all(int fd, const char *buf, size_t len) {
+    size_t sent = 0;
+    while (sent < len) {
+        ssize_t bytes = rudp::send(fd, buf + sent, len - sent, 0);
+        if (bytes <= 0) {
+            die("rudp::send");
+        }
+        sent += static_cast<size_t>(bytes);
+    }
+}
+
+void recv_all(int fd, char *buf, size_t len) {
+    size_t received = 0;
+    while (received < len) {
+        ssize_t bytes = rudp::recv(fd, buf + received, len - received, 0);
+        if (bytes <= 0) {
+            die("rudp::recv");
+        }
+        received += static_cast<size_t>(bytes);
+    }
+}
+
+int open_socket(int shm) {
+    int fd = rudp::socket();
+    if (fd < 0) {
+        die("rudp::socket");
+    }
+
+    if (rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_SHM, &shm, sizeof(shm)) < 0) {
+        die("rudp::setsockopt");
+    }
+
+    return fd;
+}
+
+[[noreturn]] void serve(sockaddr_in addr, int shm, int ready, size_t total, size_t round_trips) {
+    int serverfd = open_socket(shm);
+
+    if (rudp::bind(serverfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::bind");
+    }
+
+    if (rudp::listen(serverfd, 1) < 0) {
+        die("rudp::listen");
+    }
+
+    char byte = 0;
+    if (write(ready, &byte, sizeof(byte)) != sizeof(byte)) {
+        die("write");
+    }
+
+    int fd = rudp::accept(serverfd, nullptr, nullptr);
+    if (fd < 0) {
+        die("rudp::accept");
+    }
+
+    char ping[ping_bytes];
+    for (size_t i = 0; i < round_trips; i++) {
+        recv_all(fd, ping, sizeof(ping));
+        send_all(fd, ping, sizeof(ping));
+    }
+
+    std::vector<char> buf(64 * 1024);
+    size_t received = 0;
+    while (received < total) {
+        ssize_t bytes = rudp::recv(fd, buf.data(), buf.size(), 0);
+        if (bytes <= 0) {
+            die("rudp::recv");
+        }
+        received += static_cast<size_t>(bytes);
+    }
+
+    send_all(fd, &byte, sizeof(byte));
+
+    // NOTE: There is no graceful close yet, so we linger long enough for the final byte to land.
+    sleep(1);
+    _exit(EXIT_SUCCESS);
+}
+
+sockaddr_in address(u_int16_t port) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return addr;
+}
+
+// NOTE: fork() only copies the calling thread, so every server must be forked before the parent
+// makes its first rudp call and starts an event loop of its own.
+pid_t spawn(u_int16_t port, int shm, size_t total, size_t round_trips, int *ready_fd) {
+    int ready[2];
+    if (pipe(ready) < 0) {
+        die("pipe");
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        die("fork");
+    }
+
+    if (pid == 0) {
+        close(ready[0]);
+        serve(address(port), shm, ready[1], total, round_trips);
+    }
+
+    close(ready[1]);
+    *ready_fd = ready[0];
+    return pid;
+}
+
+void run(const char *name, u_int16_t port, int shm, int ready, size_t megabytes,
+         size_t round_trips) {
+    const size_t total = megabytes * 1024 * 1024;
+    struct sockaddr_in addr = address(port);
+
+    char byte{};
+    if (read(ready, &byte, sizeof(byte)) != sizeof(byte)) {
+        die("read");
+    }
+    close(ready);
+
+    int fd = open_socket(shm);
+    if (rudp::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::connect");
+    }
+
+    int active = 0;
+    socklen_t len = sizeof(active);
+    if (rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_SHM_ACTIVE, &active, &len) < 0) {
+        die("rudp::getsockopt");
+    }
+
+    char ping[ping_bytes] = {};
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < round_trips; i++) {
+        send_all(fd, ping, sizeof(ping));
+        recv_all(fd, ping, sizeof(ping));
+    }
+    auto latency =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+    std::vector<char> buf(64 * 1024, 'x');
+    start = std::chrono::steady_clock::now();
+
+    size_t sent = 0;
+    while (sent < total) {
+        size_t chunk = std::min(buf.size(), total - sent);
+        send_all(fd, buf.data(), chunk);
+        sent += chunk;
+    }
+
+    recv_all(fd, &byte, sizeof(byte));
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    printf("%-4s (shm %s): %.1f us per %zu byte round trip, %zu MB in %.3f s (%.1f MB/s)\n", name,
+           active ? "active" : "inactive", latency.count() / static_cast<double>(round_trips),
+           ping_bytes, megabytes, elapsed.count(),
+           static_cast<double>(megabytes) / elapsed.count());
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const size_t megabytes = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 64;
+    const size_t round_trips = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 10000;
+
+    const size_t total = megabytes * 1024 * 1024;
+
+    int udp_ready{};
+    int shm_ready{};
+    pid_t udp_server = spawn(9998, 0, total, round_trips, &udp_ready);
+    pid_t shm_server = spawn(9999, 1, total, round_trips, &shm_ready);
+
+    run("udp", 9998, 0, udp_ready, megabytes, round_trips);
+    run("shm", 9999, 1, shm_ready, megabytes, round_trips);
+
+    waitpid(udp_server, nullptr, 0);
+    waitpid(shm_server, nullptr, 0);
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <arpa/inet.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <rudp.hpp>
+#include <thread>
+#include <vector>
+
+// Measures bulk transfer throughput between two sockets in the same process.
+//
+//   usage: rudp_bench_throughput [udp|loopback] [megabytes] [copy|zc]
+//
+// With the loopback transport no datagram ever reaches the kernel, so the result is the cost of
+// the protocol stack alone; comparing against udp shows what the kernel adds on top. zc sends with
+// rudp::send_zc() from a small pool of buffers, each reused once its completion is reported.
+
+namespace {
+[[noreturn]] void die(const char *what) {
+    perror(what);
+    exit(EXIT_FAILURE);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    int transport = rudp::RUDP_TRANSPORT_UDP;
+    if (argc > 1 && strcmp(argv[1], "loopback") == 0) {
+        transport = rudp::RUDP_TRANSPORT_LOOPBACK;
+    }
+
+    const size_t megabytes = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 64;
+    const size_t total = megabytes * 1024 * 1024;
+    const bool zerocopy = (argc > 3) && strcmp(argv[3], "zc") == 0;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(9999);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int serverfd = rudp::socket();
+    int clientfd = rudp::socket();
+
+    if (rudp::setsockopt(serverfd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &transport,
+                         sizeof(transport)) < 0 ||
+        rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &transport,
+                         sizeof(transport)) < 0) {
+        die("rudp::setsockopt");
+    }
+
+    if (rudp::bind(serverfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::bind");
+    }
+
+    if (rudp::listen(serverfd, 1) < 0) {
+        die("rudp::listen");
+    }
+
+    if (rudp::connect(clientfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        die("rudp::connect");
+    }
+
+    int acceptedfd = rudp::accept(serverfd, nullptr, nullptr);
+    if (acceptedfd < 0) {
+        die("rudp::accept");
+    }
+
+    std::thread receiver([&]() {
+        std::vector<char> buf(64 * 1024);
+        size_t received = 0;
+
+        while (received < total) {
+            ssize_t bytes = rudp::recv(acceptedfd, buf.data(), buf.size(), 0);
+            if (bytes <= 0) {
+                die("rudp::recv");
+            }
+            received += static_cast<size_t>(bytes);
+        }
+    });
+
+    constexpr size_t chunk = 64 * 1024;
+    constexpr size_t pool = 8;
+
+    std::vector<char> buf(pool * chunk, 'x');
+    auto start = std::chrono::steady_clock::now();
+
+    size_t sent = 0;
+    if (zerocopy) {
+        // NOTE: Send i uses buffer i % pool, so it must wait for send i - pool to complete.
+        uint32_t issued = 0;
+        uint32_t completed = 0;
+
+        while (sent < total) {
+            while (issued - completed == pool) {
+                uint32_t first{};
+                uint32_t last{};
+                if (rudp::send_zc_completions(clientfd, &first, &last, 0) < 0) {
+                    die("rudp::send_zc_completions");
+                }
+                completed = last + 1;
+            }
+
+            const size_t len = std::min(chunk, total - sent);
+            if (rudp::send_zc(clientfd, buf.data() + (issued % pool) * chunk, len, 0) <= 0) {
+                die("rudp::send_zc");
+            }
+
+            issued++;
+            sent += len;
+        }
+    } else {
+        while (sent < total) {
+            ssize_t bytes = rudp::send(clientfd, buf.data(), std::min(chunk, total - sent), 0);
+            if (bytes <= 0) {
+                die("rudp::send");
+            }
+            sent += static_cast<size_t>(bytes);
+        }
+    }
+
+    receiver.join();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    printf("%s (%s): %zu MB in %.3f s (%.1f MB/s)\n",
+           transport == rudp::RUDP_TRANSPORT_LOOPBACK ? "loopback" : "udp",
+           zerocopy ? "zc" : "copy", megabytes, elapsed.count(),
+           static_cast<double>(megabytes) / elapsed.count());
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <rudp.hpp>
+#include <rudp/async.hpp>
+
+// Opens many concurrent connections to rudp_async_server from a single thread, echoing one message
+// over each and checking that it comes back intact.
+//
+//   usage: rudp_async_client [connections] [port]
+
+namespace {
+constexpr char message[] = "The TCP state machine implemented on UDP.";
+
+size_t g_echoed = 0;
+size_t g_failed = 0;
+
+rudp::async::task<bool> exchange(rudp::async::loop &loop, int fd) {
+    ssize_t sent = co_await loop.send(fd, message, sizeof(message));
+    if (sent != static_cast<ssize_t>(sizeof(message))) {
+        co_return false;
+    }
+
+    char buf[sizeof(message)];
+    size_t received = 0;
+    while (received < sizeof(buf)) {
+        ssize_t bytes = co_await loop.recv(fd, buf + received, sizeof(buf) - received);
+        if (bytes <= 0) {
+            co_return false;
+        }
+        received += static_cast<size_t>(bytes);
+    }
+
+    co_return memcmp(buf, message, sizeof(message)) == 0;
+}
+
+rudp::async::task<> client(rudp::async::loop &loop, sockaddr_in addr) {
+    int fd = rudp::socket();
+    if (fd < 0 ||
+        co_await loop.connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        perror("rudp::connect");
+        g_failed++;
+        co_return;
+    }
+
+    if (co_await exchange(loop, fd)) {
+        g_echoed++;
+    } else {
+        g_failed++;
+    }
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const size_t connections = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000;
+    const auto port = static_cast<uint16_t>((argc > 2) ? strtoul(argv[2], nullptr, 10) : 8888);
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    rudp::async::loop loop;
+    if (!loop.valid()) {
+        perror("rudp::async::loop");
+        exit(EXIT_FAILURE);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < connections; i++) {
+        loop.spawn(client(loop, addr));
+    }
+
+    if (loop.run() < 0) {
+        perror("rudp::async::loop::run");
+        exit(EXIT_FAILURE);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    printf("%zu echoed, %zu failed, in %.3f s\n", g_echoed, g_failed, elapsed.count());
+    return g_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,99 @@
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <rudp.hpp>
+#include <rudp/async.hpp>
+
+// An echo server which serves every connection from the calling thread. Each connection is a
+// coroutine parked on the loop whenever it would block, so 10k idle connections cost 10k coroutine
+// frames rather than 10k threads.
+//
+//   usage: rudp_async_server [port]
+//
+// Pair it with rudp_async_client, which opens its connections from a single thread in the same way.
+
+namespace {
+rudp::async::task<> echo(rudp::async::loop &loop, int fd) {
+    char buf[4096];
+
+    for (;;) {
+        ssize_t received = co_await loop.recv(fd, buf, sizeof(buf));
+        if (received <= 0) {
+            co_return;
+        }
+
+        ssize_t sent = 0;
+        while (sent < received) {
+            ssize_t bytes =
+                co_await loop.send(fd, buf + sent, static_cast<size_t>(received - sent));
+            if (bytes <= 0) {
+                co_return;
+            }
+            sent += bytes;
+        }
+    }
+}
+
+rudp::async::task<> serve(rudp::async::loop &loop, int serverfd) {
+    size_t connections = 0;
+
+    for (;;) {
+        int fd = static_cast<int>(co_await loop.accept(serverfd));
+        if (fd < 0) {
+            perror("rudp::accept");
+            continue;
+        }
+
+        if (++connections % 1000 == 0) {
+            printf("%zu connections\n", connections);
+            fflush(stdout);
+        }
+
+        loop.spawn(echo(loop, fd));
+    }
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const auto port = static_cast<uint16_t>((argc > 1) ? strtoul(argv[1], nullptr, 10) : 8888);
+
+    int serverfd = rudp::socket();
+    if (serverfd < 0) {
+        perror("rudp::socket");
+        exit(EXIT_FAILURE);
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(port);
+
+    if (rudp::bind(serverfd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        perror("rudp::bind");
+        exit(EXIT_FAILURE);
+    }
+
+    if (rudp::listen(serverfd, 1024) < 0) {
+        perror("rudp::listen");
+        exit(EXIT_FAILURE);
+    }
+
+    rudp::async::loop loop;
+    if (!loop.valid()) {
+        perror("rudp::async::loop");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Listening on %u...\n", port);
+    fflush(stdout);
+    loop.spawn(serve(loop, serverfd));
+
+    if (loop.run() < 0) {
+        perror("rudp::async::loop::run");
+        exit(EXIT_FAILURE);
+    }
+}
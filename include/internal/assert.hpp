@@ -1,5 +1,7 @@
 #pragma once
 
+#include <fcntl.h>
+
 #include <cerrno>
 #include <cstddef>
 
@@ -38,6 +40,10 @@
 
 namespace rudp::internal {
 
+inline bool is_valid_fd(linuxfd_t fd) {
+    return ::fcntl(fd, F_GETFD) != -1;
+}
+
 inline bool is_valid_sockfd(linuxfd_t fd) {
     int opt;
     socklen_t opt_len = sizeof(opt);
@@ -46,7 +52,7 @@ inline bool is_valid_sockfd(linuxfd_t fd) {
 
 inline bool is_valid_epollfd(linuxfd_t fd) {
     // NOTE: A bad epollfd returns EINVAL, whereas a bad fd (-1) returns EBADF.
-    return epoll_ctl(fd, EPOLL_CTL_DEL, -1, NULL) == -1 && errno == EBADF;
+    return ::epoll_ctl(fd, EPOLL_CTL_DEL, -1, NULL) == -1 && errno == EBADF;
 }
 
 }  // namespace rudp::internal
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+// NOTE: A bounded lock-free MPMC queue (Vyukov). Each slot carries a sequence number which tells
+// producers and consumers whose turn it is, so a push or pop is a single CAS on the shared index
+// followed by an uncontended write to the slot.
+template <typename T, size_t Capacity>
+class bounded_queue {
+    RUDP_STATIC_ASSERT(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                       "A bounded_queue's capacity must be a power of two.");
+
+public:
+    bounded_queue() : m_slots(std::make_unique<slot[]>(Capacity)) {
+        for (size_t i = 0; i < Capacity; i++) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bounded_queue(const bounded_queue &) = delete;
+    bounded_queue &operator=(const bounded_queue &) = delete;
+
+    // NOTE: The writer fills out the slot in place to avoid copying T twice.
+    template <typename Writer>
+    [[nodiscard]] bool push(Writer &&writer) noexcept {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+
+        while (true) {
+            slot &s = m_slots[pos & (Capacity - 1)];
+            size_t sequence = s.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    writer(s.value);
+                    s.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename Reader>
+    [[nodiscard]] bool pop(Reader &&reader) noexcept {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+
+        while (true) {
+            slot &s = m_slots[pos & (Capacity - 1)];
+            size_t sequence = s.sequence.load(std::memory_order_acquire);
+            auto diff =
+                static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    reader(s.value);
+                    s.sequence.store(pos + Capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    struct slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<slot[]> m_slots;
+
+    alignas(constants::CACHE_LINE_BYTES) std::atomic<size_t> m_head{0};
+    alignas(constants::CACHE_LINE_BYTES) std::atomic<size_t> m_tail{0};
+};
+
+}  // namespace rudp::internal
@@ -33,13 +33,27 @@ using rudpfd_t = s32;
 
 namespace internal::constants {
     inline constexpr s32 UNINITIALISED_FD = -1;
+    inline constexpr size_t CACHE_LINE_BYTES = 64;
 
     inline constexpr u8 MAX_RETRANSMITS = 20;
     inline constexpr u16 MAX_DATA_BYTES = 1024;
+    // NOTE: The retransmission timeout until the first round trip is measured, and its bounds
+    // once it adapts to them.
     inline constexpr std::chrono::milliseconds RETRANSMIT_TIME = std::chrono::milliseconds(5000);
+    inline constexpr std::chrono::milliseconds MIN_RETRANSMIT_TIME = std::chrono::milliseconds(200);
+    inline constexpr std::chrono::milliseconds MAX_RETRANSMIT_TIME = std::chrono::seconds(60);
 
     inline constexpr u32 MAX_SEND_BUFFER_BYTES = (2 << 18);  // 256KB
 
+    // NOTE: The widest window; without it a full send buffer is sent as one burst which overruns
+    // the peer's kernel receive buffer and every loss then costs a RETRANSMIT_TIME. ECN marks
+    // narrow it, down to the narrowest.
+    inline constexpr size_t MAX_INFLIGHT_PACKETS = 64;
+    inline constexpr size_t MIN_INFLIGHT_PACKETS = 2;
+
+    // NOTE: How many streams the peer may open, as each costs us a pair of buffers.
+    inline constexpr size_t MAX_PEER_STREAMS = 256;
+
     inline constexpr sockaddr_in UNINITIALISED_PEER = {
         .sin_family = AF_UNSPEC,
         .sin_port = 0,
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+// NOTE: A byte-oriented LZ77 block codec in the LZ4 block format: runs of literals, each followed
+// by a match given as a two byte offset back into the output and a length. No entropy stage, so
+// both directions run at memory speed. Each block stands alone, as a segment may be lost; blocks
+// are at most a segment's payload, which the hash table is sized for.
+inline constexpr size_t MAX_LZ_BLOCK = constants::MAX_DATA_BYTES;
+
+// NOTE: Returns the compressed size, or zero if it would not fit in output; an output smaller than
+// the input therefore doubles as the least saving worth having.
+[[nodiscard]] size_t lz_compress(std::span<const u8> input, std::span<u8> output) noexcept;
+
+// NOTE: Returns the decompressed size, or std::nullopt if input is malformed or does not fit in
+// output. Never reads or writes out of bounds, whatever the input.
+[[nodiscard]] std::optional<size_t> lz_decompress(std::span<const u8> input,
+                                                  std::span<u8> output) noexcept;
+
+}  // namespace rudp::internal
@@ -3,54 +3,107 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <deque>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <unordered_map>
 
 #include "internal/common.hpp"
+#include "internal/epoll.hpp"
+#include "internal/fec.hpp"
+#include "internal/options.hpp"
 #include "internal/packet.hpp"
+#include "internal/recv_queue.hpp"
+#include "internal/reorder_queue.hpp"
+#include "internal/send_queue.hpp"
+#include "internal/sent_queue.hpp"
 #include "internal/state.hpp"
+#include "internal/transport.hpp"
 
 namespace rudp::internal {
 
-struct sent_packet {
-    class packet packet;
-    std::chrono::steady_clock::time_point sent_at;
-    u8 retransmits;
-};
+// NOTE: The same type as rudp::data_callback, which we do not include here; the public header
+// would hijack unqualified calls such as close() throughout the internals.
+using data_callback = std::function<void(std::span<const std::byte>)>;
+
+// NOTE: An independently ordered flow of bytes within a connection, with its own buffers. Stream
+// 0 always exists and is the one send() and recv() use.
+struct stream {
+    send_queue send_buffer;
+    recv_queue recv_buffer;
 
-struct received_packet {
-    class packet packet;
-    sockaddr_in peer;
+    // NOTE: The offsets of the next byte to send and to deliver. Only the event thread touches
+    // these.
+    u32 sent{0};
+    u32 delivered{0};
 };
 
 class connection {
 public:
-    // TODO: Implement an actual circular buffer.  We could try that paging technique?
-    // TODO: Encapsulate - e.g. send() only writes to the end.
-    std::deque<u8> send_buffer;
-    std::deque<u8> recv_buffer;
+    static constexpr u16 DEFAULT_STREAM = 0;
 
-    connection(linuxfd_t fd) : m_fd(fd) {}
+    // NOTE: As with MSG_ZEROCOPY, send_zc() hands out consecutive ids and completions are reported
+    // as ranges of them; zc_next_id is the next to hand out and zc_reported the first not yet
+    // reported. Guarded by m_mtx, as is zc_completed().
+    u32 zc_next_id{0};
+    u32 zc_reported{0};
+
+    // NOTE: Payloads loaned out by recv_zc(), keyed by the address handed to the user, until
+    // they are released.
+    std::unordered_map<const void *, recv_queue::chunk> loans;
+
+    connection(std::shared_ptr<class transport> transport, const options &opts,
+               std::shared_ptr<class readiness> readiness)
+        : m_transport(std::move(transport)), m_fd(m_transport->fd()), m_opts(opts),
+          m_readiness(std::move(readiness)) {
+        m_streams.try_emplace(DEFAULT_STREAM);
+    }
 
     void handle_events() noexcept;
     void retransmit() noexcept;
     void process_sends() noexcept;
 
-    [[nodiscard]] bool passive_open(const sockaddr_in &peer, const packet &packet) noexcept;
+    [[nodiscard]] bool passive_open(const sockaddr_in &peer, const packet &packet,
+                                    std::chrono::steady_clock::time_point arrived) noexcept;
     [[nodiscard]] bool active_open(const sockaddr_in &listening_peer) noexcept;
 
+    [[nodiscard]] bool established() noexcept;
+    [[nodiscard]] u32 events() noexcept;
+
     void wait_for_established() noexcept;
-    void wait_for_send_space() noexcept;
-    void wait_for_recv_data() noexcept;
+    void wait_for_send_space(u16 id, size_t at_least = 1) noexcept;
+    void wait_for_recv_data(u16 id, size_t at_least = 1) noexcept;
+    void wait_for_zc_completion() noexcept;
+    void wait_for_stream() noexcept;
+
+    // NOTE: Guarded by m_mtx. Streams are never removed, so one found under the lock remains
+    // valid after it is released; only the lookup itself must hold it.
+    [[nodiscard]] class stream *find_stream(u16 id) noexcept;
+    [[nodiscard]] class stream &default_stream() noexcept;
+
+    // NOTE: Numbers a new stream of our own, or the next stream the peer has opened. Both take
+    // m_mtx, and return std::nullopt when there is none to be had.
+    [[nodiscard]] std::optional<u16> open_stream() noexcept;
+    [[nodiscard]] std::optional<u16> accept_stream() noexcept;
 
     void on_established(std::function<void()> callback) noexcept;
+    void on_data(std::shared_ptr<const data_callback> callback) noexcept;
     [[nodiscard]] const sockaddr_in &peer() const noexcept;
+    [[nodiscard]] bool shm_active() const noexcept;
+    [[nodiscard]] std::chrono::microseconds queueing_delay() const noexcept;
+    [[nodiscard]] size_t congestion_window() const noexcept;
+
+    [[nodiscard]] u32 zc_completed() const noexcept {
+        return m_zc_completed;
+    }
 
     template <typename Func>
     auto synchronise(Func &&func) {
@@ -59,18 +112,78 @@ public:
     }
 
 private:
-    const linuxfd_t m_fd;
+    std::shared_ptr<class transport> m_transport;
+    std::atomic<linuxfd_t> m_fd;
+    const options m_opts;
+
+    // NOTE: Notified, outside of m_mtx, whenever events() may have changed.
+    const std::shared_ptr<class readiness> m_readiness;
+
+    // NOTE: The passive side listens for a shared memory offer between its SYNACK and the final
+    // handshake ACK. The active side switches once that ACK is out, and connect() must not return
+    // before then, so m_pending_transport is guarded by m_mtx. The offer must carry back
+    // m_shm_nonce, which the passive side draws and the active side learns from the SYNACK.
+    linuxfd_t m_shm_listenfd{constants::UNINITIALISED_FD};
+    std::optional<u64> m_shm_nonce;
+    bool m_shm_offered{false};
+    std::shared_ptr<class transport> m_pending_transport;
+    std::atomic<bool> m_shm_active{false};
 
     state m_state{};
     u32 m_seqnum{};
     u32 m_acknum{};
 
+    // NOTE: The full layout until the peer shows that it speaks the compact one, which only the
+    // SYN is sent before.
+    layout m_layout{layout::full};
+
+    // NOTE: The features which both we and the peer offered during the handshake.
+    u32 m_capabilities{0};
+
+    // NOTE: With timestamps, every ACK echoes when the packet it answers was sent, which gives a
+    // round trip sample even for a retransmitted packet and shows when a retransmission was
+    // spurious. Without them, handle_ack() times ACKs by Karn's algorithm instead. The timeout
+    // follows RFC 6298, doubling on each pass which retransmits until the next sample. Only the
+    // event thread touches these.
+    u32 m_ts_recent{0};
+    std::optional<std::chrono::microseconds> m_srtt;
+    std::chrono::microseconds m_rttvar{0};
+    std::chrono::microseconds m_rto{constants::RETRANSMIT_TIME};
+
+    // NOTE: How long received datagrams wait for the event thread, in microseconds and smoothed as
+    // the round trip is. Written by the event thread alone, and read from the user thread.
+    std::atomic<u64> m_queueing_delay{0};
+
+    // NOTE: With ECN, our data is sent ECN-capable and the peer echoes how much of it arrived
+    // marked CE. Each rise in that count halves the window, at most once per window's worth of
+    // data as in RFC 5681's fast recovery, and every window acknowledged widens it by one. Only
+    // the event thread touches these, bar the window, which the user thread reads.
+    u32 m_ce_received{0};
+    u32 m_ce_echoed{0};
+    u32 m_recover{0};
+    size_t m_cwnd_acked{0};
+    std::atomic<size_t> m_cwnd{constants::MAX_INFLIGHT_PACKETS};
+
+    // NOTE: When asked to and the peer understands it, each payload is compressed as it is sent. A
+    // payload which does not shrink goes as is, and so do the next m_compress_skip, a count which
+    // doubles with each such miss, so that an incompressible stream is soon hardly looked at. Only
+    // the event thread touches these.
+    u32 m_compress_skip{0};
+    u32 m_compress_backoff{0};
+
     std::function<void()> m_listener_established{};
 
+    // NOTE: Installed from the user thread and called on the event thread, which takes its own
+    // reference once per batch so that the callback may replace itself. Guarded by m_mtx.
+    std::shared_ptr<const data_callback> m_on_data;
+
     // NOTE: connection::listener will spawn new connections on an ephemeral kernel port, meaning
     // that we do not know the port of our peer until we first receive a valid packet from them.
     sockaddr_in m_peer{constants::UNINITIALISED_PEER};
 
+    // NOTE: Our SYN goes to the listener rather than m_peer, so a retransmitted SYN must too.
+    sockaddr_in m_listening_peer{constants::UNINITIALISED_PEER};
+
     // NOTE: We assume a single user thread, meaning that the user thread can only ever be waiting
     // on one condition at any given time, so we need only one condition variable.
     // TODO: The above does not imply only one mutex; suppose a user is placing data on the send
@@ -78,19 +191,96 @@ private:
     std::mutex m_mtx;
     std::condition_variable m_cv;
 
-    std::unordered_map<u32, sent_packet> m_sent;
-    std::map<u32, received_packet> m_received;
+    sent_queue m_sent;
+    reorder_queue m_reordered;
+
+    // NOTE: We send repairs when asked to and the peer understands them, and always rebuild from
+    // the peer's. A group is repaired once full, or once its first segment has waited
+    // m_fec_opened plus half a timeout. Only the event thread touches these.
+    fec_encoder m_fec_encoder;
+    fec_decoder m_fec_decoder;
+    std::chrono::steady_clock::time_point m_fec_opened;
+
+    // NOTE: Each side numbers the streams it opens apart from the other's, the active side odd and
+    // the passive side even, so that neither has to ask. A stream of the peer's is created by its
+    // first packet and queued on m_unaccepted for accept_stream(), up to MAX_PEER_STREAMS of them.
+    // All guarded by m_mtx.
+    std::unordered_map<u16, stream> m_streams;
+    u32 m_next_stream{};
+    size_t m_peer_streams{0};
+    std::deque<u16> m_unaccepted;
 
-    void buffer_pending() noexcept;
+    // NOTE: Zero-copy sends whose last byte has been sent, in order, each with the acknowledgement
+    // number which completes it. Only the event thread touches the queue, but it shares m_mtx with
+    // m_zc_completed, the id after the last completion.
+    struct zc_unacked {
+        u32 id;
+        u32 acked_by;
+    };
+    std::deque<zc_unacked> m_zc_unacked;
+    u32 m_zc_completed{0};
 
-    void handle_ack(const packet &packet) noexcept;
-    void handle_synack(const packet &packet, const sockaddr_in &peer) noexcept;
+    void receive_pending(const data_callback *on_data, bool *received_data,
+                         bool *buffered_data) noexcept;
+    // NOTE: Places a packet by its sequence number, received or rebuilt alike.
+    void handle_sequenced(class packet &packet, const sockaddr_in &peer,
+                          const data_callback *on_data, bool *received_data,
+                          bool *buffered_data) noexcept;
+    [[nodiscard]] bool is_established() const noexcept;
+    [[nodiscard]] bool has_recv_data(const stream &stream, size_t at_least) const noexcept;
+
+    // NOTE: take() yields the payload, and is only called once it is known to be wanted. Anything
+    // held past a gap which then continues the stream follows it, under the same lock.
+    template <typename Take>
+    [[nodiscard]] bool deliver(const packet_header &header, bool has_payload, Take &&take,
+                               const data_callback *on_data) noexcept;
+    // NOTE: As above with m_mtx held, which is released around on_data, and alone.
+    template <typename Take>
+    [[nodiscard]] bool deliver(std::unique_lock<std::mutex> &lock, const packet_header &header,
+                               bool has_payload, Take &&take,
+                               const data_callback *on_data) noexcept;
+    [[nodiscard]] bool deliver_waiting(std::unique_lock<std::mutex> &lock, u16 id,
+                                       const data_callback *on_data) noexcept;
+    // NOTE: Header prediction: handles the next packet in order on the spot when it is plain data
+    // or a bare ACK, returning false to leave anything else to handle_in_order().
+    [[nodiscard]] bool handle_predicted(packet &packet, const data_callback *on_data,
+                                        bool *received_data, bool *buffered_data) noexcept;
+    template <typename Take>
+    void handle_in_order(const packet_header &header, const sockaddr_in &peer, bool has_payload,
+                         Take &&take, const data_callback *on_data, bool *received_data,
+                         bool *buffered_data) noexcept;
+    [[nodiscard]] bool send_segment(u16 id, stream &stream) noexcept;
+    void abandon(sent_packet &sent) noexcept;
+    [[nodiscard]] bool sends_repairs() const noexcept;
+    void send_repair() noexcept;
+    void resend(const sent_packet &sent) noexcept;
+
+    void handle_ack(const packet_header &header) noexcept;
+    void handle_synack(const packet_header &header, const sockaddr_in &peer) noexcept;
+    [[nodiscard]] bool accept_shm_offer() noexcept;
+    void close_shm_listener() noexcept;
+    void switch_transport() noexcept;
 
     bool send_control_packet(u8 flags, std::optional<sockaddr_in> to = std::nullopt) noexcept;
-    [[nodiscard]] bool send_packet(const packet &packet,
+    [[nodiscard]] bool send_packet(packet &packet,
                                    std::optional<sockaddr_in> to = std::nullopt) noexcept;
 
-    u32 get_sequence_advance(const packet &packet) noexcept;
+    ssize_t transmit(packet &packet, const sockaddr_in *to) noexcept;
+    [[nodiscard]] bool compresses(const packet &packet) const noexcept;
+    // NOTE: Compresses packet's payload into block, which it then views, returning false to send
+    // the payload as is.
+    [[nodiscard]] bool compress(packet &packet, std::span<u8> block) noexcept;
+    // NOTE: Restores a compressed payload, returning false if it is malformed.
+    [[nodiscard]] bool decompress(packet &packet) noexcept;
+    void negotiate(const packet &packet) noexcept;
+    void read_shm_nonce(const packet &packet) noexcept;
+    void handle_timestamp(const packet &packet,
+                          std::chrono::steady_clock::time_point arrived) noexcept;
+    void sample_queueing_delay(std::chrono::steady_clock::time_point arrived) noexcept;
+    void handle_ecn_echo(const packet &packet) noexcept;
+    void sample_rtt(std::chrono::microseconds rtt) noexcept;
+
+    u32 get_sequence_advance(const packet_header &header) noexcept;
 
     void assert_external_state(const char *caller) const noexcept;
 };
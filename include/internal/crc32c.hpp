@@ -0,0 +1,28 @@
+#pragma once
+
+#include <span>
+
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+// NOTE: CRC32C (Castagnoli), as used by iSCSI and SCTP, which x86 computes in hardware with
+// SSE4.2; a table-driven fallback covers anything else. Chained by passing the previous result
+// as crc, starting from CRC32C_INITIAL, and finished with crc32c_finish().
+inline constexpr u32 CRC32C_INITIAL = 0xFFFFFFFF;
+
+[[nodiscard]] u32 crc32c(u32 crc, std::span<const u8> data) noexcept;
+
+// NOTE: As above, while also copying data to output, so that checking a payload costs no extra
+// pass over it.
+[[nodiscard]] u32 crc32c_copy(u32 crc, std::span<const u8> data, u8 *output) noexcept;
+
+// NOTE: The table-driven fallback alone, whatever the host supports, so that the hardware path can
+// be checked against it; peers without SSE4.2 must compute the same checksums.
+[[nodiscard]] u32 crc32c_software(u32 crc, std::span<const u8> data) noexcept;
+
+[[nodiscard]] constexpr u32 crc32c_finish(u32 crc) noexcept {
+    return ~crc;
+}
+
+}  // namespace rudp::internal
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <sys/epoll.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+class epoll_instance;
+
+// NOTE: Every socket owns one of these, shared with its listener or connection, through which the
+// event thread announces that the socket's readiness may have changed. It is an edge; the epoll
+// instances watching the socket work out the level for themselves.
+class readiness {
+public:
+    void notify() noexcept;
+
+    void attach(rudpfd_t fd, const std::shared_ptr<epoll_instance> &epoll) noexcept;
+    void detach(const epoll_instance *epoll) noexcept;
+
+private:
+    std::mutex m_mtx;
+    std::vector<std::pair<rudpfd_t, std::weak_ptr<epoll_instance>>> m_watchers;
+
+    // NOTE: Lets notify() skip the lock for the common case of a socket nobody is watching.
+    std::atomic<size_t> m_watching{0};
+};
+
+// NOTE: Both the interest list and the ready list live here rather than in the kernel. A socket
+// is queued on the ready list when notified, and epoll_wait() only ever visits queued sockets, so
+// its cost is proportional to the number of ready sockets rather than the number registered.
+class epoll_instance : public std::enable_shared_from_this<epoll_instance> {
+public:
+    epoll_instance() noexcept = default;
+    ~epoll_instance();
+
+    epoll_instance(const epoll_instance &) = delete;
+    epoll_instance &operator=(const epoll_instance &) = delete;
+    epoll_instance(epoll_instance &&) = delete;
+    epoll_instance &operator=(epoll_instance &&) = delete;
+
+    [[nodiscard]] int ctl(int op, rudpfd_t fd, const std::shared_ptr<class readiness> &readiness,
+                          const epoll_event *event) noexcept;
+    [[nodiscard]] int wait(epoll_event *events, int maxevents, int timeout) noexcept;
+    [[nodiscard]] linuxfd_t pollable_fd() noexcept;
+
+    void enqueue(rudpfd_t fd) noexcept;
+
+private:
+    struct interest {
+        epoll_event event;
+        bool queued;
+
+        // NOTE: Cleared once an EPOLLONESHOT socket has been reported, until EPOLL_CTL_MOD.
+        bool armed;
+    };
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+
+    std::unordered_map<rudpfd_t, interest> m_interests;
+    std::deque<rudpfd_t> m_ready;
+
+    // NOTE: Created on first request. It is written when the ready list goes from empty to
+    // non-empty and drained when wait() empties it, so it is readable exactly while m_ready is not
+    // empty and a busy instance costs one write per drain rather than one per notification.
+    linuxfd_t m_eventfd{constants::UNINITIALISED_FD};
+
+    void enqueue_locked(rudpfd_t fd, interest &entry) noexcept;
+};
+
+[[nodiscard]] std::shared_ptr<epoll_instance> find_epoll(rudpfd_t fd) noexcept;
+void insert_epoll(rudpfd_t fd, std::shared_ptr<epoll_instance> epoll) noexcept;
+
+}  // namespace rudp::internal
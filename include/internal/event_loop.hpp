@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <future>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 
@@ -9,11 +10,13 @@
 
 namespace rudp::internal {
 
-enum class handler_type : u32 { listener, connection };
+enum class handler_type : u32 { listener, connection, wakeup };
 
 class event_loop {
 public:
-    event_loop() noexcept : m_epollfd(constants::UNINITIALISED_FD), m_running(false) {}
+    event_loop() noexcept
+        : m_epollfd(constants::UNINITIALISED_FD), m_wakefd(constants::UNINITIALISED_FD),
+          m_running(false) {}
 
     event_loop(const event_loop &) = delete;
     event_loop &operator=(const event_loop &) = delete;
@@ -24,6 +27,7 @@ public:
         enum class error {
             none,
             epoll_creation,
+            wakeup_creation,
             thread_creation,
         };
 
@@ -36,6 +40,10 @@ public:
                                    std::function<void()> handler) noexcept;
     bool remove_handler(handler_type type, linuxfd_t fd) noexcept;
 
+    // NOTE: Interrupts epoll_wait() so that work queued by the user thread, e.g. a send(), is
+    // picked up immediately rather than on the next timeout.
+    void wake() noexcept;
+
     void loop() noexcept;
 
     void assert_initialised_state(const char *caller) const noexcept;
@@ -45,10 +53,16 @@ public:
 
 private:
     linuxfd_t m_epollfd;
+    linuxfd_t m_wakefd;
     bool m_running;
 
     std::thread m_thread;
+    std::thread::id m_thread_id;
     std::promise<void> m_thread_started;
+
+    // NOTE: Handlers are added from both threads, e.g. connect() and a listener's spawns, and the
+    // user thread asserts on them, so the map itself is guarded. Handlers run without the lock.
+    mutable std::mutex m_handlers_mtx;
     std::unordered_map<u64, std::function<void()>> m_handlers;
 
     [[nodiscard]] static u64 calculate_id(handler_type type, linuxfd_t fd) noexcept;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+
+#include "internal/common.hpp"
+#include "internal/packet.hpp"
+
+namespace rudp::internal {
+
+// NOTE: Forward error correction by XOR parity. The sender tags each new segment with a group and
+// its index within it, and closes every group with a repair packet holding the XOR of the group's
+// headers and payloads. A receiver missing a single segment of a group rebuilds it from the rest
+// and the repair, rather than waiting out a retransmission. A retransmission is never tagged, so
+// that no segment counts towards its group twice.
+inline constexpr size_t MAX_FEC_GROUP = 32;
+
+// NOTE: The XOR of every header field a repair restores, and of the payloads zero-padded to the
+// longest of them.
+struct fec_parity {
+    u8 flags;
+    u16 length;
+    u16 stream;
+    u32 seqnum;
+    u32 offset;
+    u16 covered;
+    std::array<u8, constants::MAX_DATA_BYTES> data;
+
+    void add(const packet_header &header, std::span<const u8> payload) noexcept;
+};
+
+class fec_encoder {
+public:
+    // NOTE: Tags the next segment, which is then added once sent.
+    void tag(packet &segment) const noexcept;
+    void add(const packet_header &header, std::span<const u8> payload) noexcept;
+
+    [[nodiscard]] size_t size() const noexcept {
+        return m_count;
+    }
+
+    // NOTE: Closes the group so far. The repair views the parity, so it must be sent before the
+    // next segment is added.
+    [[nodiscard]] packet repair(u32 seqnum, u32 acknum) noexcept;
+
+private:
+    u16 m_group{0};
+    u8 m_count{0};
+
+    // NOTE: Allocated by the first segment sent with FEC enabled.
+    std::unique_ptr<fec_parity> m_parity;
+};
+
+class fec_decoder {
+public:
+    // NOTE: Each returns the segment missing from a group, once the rest of the group and its
+    // repair have both arrived. A segment without a tag is ignored.
+    [[nodiscard]] std::optional<packet> add(const packet &segment) noexcept;
+    [[nodiscard]] std::optional<packet> repair(const packet &repair) noexcept;
+
+private:
+    // NOTE: The groups most recently heard of; one older than all of them is given up on.
+    static constexpr size_t WINDOW = 8;
+
+    struct group_state {
+        u16 group;
+        u8 count;  // NOTE: Zero until the repair arrives.
+        bool done;
+        u32 received;
+        u32 acknum;
+        fec_parity parity;
+    };
+
+    std::unique_ptr<std::array<group_state, WINDOW>> m_groups;
+
+    [[nodiscard]] group_state *find(u16 group) noexcept;
+    [[nodiscard]] std::optional<packet> rebuild(group_state &state) noexcept;
+};
+
+}  // namespace rudp::internal
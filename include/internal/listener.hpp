@@ -4,11 +4,17 @@
 
 #include <condition_variable>
 #include <limits>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <unordered_set>
 
 #include "internal/assert.hpp"
 #include "internal/common.hpp"
+#include "internal/epoll.hpp"
+#include "internal/options.hpp"
+#include "internal/transport.hpp"
 
 namespace rudp::internal {
 
@@ -17,19 +23,31 @@ RUDP_STATIC_ASSERT(SOMAXCONN <= std::numeric_limits<u16>::max(),
 
 class listener {
 public:
-    listener(linuxfd_t fd, u16 backlog) noexcept : m_fd(fd), m_backlog(backlog) {}
+    listener(std::shared_ptr<class transport> transport, const options &opts, u16 backlog,
+             std::shared_ptr<class readiness> readiness) noexcept
+        : m_transport(std::move(transport)), m_opts(opts), m_backlog(backlog),
+          m_readiness(std::move(readiness)) {}
 
     void handle_events() noexcept;
     [[nodiscard]] rudpfd_t wait_and_accept() noexcept;
+    [[nodiscard]] std::optional<rudpfd_t> try_accept() noexcept;
+    [[nodiscard]] u32 events() noexcept;
 
 private:
-    const linuxfd_t m_fd;
+    const std::shared_ptr<class transport> m_transport;
+    const options m_opts;
     const u16 m_backlog;
+    const std::shared_ptr<class readiness> m_readiness;
 
     std::queue<rudpfd_t> m_ready;
     std::condition_variable m_cv;
     std::mutex m_mtx;
 
+    // NOTE: Peers with a spawned connection still mid-handshake. A retransmitted SYN from one of
+    // them must not spawn a second connection, whose SYNACK the peer would ignore forever; the
+    // first connection retransmits its own SYNACK instead. Only touched on the event thread.
+    std::unordered_set<u64> m_handshaking;
+
     void assert_external_state(const char *caller) const noexcept;
 };
 
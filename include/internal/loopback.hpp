@@ -0,0 +1,72 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <sys/uio.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <span>
+
+#include "internal/bounded_queue.hpp"
+#include "internal/common.hpp"
+#include "internal/packet.hpp"
+#include "internal/transport.hpp"
+
+namespace rudp::internal {
+
+// NOTE: An in-process transport; datagrams are handed between endpoints through lock-free queues
+// and never touch the kernel. Endpoints are addressed by port alone within their own namespace,
+// so a loopback socket can only ever talk to another loopback socket in the same process.
+class loopback_transport final : public transport {
+public:
+    static constexpr size_t QUEUE_CAPACITY = 256;
+
+    struct datagram {
+        sockaddr_in from;
+        std::chrono::steady_clock::time_point sent_at;
+        ecn codepoint;
+        size_t length;
+        std::array<u8, MAX_DATAGRAM_BYTES> data;
+    };
+
+    struct endpoint {
+        bounded_queue<datagram, QUEUE_CAPACITY> queue;
+        linuxfd_t eventfd{constants::UNINITIALISED_FD};
+
+        // NOTE: Set by the consumer once it has drained the queue, so that only the first producer
+        // afterwards pays for the eventfd write.
+        std::atomic<bool> armed{true};
+
+        ~endpoint();
+    };
+
+    explicit loopback_transport(std::shared_ptr<endpoint> rx) noexcept
+        : m_endpoint(std::move(rx)) {}
+    ~loopback_transport() override;
+
+    [[nodiscard]] static std::shared_ptr<transport> create() noexcept;
+    [[nodiscard]] std::shared_ptr<transport> spawn() const noexcept override;
+
+    [[nodiscard]] linuxfd_t fd() const noexcept override;
+    [[nodiscard]] int bind(const sockaddr_in &addr) noexcept override;
+    [[nodiscard]] int getsockname(sockaddr_in *addr) const noexcept override;
+
+    [[nodiscard]] ssize_t sendmsg(std::span<const iovec> iov, const sockaddr_in &addr,
+                                  ecn codepoint) noexcept override;
+    [[nodiscard]] ssize_t recvfrom(void *buf, size_t len, sockaddr_in *addr,
+                                   arrival *arrival) noexcept override;
+
+private:
+    std::shared_ptr<endpoint> m_endpoint;
+    sockaddr_in m_addr{constants::UNINITIALISED_PEER};
+
+    // NOTE: A connection only ever sends to one peer, so we cache its endpoint to keep the registry
+    // lock off the send path. We assume a single sending thread per transport; the user thread only
+    // sends the initial SYN before the event thread takes over.
+    u16 m_cached_port{};
+    std::shared_ptr<endpoint> m_cached_peer;
+};
+
+}  // namespace rudp::internal
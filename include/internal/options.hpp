@@ -0,0 +1,17 @@
+#pragma once
+
+#include "internal/common.hpp"
+#include "internal/transport.hpp"
+
+namespace rudp::internal {
+
+// NOTE: Set through rudp::setsockopt() and inherited by every connection a listener spawns.
+struct options {
+    transport::kind transport_kind{transport::kind::udp};
+    bool shm{false};
+    bool messages{false};
+    u8 fec_group{0};  // NOTE: Segments per FEC repair, or zero for none.
+    bool compression{false};
+};
+
+}  // namespace rudp::internal
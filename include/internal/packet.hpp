@@ -1,9 +1,15 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <memory>
 #include <optional>
+#include <span>
 #include <vector>
 
 #include "internal/common.hpp"
+#include "internal/tlv.hpp"
+#include "internal/transport.hpp"
 
 namespace rudp::internal {
 
@@ -11,18 +17,47 @@ enum class flag : u8 {
     SYN = 1 << 0,
     ACK = 1 << 1,
     FIN = 1 << 2,
+    SHM = 1 << 3,  // NOTE: Offers, accepts, then confirms the same-host fast path in the handshake.
+    EOR = 1 << 4,  // NOTE: In message mode, marks the final segment of a record.
+    SKIP = 1 << 5,  // NOTE: Stands in for an abandoned segment, whose header it carries.
+    OPT = 1 << 6,   // NOTE: Options follow the checksum; set and cleared by the codec alone.
+    REPAIR = 1 << 7,  // NOTE: FEC parity over a group of segments; takes no sequence space.
+};
+
+// NOTE: Version 4 added the compact layout, which a peer may only be sent once it has advertised
+// the version in a packet of its own. Every version decodes both layouts.
+inline constexpr u8 WIRE_VERSION = 4;
+inline constexpr u8 COMPACT_VERSION = 4;
+
+enum class layout : u8 {
+    full,     // NOTE: Fixed fields, led by the magic, which every version understands.
+    compact,  // NOTE: Led by the version, with varints and the length implied by the datagram.
 };
 
 struct packet_header {
     u16 magic{0x1234};  // NOTE: For detection in tools like Wireshark.
-    u8 version{1};
+    u8 version{WIRE_VERSION};  // NOTE: The highest version the sender speaks.
     u8 flags{};
     u32 seqnum{};
     u32 acknum{};
-    u32 length{};
+    u16 length{};
+
+    // NOTE: Data is ordered by its offset within its stream, rather than by seqnum, so that a loss
+    // only holds up the stream it was sent on.
+    u16 stream{};
+    u32 offset{};
+
+    // NOTE: CRC32C over the header, with this field zeroed, and the payload. Filled in by
+    // sendto() and checked by recvfrom(), which drops a packet that fails.
+    u32 checksum{};
 };
 
-// TODO: Look at something more efficient with m_data and serialise().
+// NOTE: The compact layout at its widest, a marker with every varint at full length, runs two
+// bytes past the full layout.
+inline constexpr size_t MAX_HEADER_BYTES = sizeof(packet_header) + 2;
+inline constexpr size_t MAX_DATAGRAM_BYTES =
+    MAX_HEADER_BYTES + 1 + MAX_OPTION_BYTES + constants::MAX_DATA_BYTES;
+
 class packet {
 public:
     packet_header header;
@@ -30,17 +65,38 @@ public:
     packet() = default;
     explicit packet(packet_header h) : header(h) {};
 
-    static ssize_t sendto(linuxfd_t fd, const packet &packet, const sockaddr_in *addr);
-    static std::optional<packet> recvfrom(linuxfd_t fd, sockaddr_in *addr);
+    static ssize_t sendto(class transport &transport, const packet &packet,
+                          const sockaddr_in *addr, layout layout = layout::full,
+                          ecn codepoint = ecn::not_ect);
+    static std::optional<packet> recvfrom(class transport &transport, sockaddr_in *addr,
+                                          arrival *arrival);
+
+    [[nodiscard]] std::span<const u8> data() const noexcept;
+    [[nodiscard]] std::vector<u8> take_data() noexcept;
+
+    // NOTE: Hands the packet a payload of its own, as a received packet has.
+    void assign_data(std::vector<u8> data) noexcept;
 
-    [[nodiscard]] const std::vector<u8> &data() const noexcept;
-    void push_data(u8 byte) noexcept;
+    // NOTE: Points the packet at bytes it does not own, which owner keeps alive if set. Otherwise
+    // the caller must keep them alive, and unchanged, for as long as the packet may be sent.
+    void view_data(std::span<const u8> data, std::shared_ptr<const void> owner) noexcept;
+
+    // NOTE: Options are not part of the header, so a retransmission built from a sent header
+    // carries none until they are added again.
+    [[nodiscard]] bool add_option(option kind, std::span<const u8> value) noexcept;
+    [[nodiscard]] std::optional<std::span<const u8>> find_option(option kind) const noexcept;
 
 private:
+    // NOTE: A received packet owns its payload, whereas a sent packet views it in place so that it
+    // can be handed to the transport without being copied, including on retransmission.
     std::vector<u8> m_data;
+    std::span<const u8> m_view;
+    std::shared_ptr<const void> m_owner;
+
+    std::array<u8, MAX_OPTION_BYTES> m_options{};
+    size_t m_options_size{0};
 
     [[nodiscard]] static std::optional<packet> deserialise(const std::vector<u8> &data);
-    [[nodiscard]] std::vector<u8> serialise() const noexcept;
 };
 
 }  // namespace rudp::internal
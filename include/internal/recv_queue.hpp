@@ -0,0 +1,71 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+// NOTE: The receive buffer, held as the payloads of the packets which filled it rather than as
+// loose bytes. A payload is moved in without being copied, recv() copies out a chunk at a time,
+// and recv_zc() can hand out a reference to a whole payload which outlives its place in the queue.
+class recv_queue {
+public:
+    using chunk = std::shared_ptr<const std::vector<u8>>;
+
+    // NOTE: In message mode, the payload which completes a record says so.
+    void push(std::vector<u8> &&payload, bool ends_record = false) noexcept;
+
+    // NOTE: Copies from the front into each buffer in turn, consuming the bytes unless peeking.
+    [[nodiscard]] size_t copy(std::span<const iovec> iov, bool peek = false) noexcept;
+    [[nodiscard]] size_t copy(u8 *output, size_t len, bool peek = false) noexcept;
+
+    // NOTE: As above, but stops at the end of the front record, which must be complete. Unless
+    // peeking, the whole record is consumed, and whatever did not fit is discarded and reported
+    // through truncated as with SOCK_SEQPACKET.
+    [[nodiscard]] size_t copy_record(std::span<const iovec> iov, bool peek,
+                                     bool *truncated) noexcept;
+
+    // NOTE: Consumes the unread remainder of the front payload, returning it along with the
+    // reference which keeps it alive. Must not be called on an empty queue.
+    [[nodiscard]] std::span<const u8> loan(chunk *owner) noexcept;
+
+    [[nodiscard]] size_t size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    // NOTE: How many complete records are queued; always zero outside message mode.
+    [[nodiscard]] size_t records() const noexcept {
+        return m_records;
+    }
+
+private:
+    struct entry {
+        chunk payload;
+        bool ends_record;
+    };
+
+    std::deque<entry> m_chunks;
+
+    // NOTE: How much of the front chunk has already been consumed.
+    size_t m_offset{0};
+    size_t m_size{0};
+    size_t m_records{0};
+
+    // NOTE: Copies from the front, stopping short of end, without consuming anything.
+    [[nodiscard]] size_t gather(std::span<const iovec> iov,
+                                std::deque<entry>::const_iterator end) const noexcept;
+    void consume(size_t len) noexcept;
+};
+
+}  // namespace rudp::internal
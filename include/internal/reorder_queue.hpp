@@ -0,0 +1,84 @@
+#pragma once
+
+#include <netinet/in.h>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+#include "internal/packet.hpp"
+
+namespace rudp::internal {
+
+struct received_packet {
+    packet_header header;
+    sockaddr_in peer;
+
+    // NOTE: Whether the payload is in the ring, which it is not for a marker or a bare ACK, and
+    // whether it has since been handed to its stream past the gap.
+    bool filled;
+    bool delivered;
+};
+
+// NOTE: The packets which arrived ahead of a gap. Each payload is copied straight to its place in a
+// ring indexed by sequence number, so none is allocated for. The headers are keyed by sequence
+// number, with a bitmap over the ring marking where each one starts, so that taking the next in
+// order is a lookup and forgetting those the gap's filling has passed is a scan of the bitmap.
+// Those still to be delivered past the gap are also keyed by their place in their stream, so that
+// each stream's run of them is found a lookup at a time as it becomes deliverable.
+class reorder_queue {
+public:
+    // NOTE: Merges packet into any held with the same sequence number, as a bare ACK and the data
+    // following it share one. A packet further past acknum than the ring spans is dropped for the
+    // peer to retransmit, returning false.
+    bool insert(const packet &packet, const sockaddr_in &peer, u32 acknum) noexcept;
+
+    // NOTE: A copy of the payload, which must be in the ring, made as it is delivered to its
+    // stream; the receive buffer owns its payloads, and the ring is reused as the window moves on.
+    // The payload stays in the ring after pop() until the next insert().
+    [[nodiscard]] std::vector<u8> read(const received_packet &received) const noexcept;
+
+    // NOTE: Removes and returns the packet held at seqnum, if any.
+    [[nodiscard]] std::optional<received_packet> pop(u32 seqnum) noexcept;
+
+    // NOTE: The undelivered packet, with a payload or standing in for an abandoned one, which
+    // continues stream from offset. It is marked delivered, as the caller is about to deliver it.
+    [[nodiscard]] received_packet *take_waiting(u16 stream, u32 offset) noexcept;
+
+    // NOTE: Forgets every packet held before acknum, which the connection has moved past.
+    void release(u32 acknum) noexcept;
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_packets.empty();
+    }
+
+private:
+    // NOTE: Twice the most a peer can have in flight, so an in-window packet always has room.
+    static constexpr size_t CAPACITY =
+        2 * constants::MAX_INFLIGHT_PACKETS * constants::MAX_DATA_BYTES;
+    RUDP_STATIC_ASSERT((CAPACITY & (CAPACITY - 1)) == 0,
+                       "A reorder_queue's capacity must be a power of two.");
+
+    static constexpr size_t WORD_BITS = 64;
+
+    // NOTE: The ring and the bitmap are allocated by the first packet to arrive out of order,
+    // which most connections never see. Every held packet starts within CAPACITY of m_base, the
+    // acknum as of the last release(), so a bit names exactly one sequence number.
+    std::unique_ptr<u8[]> m_ring;
+    std::unique_ptr<u64[]> m_starts;
+    std::unordered_map<u32, received_packet> m_packets;
+    std::unordered_map<u64, u32> m_waiting;
+    u32 m_base{0};
+
+    [[nodiscard]] static u64 waiting_key(u16 stream, u32 offset) noexcept {
+        return (static_cast<u64>(stream) << 32) | offset;
+    }
+
+    void erase(u32 seqnum) noexcept;
+};
+
+}  // namespace rudp::internal
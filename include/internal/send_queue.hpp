@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+// NOTE: How long to keep trying to deliver a message before abandoning it; see rudp::send_pr().
+// With neither set, a message is reliable.
+struct reliability {
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    std::optional<u8> max_retransmits;
+
+    [[nodiscard]] bool partial() const noexcept {
+        return deadline.has_value() || max_retransmits.has_value();
+    }
+};
+
+// NOTE: The send buffer, held as segments which outgoing packets view in place rather than copy.
+// Sent bytes stay put until released by an acknowledgement, so the retransmission queue need only
+// remember where a packet's payload lives, and a retransmission views it here again. send() copies
+// into blocks, whereas send_zc() queues the user's own buffer, pinned until it is released.
+class send_queue {
+public:
+    // NOTE: At most one packet's worth from the front of the unsent bytes, never spanning two
+    // segments or two records.
+    struct slice {
+        std::span<const u8> data;
+
+        // NOTE: Where data starts among everything ever pushed, which view() takes.
+        u64 position;
+
+        // NOTE: Set when this is the end of a zero-copy segment, to the id it was queued with.
+        std::optional<u32> completes;
+        bool ends_record;
+        reliability policy;
+    };
+
+    // NOTE: Copies all len bytes; the caller is responsible for bounding size().
+    void push(const u8 *data, size_t len) noexcept;
+    void push_borrowed(std::span<const u8> data, u32 id) noexcept;
+
+    // NOTE: Copies a partially reliable message into a segment of its own, so that it is sent as
+    // one packet and can be abandoned without taking other bytes with it.
+    void push_message(const u8 *data, size_t len, reliability policy) noexcept;
+
+    // NOTE: In message mode, marks everything pushed so far as the end of a record.
+    void end_record() noexcept;
+
+    [[nodiscard]] slice front(size_t max) const noexcept;
+
+    // NOTE: Marks the front len bytes as sent, retaining them until released.
+    void pop(size_t len) noexcept;
+
+    // NOTE: Drops the front message, which must be partially reliable, without it being sent.
+    void discard(size_t len) noexcept;
+
+    // NOTE: The sent bytes at position, which must lie within one segment and not yet be released.
+    [[nodiscard]] std::span<const u8> view(u64 position, size_t len) const noexcept;
+
+    // NOTE: Frees every sent byte before position, as the peer has acknowledged them.
+    void release(u64 position) noexcept;
+
+    // NOTE: Bytes copied in and not yet sent; borrowed bytes cost us no memory, so do not count,
+    // and sent bytes awaiting release are bounded by the window instead.
+    [[nodiscard]] size_t size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_unsent == 0;
+    }
+
+private:
+    struct segment {
+        std::vector<u8> block;  // NOTE: Empty when borrowed.
+        std::span<const u8> data;
+        u64 start;
+        u32 id;
+        bool borrowed;
+        bool discarded;
+        reliability policy;
+    };
+
+    // NOTE: Blocks are reserved up front and never grow past it, so appending to the back block
+    // cannot move bytes which are in flight.
+    static constexpr size_t MAX_BLOCK_BYTES = 64 * 1024;
+
+    // NOTE: Segments from the oldest unreleased onwards; m_cursor indexes the one holding the next
+    // unsent byte, or the last if everything has been sent.
+    std::deque<segment> m_segments;
+    size_t m_cursor{0};
+
+    size_t m_size{0};
+    size_t m_unsent{0};
+
+    // NOTE: Positions among everything ever pushed: the end, the next to send, and the first not
+    // yet released.
+    u64 m_pushed{0};
+    u64 m_popped{0};
+    u64 m_released{0};
+
+    std::deque<u64> m_record_ends;
+
+    [[nodiscard]] bool appendable(const segment &candidate) const noexcept;
+    void settle() noexcept;
+    void trim() noexcept;
+};
+
+}  // namespace rudp::internal
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+#include "internal/packet.hpp"
+#include "internal/send_queue.hpp"
+
+namespace rudp::internal {
+
+// NOTE: What we need to resend a packet, but not its payload, which is viewed again from its
+// stream's send buffer at position.
+struct sent_packet {
+    packet_header header;
+    u64 position;
+    std::chrono::steady_clock::time_point sent_at;
+    u8 retransmits;
+    reliability policy;
+};
+
+// NOTE: The packets awaiting acknowledgement, in the order they were sent, which is also sequence
+// order. A growable ring of slots indexed by segment number, i.e. how many packets were pushed
+// before it, so trimming a cumulative ACK pops from the front and a pass over every packet is a
+// walk along at most two contiguous runs. Sequence numbers are mirrored in a dense ring of their
+// own for lookup, which is O(1) while segments are full and a short binary search otherwise.
+class sent_queue {
+public:
+    sent_queue() noexcept;
+
+    // NOTE: The packet's sequence number must follow that of the back.
+    void push(sent_packet &&sent) noexcept;
+
+    // NOTE: Pops every packet which acknum covers, oldest first, handing each to on_acked before
+    // it goes, and returns how many.
+    template <typename Func>
+    size_t acknowledge(u32 acknum, Func &&on_acked) noexcept {
+        const u64 head = m_head;
+        while (m_head < m_tail && seqnum(m_head) < acknum) {
+            const sent_packet &acked = slot(m_head);
+            on_acked(acked);
+            m_head++;
+        }
+
+        return m_head - head;
+    }
+
+    [[nodiscard]] sent_packet *find(u32 seqnum) noexcept;
+
+    [[nodiscard]] sent_packet &front() noexcept {
+        RUDP_ASSERT(!empty(), "Only a non-empty queue has a front.");
+        return slot(m_head);
+    }
+
+    [[nodiscard]] sent_packet &back() noexcept {
+        RUDP_ASSERT(!empty(), "Only a non-empty queue has a back.");
+        return slot(m_tail - 1);
+    }
+
+    template <typename Func>
+    void for_each(Func &&func) noexcept {
+        for (u64 i = m_head; i < m_tail; i++) {
+            func(slot(i));
+        }
+    }
+
+    void clear() noexcept;
+
+    [[nodiscard]] size_t size() const noexcept {
+        return m_tail - m_head;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_head == m_tail;
+    }
+
+private:
+    // NOTE: Sized to the window to begin with, which covers every connection without loss.
+    static constexpr size_t INITIAL_CAPACITY = 64;
+    RUDP_STATIC_ASSERT((INITIAL_CAPACITY & (INITIAL_CAPACITY - 1)) == 0,
+                       "A sent_queue's capacity must be a power of two.");
+
+    std::unique_ptr<sent_packet[]> m_slots;
+    std::unique_ptr<u32[]> m_seqnums;
+    size_t m_capacity;
+
+    // NOTE: The segment numbers of the front and one past the back, which only ever increase.
+    u64 m_head{0};
+    u64 m_tail{0};
+
+    [[nodiscard]] sent_packet &slot(u64 segment) noexcept {
+        return m_slots[segment & (m_capacity - 1)];
+    }
+
+    [[nodiscard]] u32 seqnum(u64 segment) const noexcept {
+        return m_seqnums[segment & (m_capacity - 1)];
+    }
+
+    void grow() noexcept;
+};
+
+}  // namespace rudp::internal
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <span>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+#include "internal/packet.hpp"
+#include "internal/transport.hpp"
+
+namespace rudp::internal {
+
+// NOTE: The same-host fast path. Once both peers agree on it during the handshake, the active side
+// maps a memfd holding a pair of SPSC rings and hands it, with an eventfd per direction, to the
+// passive side over an abstract unix socket named after the passive side's UDP port. From then on
+// every datagram of the connection is a memcpy into the peer's ring.
+struct shm_ring {
+    static constexpr u32 SLOTS = 256;
+
+    struct slot {
+        // NOTE: The steady clock is system-wide, so the peer's reading is comparable with ours.
+        std::chrono::steady_clock::time_point sent_at;
+        ecn codepoint;
+        u32 length;
+        u8 data[MAX_DATAGRAM_BYTES];
+    };
+
+    alignas(constants::CACHE_LINE_BYTES) std::atomic<u32> head;
+    alignas(constants::CACHE_LINE_BYTES) std::atomic<u32> tail;
+
+    // NOTE: Set by the consumer once the ring is drained. Only the producer which clears it pays
+    // for the eventfd write, so a busy peer is signalled once per drain rather than per datagram.
+    alignas(constants::CACHE_LINE_BYTES) std::atomic<u32> armed;
+
+    slot slots[SLOTS];
+};
+
+RUDP_STATIC_ASSERT(std::atomic<u32>::is_always_lock_free,
+                   "Atomics shared across processes must be lock-free.");
+
+class shm_transport final : public transport {
+public:
+    shm_transport(void *region, shm_ring *tx, shm_ring *rx, linuxfd_t tx_eventfd,
+                  linuxfd_t rx_eventfd, const sockaddr_in &peer) noexcept
+        : m_region(region), m_tx(tx), m_rx(rx), m_tx_eventfd(tx_eventfd), m_rx_eventfd(rx_eventfd),
+          m_peer(peer) {}
+    ~shm_transport() override;
+
+    [[nodiscard]] std::shared_ptr<transport> spawn() const noexcept override;
+
+    [[nodiscard]] linuxfd_t fd() const noexcept override;
+    [[nodiscard]] int bind(const sockaddr_in &addr) noexcept override;
+    [[nodiscard]] int getsockname(sockaddr_in *addr) const noexcept override;
+
+    [[nodiscard]] ssize_t sendmsg(std::span<const iovec> iov, const sockaddr_in &addr,
+                                  ecn codepoint) noexcept override;
+    [[nodiscard]] ssize_t recvfrom(void *buf, size_t len, sockaddr_in *addr,
+                                   arrival *arrival) noexcept override;
+
+private:
+    void *const m_region;
+    shm_ring *const m_tx;
+    shm_ring *const m_rx;
+    const linuxfd_t m_tx_eventfd;
+    const linuxfd_t m_rx_eventfd;
+
+    // NOTE: Reported as the source of every datagram, so the connection's peer filter still holds.
+    const sockaddr_in m_peer;
+};
+
+namespace shm {
+    [[nodiscard]] bool is_same_host(const sockaddr_in &addr) noexcept;
+
+    // NOTE: The passive side listens before answering the SYN, so the offer can never race it.
+    // listen() draws a nonce for the SYNACK to carry, which the offer must hand back; accept()
+    // takes only an offer which does, from a process running as our own user.
+    [[nodiscard]] linuxfd_t listen(const transport &transport, u64 *nonce) noexcept;
+    [[nodiscard]] std::shared_ptr<transport> offer(const sockaddr_in &peer, u64 nonce) noexcept;
+    [[nodiscard]] std::shared_ptr<transport> accept(linuxfd_t listenfd, const sockaddr_in &peer,
+                                                    u64 nonce) noexcept;
+}  // namespace shm
+
+}  // namespace rudp::internal
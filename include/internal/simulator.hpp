@@ -1,6 +1,14 @@
 #pragma once
 
+#include <sys/uio.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <span>
+
 #include "internal/common.hpp"
+#include "internal/transport.hpp"
 
 namespace rudp::internal {
 
@@ -12,12 +20,23 @@ public:
     u16 min_latency_ms{};
     u16 max_latency_ms{};
 
+    // NOTE: A bottleneck in front of each destination, draining queue_rate datagrams a millisecond.
+    // Once more than ce_threshold are queued, an ECN-capable datagram is marked CE and any other
+    // dropped, as an AQM would. Nothing is actually held back; only the depth is tracked.
+    u16 queue_rate{};
+    u16 ce_threshold{};
+
     void reset() {
         drop = {};
         corruption = {};
         duplication = {};
         min_latency_ms = {};
         max_latency_ms = {};
+        queue_rate = {};
+        ce_threshold = {};
+
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_queues.clear();
     }
 
     static simulator &instance() {
@@ -25,10 +44,25 @@ public:
         return instance;
     }
 
-    [[nodiscard]] static ssize_t sendto(int sockfd, const void *buf, size_t len, int flags,
-                                        const sockaddr *addr, socklen_t addrlen);
+    [[nodiscard]] bool enabled() const noexcept;
+
+    [[nodiscard]] static ssize_t sendmsg(transport &transport, std::span<const iovec> iov,
+                                         const sockaddr_in &addr, ecn codepoint);
 
 private:
+    struct queue {
+        double depth;
+        std::chrono::steady_clock::time_point drained_at;
+    };
+
+    // NOTE: Keyed by address and port. Both ends of a connection send through here, each from its
+    // own thread.
+    std::mutex m_mtx;
+    std::map<u64, queue> m_queues;
+
+    // NOTE: Queues the datagram, returning false if it is to be dropped.
+    [[nodiscard]] bool enqueue(const sockaddr_in &addr, ecn &codepoint) noexcept;
+
     [[nodiscard]] bool should_drop() const noexcept;
     [[nodiscard]] bool should_corrupt() const noexcept;
     [[nodiscard]] bool should_duplicate() const noexcept;
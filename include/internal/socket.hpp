@@ -1,31 +1,89 @@
 #pragma once
 
+#include <fcntl.h>
+#include <sys/socket.h>
+
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include "internal/common.hpp"
 #include "internal/connection.hpp"
+#include "internal/epoll.hpp"
 #include "internal/listener.hpp"
+#include "internal/options.hpp"
+#include "internal/transport.hpp"
 
 namespace rudp::internal {
 
+// NOTE: The event thread inserts the sockets a listener spawns and walks every socket to drive
+// sends, so lookups, insertions and state transitions hold this. A socket is never moved once
+// inserted, so a reference found under the lock remains valid after it is released.
+extern std::mutex &g_sockets_mtx;
+
+// NOTE: The connected subset of g_sockets, which is all the event thread needs to walk. Keeping
+// it apart means idle sockets which never connect, e.g. those parked on an epoll instance, cost
+// the event thread nothing. Guarded by g_sockets_mtx.
+extern std::vector<class connection *> &g_connections;
+
 struct socket {
     // clang-format off
     std::variant<
         std::monostate,                     // created
-        linuxfd_t,                          // bound
+        std::shared_ptr<class transport>,   // bound
         std::unique_ptr<class listener>,    // listening
         std::unique_ptr<class connection>   // connected
      > data;
     // clang-format on
 
+    options opts{};
+
+    // NOTE: File status flags set through rudp::fcntl(). Like accept(2), a listener does not pass
+    // these on to the sockets it spawns.
+    int flags{};
+
+    std::shared_ptr<class readiness> readiness = std::make_shared<class readiness>();
+
+    bool nonblocking() const noexcept {
+        return (flags & O_NONBLOCK) != 0;
+    }
+
+    template <typename State>
+    void transition(State &&state) noexcept {
+        std::lock_guard<std::mutex> lock(g_sockets_mtx);
+        if (connected()) {
+            std::erase(g_connections, connection());
+        }
+
+        data = std::forward<State>(state);
+        if (connected()) {
+            g_connections.push_back(connection());
+        }
+    }
+
+    // NOTE: The EPOLLIN and EPOLLOUT events which currently hold for the socket.
+    u32 events() const noexcept {
+        if (listening()) {
+            return listener()->events();
+        }
+
+        if (connected()) {
+            return connection()->events();
+        }
+
+        return 0;
+    }
+
     bool created() const noexcept {
         return std::holds_alternative<std::monostate>(data);
     }
 
     bool bound() const noexcept {
-        return std::holds_alternative<linuxfd_t>(data);
+        return std::holds_alternative<std::shared_ptr<class transport>>(data);
     }
 
     bool listening() const noexcept {
@@ -36,9 +94,9 @@ struct socket {
         return std::holds_alternative<std::unique_ptr<class connection>>(data);
     }
 
-    linuxfd_t fd() const noexcept {
-        RUDP_ASSERT(bound(), "A socket must be bound for an underlying file descriptor to exist.");
-        return std::get<linuxfd_t>(data);
+    const std::shared_ptr<class transport> &transport() const noexcept {
+        RUDP_ASSERT(bound(), "A socket must be bound for an underlying transport to exist.");
+        return std::get<std::shared_ptr<class transport>>(data);
     }
 
     class listener *listener() const noexcept {
@@ -52,9 +110,19 @@ struct socket {
     }
 };
 
-linuxfd_t create_raw_socket();
+extern std::atomic<rudpfd_t> g_next_fd;
+extern std::unordered_map<rudpfd_t, socket> &g_sockets;
+
+[[nodiscard]] socket *find_socket(rudpfd_t fd) noexcept;
+void insert_socket(rudpfd_t fd, socket &&sock) noexcept;
 
-extern rudpfd_t g_next_fd;
-extern std::unordered_map<rudpfd_t, socket> g_sockets;
+// NOTE: accept() and connect(), which with MSG_DONTWAIT in flags behave as though the socket were
+// non-blocking without changing its flags, and whether a connected socket's handshake is done. The
+// async layer drives sockets through these, as it must never block yet does not own the socket.
+[[nodiscard]] int accept_socket(rudpfd_t fd, sockaddr *addr, socklen_t *addrlen,
+                                int flags) noexcept;
+[[nodiscard]] int connect_socket(rudpfd_t fd, sockaddr *addr, socklen_t addrlen,
+                                 int flags) noexcept;
+[[nodiscard]] bool is_established(rudpfd_t fd) noexcept;
 
 }  // namespace rudp::internal
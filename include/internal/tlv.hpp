@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+// NOTE: Header options, carried when flag::OPT is set as a length byte followed by a run of kind,
+// length and value. Encoded and decoded in place without allocating. A kind we do not know is
+// skipped, so that a newer peer may send options we have never heard of.
+enum class option : u8 {
+    capabilities = 1,  // NOTE: In the SYN and SYNACK, the sender's capability bits as a u32.
+
+    // NOTE: The sender's clock when sending, then the latest such value it received from us, as
+    // u32s in microseconds; see RFC 7323.
+    timestamp = 2,
+
+    // NOTE: On a segment, its FEC group as a u16 and its index within it as a u8. On a repair,
+    // the group, the count of segments in it, then what it restores; see fec.hpp.
+    fec = 3,
+    fec_repair = 4,
+
+    // NOTE: On an ACK, how many datagrams the sender has received marked CE, as a u32; see
+    // RFC 3168. A running count rather than a flag, so that a lost ACK loses no marks.
+    ecn_echo = 5,
+
+    // NOTE: On a segment whose payload is compressed, its length before compression as a u16. The
+    // header's length is then the compressed payload's, though the segment still takes up the
+    // original's sequence space.
+    compressed = 6,
+
+    // NOTE: On a SYNACK offering shared memory, a random u64 which the active side's offer must
+    // carry back; see shm.hpp.
+    shm_nonce = 7,
+};
+
+inline constexpr size_t MAX_OPTION_BYTES = 40;
+
+// NOTE: Optional features, each enabled only when both peers offer it in their capabilities.
+inline constexpr u32 CAPABILITY_TIMESTAMPS = 1 << 0;
+inline constexpr u32 CAPABILITY_FEC = 1 << 1;  // NOTE: That repairs are understood, not sent.
+inline constexpr u32 CAPABILITY_ECN = 1 << 2;
+inline constexpr u32 CAPABILITY_COMPRESSION = 1 << 3;  // NOTE: As with FEC, understood, not sent.
+inline constexpr u32 SUPPORTED_CAPABILITIES =
+    CAPABILITY_TIMESTAMPS | CAPABILITY_FEC | CAPABILITY_ECN | CAPABILITY_COMPRESSION;
+
+// NOTE: Appends to the size bytes of area already used, returning false if there is no room.
+[[nodiscard]] bool append_option(std::span<u8> area, size_t &size, option kind,
+                                 std::span<const u8> value) noexcept;
+
+// NOTE: area must have passed valid_options().
+[[nodiscard]] std::optional<std::span<const u8>> find_option(std::span<const u8> area,
+                                                             option kind) noexcept;
+
+[[nodiscard]] bool valid_options(std::span<const u8> area) noexcept;
+
+}  // namespace rudp::internal
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <chrono>
+#include <memory>
+#include <span>
+
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+// NOTE: A datagram's ECN codepoint, from the low bits of its TOS byte; see RFC 3168.
+enum class ecn : u8 {
+    not_ect = 0b00,
+    ect1 = 0b01,
+    ect0 = 0b10,
+    ce = 0b11,  // NOTE: Congestion experienced, marked in place of a drop.
+};
+
+// NOTE: What a transport knows of a datagram besides its contents.
+struct arrival {
+    // NOTE: When it arrived, which may be well before it is read if the event thread was busy. A
+    // transport which cannot tell reports the time it was read.
+    std::chrono::steady_clock::time_point at;
+    ecn codepoint{ecn::not_ect};
+};
+
+// NOTE: A transport moves serialised datagrams between two endpoints. The protocol only ever talks
+// to a transport, so it can run over the kernel or entirely in-process. Every transport exposes a
+// pollable fd which becomes readable when a datagram is waiting, so the event loop can stay on
+// epoll regardless of where the datagrams actually live.
+class transport {
+public:
+    enum class kind : u8 { udp, loopback };
+
+    transport() = default;
+    virtual ~transport() = default;
+
+    transport(const transport &) = delete;
+    transport &operator=(const transport &) = delete;
+    transport(transport &&) = delete;
+    transport &operator=(transport &&) = delete;
+
+    // NOTE: These return nullptr on failure, with errno forwarded from the underlying calls.
+    [[nodiscard]] static std::shared_ptr<transport> create(kind kind) noexcept;
+    [[nodiscard]] virtual std::shared_ptr<transport> spawn() const noexcept = 0;
+
+    [[nodiscard]] virtual linuxfd_t fd() const noexcept = 0;
+    [[nodiscard]] virtual int bind(const sockaddr_in &addr) noexcept = 0;
+    [[nodiscard]] virtual int getsockname(sockaddr_in *addr) const noexcept = 0;
+
+    // NOTE: Sends the buffers as one datagram, so a header and its payload need not be joined.
+    [[nodiscard]] virtual ssize_t sendmsg(std::span<const iovec> iov, const sockaddr_in &addr,
+                                          ecn codepoint) noexcept = 0;
+    [[nodiscard]] virtual ssize_t recvfrom(void *buf, size_t len, sockaddr_in *addr,
+                                           arrival *arrival) noexcept = 0;
+};
+
+class udp_transport final : public transport {
+public:
+    explicit udp_transport(linuxfd_t fd) noexcept : m_fd(fd) {}
+    ~udp_transport() override;
+
+    [[nodiscard]] std::shared_ptr<transport> spawn() const noexcept override;
+
+    [[nodiscard]] linuxfd_t fd() const noexcept override;
+    [[nodiscard]] int bind(const sockaddr_in &addr) noexcept override;
+    [[nodiscard]] int getsockname(sockaddr_in *addr) const noexcept override;
+
+    [[nodiscard]] ssize_t sendmsg(std::span<const iovec> iov, const sockaddr_in &addr,
+                                  ecn codepoint) noexcept override;
+    [[nodiscard]] ssize_t recvfrom(void *buf, size_t len, sockaddr_in *addr,
+                                   arrival *arrival) noexcept override;
+
+private:
+    const linuxfd_t m_fd;
+};
+
+// NOTE: For transports which copy each datagram into a slot of their own anyway.
+[[nodiscard]] size_t iov_length(std::span<const iovec> iov) noexcept;
+void gather(u8 *output, std::span<const iovec> iov) noexcept;
+
+}  // namespace rudp::internal
@@ -1,10 +1,57 @@
 #pragma once
 
+#include <fcntl.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
 namespace rudp {
 
+// Socket options for rudp::setsockopt() and rudp::getsockopt().
+inline constexpr int SOL_RUDP = 0x5255;
+
+inline constexpr int RUDP_TRANSPORT = 1;  // int, set before bind() or connect()
+inline constexpr int RUDP_TRANSPORT_UDP = 0;
+inline constexpr int RUDP_TRANSPORT_LOOPBACK = 1;  // in-process, for benchmarking the stack
+
+// int boolean, set before listen() or connect(). When both peers opt in and share a host, the
+// handshake moves the connection onto shared memory; send() and recv() are unaffected.
+inline constexpr int RUDP_SHM = 2;
+inline constexpr int RUDP_SHM_ACTIVE = 3;  // int boolean, read-only, whether the above took effect
+
+// int boolean, set before listen() or connect(), on both peers. Preserves record boundaries as
+// with SOCK_SEQPACKET: each send is buffered whole or fails, up to the send buffer's size, and
+// arrives as one recv(). A record too large for the buffer given is truncated, which recvmsg()
+// reports through MSG_TRUNC. recv_zc() and on_data() still hand out a record a segment at a time.
+inline constexpr int RUDP_MESSAGES = 4;
+
+// int, read-only, in microseconds. How long received datagrams have lately waited to be read after
+// reaching the socket, smoothed; when it keeps growing, the event thread is saturated. Zero until
+// connected.
+inline constexpr int RUDP_QUEUEING_DELAY = 5;
+
+// int, set before listen() or connect(); 0, the default, disables it. Follows every run of this
+// many segments, from 1 to 32, with a repair packet from which the peer rebuilds any one of them
+// that is lost without waiting for its retransmission. Costs one packet per run. A shorter run is
+// repaired once it has waited half a retransmission timeout, unless acknowledged by then.
+inline constexpr int RUDP_FEC = 6;
+
+// int, read-only, in packets. How many may be in flight at once: 64 to begin with, halved when the
+// peer reports that the network marked our data as congested (ECN), and widened by one for each
+// window acknowledged. The full 64 until connected.
+inline constexpr int RUDP_CONGESTION_WINDOW = 7;
+
+// int boolean, set before listen() or connect(). Compresses each segment's payload with a fast LZ
+// codec, when the peer understands it, and sends any which does not shrink as is; a stream which
+// keeps failing to shrink is soon hardly looked at. Pays off where bandwidth is scarcer than CPU.
+// The receiving side need set nothing.
+inline constexpr int RUDP_COMPRESSION = 8;
+
 // NOTE: Our interface exposes rudpfd_t as a socket handle, not the underlying file descriptor;
 // this means library users cannot call helpful utility functions such as getsockname(). It would be
 // nice to provide proxy functions for some subset of these.
@@ -16,6 +63,93 @@ namespace rudp {
 [[nodiscard]] int connect(int sockfd, struct sockaddr *addr, socklen_t addrlen) noexcept;
 [[nodiscard]] ssize_t send(int sockfd, const void *buf, size_t len, int flags) noexcept;
 [[nodiscard]] ssize_t recv(int sockfd, void *buf, size_t len, int flags) noexcept;
+
+// NOTE: Scatter/gather forms of send() and recv(), which copy every buffer in msg_iov under one
+// lock; msg_name and msg_control are ignored, and recvmsg() reports neither. Alongside
+// MSG_DONTWAIT, recv() and recvmsg() accept MSG_PEEK, and MSG_WAITALL to block until every buffer
+// can be filled.
+[[nodiscard]] ssize_t sendmsg(int sockfd, const struct msghdr *msg, int flags) noexcept;
+[[nodiscard]] ssize_t recvmsg(int sockfd, struct msghdr *msg, int flags) noexcept;
+[[nodiscard]] int setsockopt(int sockfd, int level, int optname, const void *optval,
+                             socklen_t optlen) noexcept;
+[[nodiscard]] int getsockopt(int sockfd, int level, int optname, void *optval,
+                             socklen_t *optlen) noexcept;
+
+// NOTE: Supports F_GETFL and F_SETFL with O_NONBLOCK. A non-blocking socket fails with EAGAIN
+// wherever it would otherwise block; connect() instead fails with EINPROGRESS and then EALREADY
+// until the handshake completes. send() and recv() also accept MSG_DONTWAIT per call.
+[[nodiscard]] int fcntl(int sockfd, int cmd, int arg = 0) noexcept;
+
+// NOTE: Zero-copy send, modelled on MSG_ZEROCOPY. Rather than copying, send_zc() queues buf itself
+// and always takes all len bytes, which are read in place by every transmission of them. The buffer
+// must stay valid and unchanged until the send completes, i.e. every byte has been acknowledged.
+// Each successful call is given the next id, counting from zero per socket. Completions arrive in
+// order and send_zc_completions() reports them as the inclusive range [*first, *last], covering
+// everything since its last report. Pending completions also raise EPOLLERR on an epoll.
+[[nodiscard]] ssize_t send_zc(int sockfd, const void *buf, size_t len, int flags) noexcept;
+[[nodiscard]] int send_zc_completions(int sockfd, uint32_t *first, uint32_t *last,
+                                      int flags) noexcept;
+
+// NOTE: Zero-copy receive. Rather than copying into a caller buffer, recv_zc() points *buf at the
+// unread part of the next received payload, up to one segment, and returns its length. The bytes
+// stay valid and unchanged until passed back to release(); holding many loans holds their memory.
+[[nodiscard]] ssize_t recv_zc(int sockfd, const void **buf, int flags) noexcept;
+[[nodiscard]] int release(int sockfd, const void *buf) noexcept;
+
+// NOTE: Installs a callback which the event thread hands each in-order payload as it arrives,
+// straight from the packet, instead of appending it to the receive buffer for recv(). The span is
+// only valid for the duration of the call. Bytes buffered before installation remain for recv(),
+// and passing an empty callback restores it. The callback runs on the event thread and so must not
+// block; a send() from it must pass MSG_DONTWAIT.
+using data_callback = std::function<void(std::span<const std::byte>)>;
+[[nodiscard]] int on_data(int sockfd, data_callback callback) noexcept;
+
+// NOTE: Independent streams within one connection, each delivered in its own order, so that a loss
+// only holds up the stream it was sent on. Stream 0 is the one send() and recv() use, and the only
+// one for sendmsg(), recvmsg(), the zero-copy calls and on_data(). open_stream() numbers a new
+// stream, which the peer learns of from its first byte and picks up with accept_stream(). Each
+// stream has its own send buffer, and the connection sends from each stream with data in turn.
+// send_stream() and recv_stream() otherwise behave as send() and recv(); an unknown stream is
+// EINVAL. Data from the peer on a stream of our numbering which we never opened, or opening more
+// than 256 streams of its own, is dropped.
+[[nodiscard]] int open_stream(int sockfd) noexcept;
+[[nodiscard]] int accept_stream(int sockfd, int flags) noexcept;
+[[nodiscard]] ssize_t send_stream(int sockfd, int stream, const void *buf, size_t len,
+                                  int flags) noexcept;
+[[nodiscard]] ssize_t recv_stream(int sockfd, int stream, void *buf, size_t len,
+                                  int flags) noexcept;
+
+// NOTE: Partially reliable send, after PR-SCTP, for data which is worthless once stale. The message
+// is sent as one packet, so it may be at most 1024 bytes, and is abandoned rather than
+// retransmitted once its policy runs out:
+//   RUDP_PR_UNRELIABLE is sent once and never retransmitted,
+//   RUDP_PR_DEADLINE is given up value milliseconds after the call, whether sent or still buffered,
+//   RUDP_PR_RETRANSMITS is given up after value retransmissions, which must be fewer than 20.
+// An abandoned message is replaced on the wire by a header-only marker, from which the receiver
+// skips past it; it is either received whole or not at all, and its stream stays ordered. With
+// RUDP_PR_RELIABLE this is send_stream(), which ignores value and the size limit.
+inline constexpr int RUDP_PR_RELIABLE = 0;
+inline constexpr int RUDP_PR_UNRELIABLE = 1;
+inline constexpr int RUDP_PR_DEADLINE = 2;
+inline constexpr int RUDP_PR_RETRANSMITS = 3;
+[[nodiscard]] ssize_t send_pr(int sockfd, int stream, const void *buf, size_t len, int policy,
+                              int value, int flags) noexcept;
+
+// NOTE: Mirrors epoll(7) for rudp sockets, supporting EPOLLIN, EPOLLOUT, EPOLLET and EPOLLONESHOT,
+// with EPOLLERR always reported. EPOLLIN is raised by data on any stream, or a stream to accept;
+// EPOLLOUT by space on stream 0 alone.
+// The interest and ready lists live in userspace and are fed by the event thread, so a wait costs
+// O(ready) however many sockets are registered. Instances share the socket descriptor space.
+[[nodiscard]] int epoll_create(int size) noexcept;
+[[nodiscard]] int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event) noexcept;
+[[nodiscard]] int epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+                             int timeout) noexcept;
+
+// NOTE: Returns a kernel eventfd which is readable while the instance has sockets queued on its
+// ready list, so an instance can be watched from an existing epoll, libuv or asio loop. Once it
+// fires, call rudp::epoll_wait() with a timeout of zero; the eventfd is drained as the ready list
+// empties and must not be read from directly. It is owned by the instance.
+[[nodiscard]] int epoll_eventfd(int epfd) noexcept;
 int close(int sockfd) noexcept;
 
 }  // namespace rudp
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace rudp::async {
+
+// NOTE: A coroutine layer over the non-blocking API. Each operation is attempted straight away and
+// only suspends on EAGAIN, parking the coroutine on a loop until the rudp epoll instance reports
+// the socket ready; the event thread's readiness notifications are what resume it. Coroutines run
+// on whichever thread calls loop::run(), never on the event thread, so one thread can drive any
+// number of connections without application code running under the event thread's locks.
+//
+// Results follow the blocking API: -1 with errno set on failure.
+
+template <typename T = void>
+class task;
+
+class loop;
+
+namespace detail {
+    struct final_awaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            return handle.promise().continuation;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    struct promise_base {
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        final_awaiter final_suspend() const noexcept {
+            return {};
+        }
+
+        // NOTE: Like the rest of the library, nothing here throws; an escaping exception is a bug.
+        void unhandled_exception() const noexcept {
+            std::terminate();
+        }
+    };
+
+    template <typename T>
+    struct promise : promise_base {
+        std::optional<T> value;
+
+        task<T> get_return_object() noexcept;
+
+        void return_value(T result) noexcept {
+            value.emplace(std::move(result));
+        }
+
+        T result() noexcept {
+            return std::move(*value);
+        }
+    };
+
+    template <>
+    struct promise<void> : promise_base {
+        task<void> get_return_object() noexcept;
+
+        void return_void() const noexcept {}
+        void result() const noexcept {}
+    };
+
+    // NOTE: Starts eagerly and frees itself on completion; the frame owns the task it awaits.
+    struct detached {
+        struct promise_type {
+            detached get_return_object() const noexcept {
+                return {};
+            }
+
+            std::suspend_never initial_suspend() const noexcept {
+                return {};
+            }
+
+            std::suspend_never final_suspend() const noexcept {
+                return {};
+            }
+
+            void return_void() const noexcept {}
+
+            void unhandled_exception() const noexcept {
+                std::terminate();
+            }
+        };
+    };
+
+    // NOTE: The awaitable behind every socket operation. perform() is the non-blocking call; on
+    // EAGAIN the operation parks itself on the loop, which calls attempt() again each time the
+    // socket is reported ready and resumes the waiting coroutine once it completes.
+    class operation {
+    public:
+        operation(class loop &loop, int sockfd, bool writes) noexcept
+            : m_sockfd(sockfd), m_loop(loop), m_writes(writes) {}
+        virtual ~operation() = default;
+
+        operation(const operation &) = delete;
+        operation &operator=(const operation &) = delete;
+        operation(operation &&) = delete;
+        operation &operator=(operation &&) = delete;
+
+        bool await_ready() noexcept {
+            return attempt();
+        }
+
+        void await_suspend(std::coroutine_handle<> waiter) noexcept;
+
+        ssize_t await_resume() const noexcept {
+            errno = m_errno;
+            return m_result;
+        }
+
+        [[nodiscard]] bool attempt() noexcept;
+        [[nodiscard]] std::coroutine_handle<> waiter() const noexcept {
+            return m_waiter;
+        }
+
+    protected:
+        const int m_sockfd;
+
+        [[nodiscard]] virtual ssize_t perform() noexcept = 0;
+
+    private:
+        class loop &m_loop;
+        const bool m_writes;
+
+        std::coroutine_handle<> m_waiter;
+        ssize_t m_result{-1};
+        int m_errno{};
+    };
+
+    class accept_operation final : public operation {
+    public:
+        accept_operation(class loop &loop, int sockfd, struct sockaddr *addr,
+                         socklen_t *addrlen) noexcept
+            : operation(loop, sockfd, false), m_addr(addr), m_addrlen(addrlen) {}
+
+    private:
+        struct sockaddr *const m_addr;
+        socklen_t *const m_addrlen;
+
+        [[nodiscard]] ssize_t perform() noexcept override;
+    };
+
+    class connect_operation final : public operation {
+    public:
+        connect_operation(class loop &loop, int sockfd, struct sockaddr *addr,
+                          socklen_t addrlen) noexcept
+            : operation(loop, sockfd, true), m_addr(addr), m_addrlen(addrlen) {}
+
+    private:
+        struct sockaddr *const m_addr;
+        const socklen_t m_addrlen;
+        bool m_started{false};
+
+        [[nodiscard]] ssize_t perform() noexcept override;
+    };
+
+    class send_operation final : public operation {
+    public:
+        send_operation(class loop &loop, int sockfd, const void *buf, size_t len) noexcept
+            : operation(loop, sockfd, true), m_buf(buf), m_len(len) {}
+
+    private:
+        const void *const m_buf;
+        const size_t m_len;
+
+        [[nodiscard]] ssize_t perform() noexcept override;
+    };
+
+    class recv_operation final : public operation {
+    public:
+        recv_operation(class loop &loop, int sockfd, void *buf, size_t len) noexcept
+            : operation(loop, sockfd, false), m_buf(buf), m_len(len) {}
+
+    private:
+        void *const m_buf;
+        const size_t m_len;
+
+        [[nodiscard]] ssize_t perform() noexcept override;
+    };
+}  // namespace detail
+
+// NOTE: A lazily started coroutine. Awaiting it starts it, and the awaiter is resumed directly
+// once it finishes; hand a task<void> to loop::spawn() to run it without an awaiter.
+template <typename T>
+class [[nodiscard]] task {
+public:
+    using promise_type = detail::promise<T>;
+
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+    ~task() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+    task(task &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    task &operator=(task &&) = delete;
+
+    auto operator co_await() && noexcept {
+        struct awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+                handle.promise().continuation = caller;
+                return handle;
+            }
+
+            T await_resume() const noexcept {
+                return handle.promise().result();
+            }
+        };
+
+        return awaiter{m_handle};
+    }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template <typename T>
+task<T> detail::promise<T>::get_return_object() noexcept {
+    return task<T>(std::coroutine_handle<promise<T>>::from_promise(*this));
+}
+
+inline task<void> detail::promise<void>::get_return_object() noexcept {
+    return task<void>(std::coroutine_handle<promise<void>>::from_promise(*this));
+}
+
+class loop {
+public:
+    loop() noexcept;
+
+    loop(const loop &) = delete;
+    loop &operator=(const loop &) = delete;
+    loop(loop &&) = delete;
+    loop &operator=(loop &&) = delete;
+
+    // NOTE: Whether the rudp epoll instance could be created; nothing else works otherwise.
+    [[nodiscard]] bool valid() const noexcept {
+        return m_epfd >= 0;
+    }
+
+    // NOTE: Runs the task until its first suspension, then leaves it to run().
+    void spawn(task<void> work) noexcept;
+
+    // NOTE: Resumes parked coroutines as their sockets become ready, returning once every spawned
+    // task has finished or stop() is called. Returns -1 with errno set if waiting fails.
+    int run() noexcept;
+
+    // NOTE: Called from a coroutine, makes run() return once the current batch of events is done.
+    // Parked coroutines stay parked, and a later run() picks them up again.
+    void stop() noexcept {
+        m_stopping = true;
+    }
+
+    [[nodiscard]] detail::accept_operation accept(int sockfd, struct sockaddr *addr = nullptr,
+                                                  socklen_t *addrlen = nullptr) noexcept {
+        return {*this, sockfd, addr, addrlen};
+    }
+
+    [[nodiscard]] detail::connect_operation connect(int sockfd, struct sockaddr *addr,
+                                                    socklen_t addrlen) noexcept {
+        return {*this, sockfd, addr, addrlen};
+    }
+
+    [[nodiscard]] detail::send_operation send(int sockfd, const void *buf, size_t len) noexcept {
+        return {*this, sockfd, buf, len};
+    }
+
+    [[nodiscard]] detail::recv_operation recv(int sockfd, void *buf, size_t len) noexcept {
+        return {*this, sockfd, buf, len};
+    }
+
+private:
+    friend class detail::operation;
+
+    struct waiters {
+        detail::operation *reader;
+        detail::operation *writer;
+    };
+
+    const int m_epfd;
+    size_t m_active{0};
+    bool m_stopping{false};
+    std::unordered_map<int, waiters> m_waiters;
+
+    void park(int sockfd, bool writes, detail::operation *operation) noexcept;
+    detail::detached launch(task<void> work) noexcept;
+};
+
+}  // namespace rudp::async
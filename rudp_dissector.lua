@@ -6,6 +6,8 @@ local fields = {
 	flags = ProtoField.uint8("_rudp.flags", "Flags", base.HEX),
 	syn = ProtoField.bool("_rudp.flags.syn", "SYN", 8, nil, 0x01),
 	ack = ProtoField.bool("_rudp.flags.ack", "ACK", 8, nil, 0x02),
+	fin = ProtoField.bool("_rudp.flags.fin", "FIN", 8, nil, 0x04),
+	shm = ProtoField.bool("_rudp.flags.shm", "SHM", 8, nil, 0x08),
 	seqnum = ProtoField.uint32("_rudp.seqnum", "Sequence Number", base.DEC),
 	acknum = ProtoField.uint32("_rudp.acknum", "Acknowledgment Number", base.DEC),
 	length = ProtoField.uint32("_rudp.length", "Data Length", base.DEC),
@@ -35,6 +37,8 @@ function rudp.dissector(buffer, pinfo, tree)
 	local flags_tree = subtree:add(fields.flags, buffer(3, 1))
 	flags_tree:add(fields.syn, buffer(3, 1))
 	flags_tree:add(fields.ack, buffer(3, 1))
+	flags_tree:add(fields.fin, buffer(3, 1))
+	flags_tree:add(fields.shm, buffer(3, 1))
 
 	subtree:add(fields.seqnum, buffer(4, 4))
 	subtree:add(fields.acknum, buffer(8, 4))
@@ -53,6 +57,12 @@ function rudp.dissector(buffer, pinfo, tree)
 	if bit.band(flags, 0x02) ~= 0 then
 		table.insert(flag_strs, "ACK")
 	end
+	if bit.band(flags, 0x04) ~= 0 then
+		table.insert(flag_strs, "FIN")
+	end
+	if bit.band(flags, 0x08) ~= 0 then
+		table.insert(flag_strs, "SHM")
+	end
 	local flag_str = table.concat(flag_strs, ",")
 
 	pinfo.cols.info = string.format(
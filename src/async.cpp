@@ -0,0 +1,135 @@
+#include "rudp/async.hpp"
+
+#include <sys/epoll.h>
+
+#include <cerrno>
+#include <coroutine>
+#include <rudp.hpp>
+#include <utility>
+
+#include "internal/assert.hpp"
+#include "internal/socket.hpp"
+
+namespace rudp::async {
+namespace detail {
+    void operation::await_suspend(std::coroutine_handle<> waiter) noexcept {
+        m_waiter = waiter;
+        m_loop.park(m_sockfd, m_writes, this);
+    }
+
+    bool operation::attempt() noexcept {
+        m_result = perform();
+        if (m_result < 0 && errno == EAGAIN) {
+            return false;
+        }
+
+        m_errno = errno;
+        return true;
+    }
+
+    ssize_t accept_operation::perform() noexcept {
+        // NOTE: The socket is the caller's, so rather than set O_NONBLOCK on it we accept as
+        // though it were set.
+        return internal::accept_socket(m_sockfd, m_addr, m_addrlen, MSG_DONTWAIT);
+    }
+
+    ssize_t connect_operation::perform() noexcept {
+        if (!m_started) {
+            m_started = true;
+            if (internal::connect_socket(m_sockfd, m_addr, m_addrlen, MSG_DONTWAIT) == 0) {
+                return 0;
+            }
+
+            if (errno == EINPROGRESS) {
+                errno = EAGAIN;
+            }
+            return -1;
+        }
+
+        if (internal::is_established(m_sockfd)) {
+            return 0;
+        }
+
+        errno = EAGAIN;
+        return -1;
+    }
+
+    ssize_t send_operation::perform() noexcept {
+        return rudp::send(m_sockfd, m_buf, m_len, MSG_DONTWAIT);
+    }
+
+    ssize_t recv_operation::perform() noexcept {
+        return rudp::recv(m_sockfd, m_buf, m_len, MSG_DONTWAIT);
+    }
+}  // namespace detail
+
+loop::loop() noexcept : m_epfd(rudp::epoll_create(1)) {}
+
+void loop::spawn(task<void> work) noexcept {
+    m_active++;
+    launch(std::move(work));
+}
+
+detail::detached loop::launch(task<void> work) noexcept {
+    co_await std::move(work);
+    m_active--;
+}
+
+int loop::run() noexcept {
+    if (!valid()) {
+        errno = EBADF;
+        return -1;
+    }
+
+    epoll_event events[64];
+
+    while (m_active > 0 && !std::exchange(m_stopping, false)) {
+        int nfds = rudp::epoll_wait(m_epfd, events, 64, -1);
+        if (nfds < 0) {
+            return -1;
+        }
+
+        for (int i = 0; i < nfds; i++) {
+            const int sockfd = events[i].data.fd;
+
+            // NOTE: Resuming a coroutine may park others and rehash m_waiters, so each direction
+            // looks the socket up afresh and is cleared before its waiter is resumed.
+            for (const bool writes : {false, true}) {
+                if (!(events[i].events & (writes ? EPOLLOUT : EPOLLIN))) {
+                    continue;
+                }
+
+                auto it = m_waiters.find(sockfd);
+                RUDP_ASSERT(it != m_waiters.end(), "A reported socket must have been parked.");
+
+                detail::operation *&parked = writes ? it->second.writer : it->second.reader;
+                if (parked == nullptr || !parked->attempt()) {
+                    continue;
+                }
+
+                std::coroutine_handle<> waiter = std::exchange(parked, nullptr)->waiter();
+                waiter.resume();
+            }
+        }
+    }
+
+    return 0;
+}
+
+void loop::park(int sockfd, bool writes, detail::operation *operation) noexcept {
+    auto [it, inserted] = m_waiters.try_emplace(sockfd, waiters{});
+
+    // NOTE: Edge-triggered, as an operation is always attempted before it parks; any readiness
+    // which arrives afterwards is a fresh notification, so none can be missed.
+    if (inserted) {
+        epoll_event event{.events = EPOLLIN | EPOLLOUT | EPOLLET, .data = {.fd = sockfd}};
+        [[maybe_unused]] int added = rudp::epoll_ctl(m_epfd, EPOLL_CTL_ADD, sockfd, &event);
+        RUDP_ASSERT(added == 0, "Registering a socket we have already operated on cannot fail.");
+    }
+
+    detail::operation *&parked = writes ? it->second.writer : it->second.reader;
+    RUDP_ASSERT(parked == nullptr, "Only one coroutine may wait on each direction of a socket.");
+    parked = operation;
+}
+
+}  // namespace rudp::async
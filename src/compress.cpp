@@ -0,0 +1,214 @@
+#include "internal/compress.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <span>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+namespace {
+    constexpr size_t MIN_MATCH = 4;
+    constexpr size_t HASH_BITS = 10;
+
+    // NOTE: As in LZ4, a block ends in literals; no match begins within MATCH_LIMIT bytes of its
+    // end, nor runs into its last LAST_LITERALS.
+    constexpr size_t MATCH_LIMIT = 12;
+    constexpr size_t LAST_LITERALS = 5;
+
+    // NOTE: Each run of misses this long widens the step, so that incompressible input is skimmed.
+    constexpr size_t SKIP_SHIFT = 5;
+
+    RUDP_STATIC_ASSERT(MAX_LZ_BLOCK <= 0xFFFF, "Positions and offsets are held in a u16.");
+
+    [[nodiscard]] u32 read32(const u8 *in) {
+        u32 value{};
+        std::memcpy(&value, in, sizeof(value));
+        return value;
+    }
+
+    [[nodiscard]] size_t hash(u32 sequence) {
+        return (sequence * 2654435761U) >> (32 - HASH_BITS);
+    }
+
+    // NOTE: A length past what the token holds continues in bytes of 255, ended by one below it.
+    [[nodiscard]] bool put_length(std::span<u8> output, size_t &op, size_t length) {
+        while (length >= 255) {
+            if (op == output.size()) {
+                return false;
+            }
+            output[op++] = 255;
+            length -= 255;
+        }
+
+        if (op == output.size()) {
+            return false;
+        }
+        output[op++] = static_cast<u8>(length);
+        return true;
+    }
+
+    [[nodiscard]] bool get_length(std::span<const u8> input, size_t &ip, size_t &length,
+                                  size_t limit) {
+        while (true) {
+            if (ip == input.size()) {
+                return false;
+            }
+
+            const u8 byte = input[ip++];
+            length += byte;
+            if (length > limit) {
+                return false;
+            }
+
+            if (byte != 255) {
+                return true;
+            }
+        }
+    }
+
+    // NOTE: A match_length of zero ends the block with its literals alone.
+    [[nodiscard]] bool put_sequence(std::span<u8> output, size_t &op,
+                                    std::span<const u8> literals, size_t offset,
+                                    size_t match_length) {
+        if (op == output.size()) {
+            return false;
+        }
+
+        const size_t token = op++;
+        const size_t literal_code = std::min<size_t>(literals.size(), 15);
+        const size_t match_code =
+            (match_length > 0) ? std::min<size_t>(match_length - MIN_MATCH, 15) : 0;
+        output[token] = static_cast<u8>((literal_code << 4) | match_code);
+
+        if (literal_code == 15 && !put_length(output, op, literals.size() - 15)) {
+            return false;
+        }
+
+        if (literals.size() > output.size() - op) {
+            return false;
+        }
+        std::memcpy(output.data() + op, literals.data(), literals.size());
+        op += literals.size();
+
+        if (match_length == 0) {
+            return true;
+        }
+
+        if (output.size() - op < 2) {
+            return false;
+        }
+        output[op++] = static_cast<u8>(offset);
+        output[op++] = static_cast<u8>(offset >> 8);
+
+        return match_code < 15 || put_length(output, op, match_length - MIN_MATCH - 15);
+    }
+}  // namespace
+
+size_t lz_compress(std::span<const u8> input, std::span<u8> output) noexcept {
+    RUDP_ASSERT(input.size() <= MAX_LZ_BLOCK, "A block is at most a segment's payload.");
+
+    const u8 *in = input.data();
+    size_t ip = 0;
+    size_t anchor = 0;
+    size_t op = 0;
+
+    if (input.size() > MATCH_LIMIT) {
+        std::array<u16, size_t{1} << HASH_BITS> table{};
+        const size_t limit = input.size() - MATCH_LIMIT;
+        size_t misses = 0;
+
+        while (ip < limit) {
+            const u32 sequence = read32(in + ip);
+            const size_t slot = hash(sequence);
+            const size_t candidate = table[slot];
+            table[slot] = static_cast<u16>(ip);
+
+            if (candidate >= ip || read32(in + candidate) != sequence) {
+                ip += 1 + (misses++ >> SKIP_SHIFT);
+                continue;
+            }
+
+            const size_t longest = input.size() - LAST_LITERALS - ip;
+            size_t length = MIN_MATCH;
+            while (length < longest && in[candidate + length] == in[ip + length]) {
+                length++;
+            }
+
+            if (!put_sequence(output, op, input.subspan(anchor, ip - anchor), ip - candidate,
+                              length)) {
+                return 0;
+            }
+
+            ip += length;
+            anchor = ip;
+            misses = 0;
+        }
+    }
+
+    if (!put_sequence(output, op, input.subspan(anchor), 0, 0)) {
+        return 0;
+    }
+
+    return op;
+}
+
+std::optional<size_t> lz_decompress(std::span<const u8> input, std::span<u8> output) noexcept {
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < input.size()) {
+        const u8 token = input[ip++];
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !get_length(input, ip, literals, output.size())) {
+            return std::nullopt;
+        }
+
+        if (literals > input.size() - ip || literals > output.size() - op) {
+            return std::nullopt;
+        }
+        std::memcpy(output.data() + op, input.data() + ip, literals);
+        ip += literals;
+        op += literals;
+
+        // NOTE: Only the last sequence goes without a match.
+        if (ip == input.size()) {
+            return op;
+        }
+
+        if (input.size() - ip < 2) {
+            return std::nullopt;
+        }
+        const size_t offset = size_t{input[ip]} | (size_t{input[ip + 1]} << 8);
+        ip += 2;
+
+        size_t length = token & 0x0F;
+        if (length == 15 && !get_length(input, ip, length, output.size())) {
+            return std::nullopt;
+        }
+        length += MIN_MATCH;
+
+        if (offset == 0 || offset > op || length > output.size() - op) {
+            return std::nullopt;
+        }
+
+        // NOTE: A match which overlaps its own output repeats a short run, so is copied bytewise.
+        if (offset >= length) {
+            std::memcpy(output.data() + op, output.data() + op - offset, length);
+        } else {
+            for (size_t i = 0; i < length; i++) {
+                output[op + i] = output[op - offset + i];
+            }
+        }
+        op += length;
+    }
+
+    return std::nullopt;
+}
+
+}  // namespace rudp::internal
@@ -3,20 +3,30 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <cerrno>
 #include <chrono>
 #include <condition_variable>
 #include <cstring>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "internal/assert.hpp"
 #include "internal/common.hpp"
+#include "internal/compress.hpp"
 #include "internal/event_loop.hpp"
 #include "internal/packet.hpp"
+#include "internal/shm.hpp"
 #include "internal/state.hpp"
 
 namespace rudp::internal {
@@ -25,6 +35,21 @@ namespace {
         return (first.sin_addr.s_addr == second.sin_addr.s_addr) &&
                (first.sin_port == second.sin_port);
     }
+
+    // NOTE: Wraps every 71 minutes, so compared by the sign of the difference.
+    [[nodiscard]] u32 to_timestamp(std::chrono::steady_clock::time_point at) {
+        return static_cast<u32>(
+            std::chrono::duration_cast<std::chrono::microseconds>(at.time_since_epoch()).count());
+    }
+
+    [[nodiscard]] bool before(u32 first, u32 second) {
+        return static_cast<s32>(first - second) < 0;
+    }
+
+    // NOTE: Below this a payload is sent as is, as there is too little in it to repeat itself.
+    constexpr size_t MIN_COMPRESS_BYTES = 64;
+    constexpr size_t COMPRESSED_OPTION_BYTES = 2 + sizeof(u16);
+    constexpr u32 MAX_COMPRESS_SKIP = 64;
 }  // namespace
 
 std::map<std::chrono::steady_clock::time_point, std::unique_ptr<connection>>
@@ -32,51 +57,135 @@ std::map<std::chrono::steady_clock::time_point, std::unique_ptr<connection>>
 
 void connection::handle_events() noexcept {
     assert_external_state(__PRETTY_FUNCTION__);
+    const state::kind initial_state = m_state.current();
+
+    // NOTE: The offer is only made once the active side has our SYNACK, so it completes the
+    // handshake on its own should the final ACK be lost.
+    if (m_state.current() == state::kind::syn_rcvd &&
+        m_shm_listenfd != constants::UNINITIALISED_FD && accept_shm_offer()) {
+        m_sent.clear();
+        m_state.transition(state::kind::established);
+        m_listener_established();
+    }
 
-    buffer_pending();
+    std::shared_ptr<const data_callback> on_data;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        on_data = m_on_data;
+    }
 
     bool received_data = false;
-    while (!m_received.empty() && m_acknum == m_received.begin()->first) {
-        auto it = m_received.begin();
-        const auto &[packet, peer] = it->second;
-        RUDP_ASSERT(packet.header.seqnum == m_received.begin()->first,
-                    "A received packet in m_received must have it's sequence number as it's key.");
-
-        if (packet.header.flags == (static_cast<u8>(flag::SYN) | static_cast<u8>(flag::ACK))) {
-            handle_synack(packet, peer);
-        }
+    bool buffered_data = false;
+    receive_pending(on_data.get(), &received_data, &buffered_data);
 
-        if (packet.header.flags & static_cast<u8>(flag::ACK)) {
-            handle_ack(packet);
+    u8 flags = m_state.derive_flags();
+    flags |= static_cast<u8>(flag::ACK) & -static_cast<u8>(received_data != 0);
+
+    if (m_shm_offered) {
+        flags |= static_cast<u8>(flag::SHM);
+        m_shm_offered = false;
+    }
+
+    if (flags != state::NO_FLAGS) {
+        send_control_packet(flags);
+    }
+
+    if (m_pending_transport) {
+        switch_transport();
+    }
+
+    if (buffered_data) {
+        m_cv.notify_one();
+    }
+
+    if (buffered_data || m_state.current() != initial_state) {
+        m_readiness->notify();
+    }
+}
+
+template <typename Take>
+bool connection::deliver(const packet_header &header, bool has_payload, Take &&take,
+                         const data_callback *on_data) noexcept {
+    std::unique_lock<std::mutex> lock(m_mtx);
+
+    bool buffered = deliver(lock, header, has_payload, std::forward<Take>(take), on_data);
+    buffered |= deliver_waiting(lock, header.stream, on_data);
+    return buffered;
+}
+
+bool connection::deliver_waiting(std::unique_lock<std::mutex> &lock, u16 id,
+                                 const data_callback *on_data) noexcept {
+    // NOTE: Past a gap, data is still delivered to any stream which the gap does not hold up. It
+    // stays in the reorder queue, without its payload, until it can be acknowledged in order.
+    if (m_state.current() != state::kind::established) {
+        return false;
+    }
+
+    bool buffered = false;
+    while (true) {
+        const stream *stream = find_stream(id);
+        received_packet *waiting = m_reordered.take_waiting(id, stream ? stream->delivered : 0);
+        if (waiting == nullptr) {
+            return buffered;
         }
 
-        if (!packet.data().empty()) {
-            std::lock_guard<std::mutex> lock(m_mtx);
-            recv_buffer.insert(recv_buffer.end(), packet.data().begin(), packet.data().end());
-            received_data = true;
+        buffered |= deliver(lock, waiting->header, waiting->filled,
+                            [this, waiting]() { return m_reordered.read(*waiting); }, on_data);
+    }
+}
+
+template <typename Take>
+bool connection::deliver(std::unique_lock<std::mutex> &lock, const packet_header &header,
+                         bool has_payload, Take &&take, const data_callback *on_data) noexcept {
+
+    // NOTE: A stream of our own exists from open_stream(), so the peer may only create its own,
+    // and only so many; data for any other stream is dropped.
+    auto it = m_streams.find(header.stream);
+    const bool created = (it == m_streams.end());
+    if (created) {
+        const bool peers = (header.stream % 2) != (m_next_stream % 2);
+        if (!peers || m_peer_streams == constants::MAX_PEER_STREAMS) {
+            return false;
         }
 
-        m_acknum += get_sequence_advance(packet);
-        m_received.erase(it);
+        it = m_streams.try_emplace(header.stream).first;
+        m_peer_streams++;
+        m_unaccepted.push_back(header.stream);
     }
+    stream &stream = it->second;
 
-    u8 flags = m_state.derive_flags();
-    flags |= static_cast<u8>(flag::ACK) & -static_cast<u8>(received_data != 0);
+    // NOTE: Either already delivered past a gap, or behind one on its own stream.
+    if (header.offset != stream.delivered) {
+        return created;
+    }
 
-    if (flags != state::NO_FLAGS) {
-        send_control_packet(flags);
+    stream.delivered += header.length;
+
+    // NOTE: An abandoned message, unless its payload arrived after all.
+    if (!has_payload) {
+        return created;
     }
 
-    if (received_data) {
-        m_cv.notify_one();
+    std::vector<u8> payload = take();
+    if (on_data != nullptr && header.stream == DEFAULT_STREAM) {
+        lock.unlock();
+        (*on_data)(std::as_bytes(std::span<const u8>(payload)));
+        lock.lock();
+        return created;
     }
+
+    const bool ends_record = m_opts.messages && (header.flags & static_cast<u8>(flag::EOR));
+    stream.recv_buffer.push(std::move(payload), ends_record);
+    return true;
 }
 
-void connection::buffer_pending() noexcept {
+void connection::receive_pending(const data_callback *on_data, bool *received_data,
+                                 bool *buffered_data) noexcept {
     while (true) {
         sockaddr_in peer_addr{};
+        arrival arrived{};
 
-        std::optional<packet> packet_opt = packet::recvfrom(m_fd, &peer_addr);
+        std::optional<packet> packet_opt = packet::recvfrom(*m_transport, &peer_addr, &arrived);
         if (!packet_opt.has_value()) {
             // TODO: packet::recvfrom() has a bad interface. It returns std::nullopt in the case of
             // a recvfrom() error, or a malformed packet (which should just be dropped). The
@@ -92,32 +201,150 @@ void connection::buffer_pending() noexcept {
             continue;
         }
 
-        packet packet = packet_opt.value();
-        if (packet.header.seqnum < m_acknum) {
+        packet &packet = packet_opt.value();
+
+        // NOTE: Before anything reads the payload, the FEC decoder included, since the sender
+        // computed its parity over the original.
+        if (!decompress(packet)) {
             continue;
         }
 
-        // NOTE: We can have an existing entry in the case of an empty ACK. For example, following
-        // the handshake, ACK(SEQ=1) then DATA(SEQ=1). In this case, we want the resulting stored
-        // packet to have; the data, the ACK, and the maximum acknum of the duplicates.
-        auto existing = m_received.find(packet.header.seqnum);
-        if (existing != m_received.end()) {
-            auto stored = existing->second.packet;
+        if (packet.header.version >= COMPACT_VERSION) {
+            m_layout = layout::compact;
+        }
 
-            stored.header.flags |= packet.header.flags;
-            stored.header.acknum = std::max(stored.header.acknum, packet.header.acknum);
+        // NOTE: Capabilities are offered in the SYNACK, as in the SYN, and what both sides offer is
+        // enabled.
+        if (packet.header.flags & static_cast<u8>(flag::SYN)) {
+            negotiate(packet);
+            read_shm_nonce(packet);
+        }
 
-            if (!packet.data().empty() && stored.data().empty()) {
-                stored = std::move(packet);
+        sample_queueing_delay(arrived.at);
+        if (arrived.codepoint == ecn::ce) {
+            m_ce_received++;
+        }
+
+        if (packet.header.flags & static_cast<u8>(flag::REPAIR)) {
+            if (std::optional<class packet> rebuilt = m_fec_decoder.repair(packet)) {
+                handle_sequenced(rebuilt.value(), peer_addr, on_data, received_data,
+                                 buffered_data);
             }
-        } else {
-            m_received.insert({packet.header.seqnum, {packet, peer_addr}});
+            continue;
+        }
+
+        handle_timestamp(packet, arrived.at);
+        handle_ecn_echo(packet);
+
+        // NOTE: The segment counts towards its group before its payload is handed on.
+        std::optional<class packet> rebuilt = m_fec_decoder.add(packet);
+        handle_sequenced(packet, peer_addr, on_data, received_data, buffered_data);
+        if (rebuilt.has_value()) {
+            handle_sequenced(rebuilt.value(), peer_addr, on_data, received_data, buffered_data);
+        }
+    }
+}
+
+void connection::handle_sequenced(class packet &packet, const sockaddr_in &peer,
+                                  const data_callback *on_data, bool *received_data,
+                                  bool *buffered_data) noexcept {
+    if (packet.header.seqnum < m_acknum) {
+        return;
+    }
+
+    if (handle_predicted(packet, on_data, received_data, buffered_data)) {
+        return;
+    }
+
+    // NOTE: Anything past a gap waits in the reorder queue, whereas the packet we expect next is
+    // handled as it arrives, followed by whatever it lets through from the queue. A bare ACK does
+    // not advance m_acknum, so the data sharing its sequence number still follows.
+    if (packet.header.seqnum > m_acknum) {
+        if (m_reordered.insert(packet, peer, m_acknum)) {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            *buffered_data |= deliver_waiting(lock, packet.header.stream, on_data);
         }
+        return;
+    }
+
+    const bool has_payload = !packet.data().empty();
+    handle_in_order(packet.header, peer, has_payload, [&packet]() { return packet.take_data(); },
+                    on_data, received_data, buffered_data);
+
+    // NOTE: A packet whose sequence number another covered is passed over by release().
+    while (std::optional<received_packet> next = m_reordered.pop(m_acknum)) {
+        handle_in_order(next->header, next->peer, next->filled && !next->delivered,
+                        [this, &next]() { return m_reordered.read(*next); }, on_data,
+                        received_data, buffered_data);
+    }
+    m_reordered.release(m_acknum);
+}
+
+bool connection::handle_predicted(packet &packet, const data_callback *on_data,
+                                  bool *received_data, bool *buffered_data) noexcept {
+    const packet_header &header = packet.header;
+    if (header.seqnum != m_acknum || m_state.current() != state::kind::established) {
+        return false;
+    }
+
+    // NOTE: A bare ACK neither advances m_acknum nor carries anything to deliver.
+    if (header.flags == static_cast<u8>(flag::ACK) && header.length == 0) {
+        handle_ack(header);
+        return true;
+    }
+
+    // NOTE: Data carries no flags of its own bar EOR, so anything else is left to the slow path,
+    // as is data which would release packets held past a gap.
+    if ((header.flags & ~static_cast<u8>(flag::EOR)) != 0 || packet.data().empty() ||
+        !m_reordered.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    // NOTE: The callback is invoked without the lock, and a new stream must be queued for
+    // accept_stream(), both of which deliver() takes care of.
+    stream *stream = find_stream(header.stream);
+    if (stream == nullptr || header.offset != stream->delivered ||
+        (on_data != nullptr && header.stream == DEFAULT_STREAM)) {
+        return false;
     }
+
+    m_acknum += header.length;
+    stream->delivered += header.length;
+
+    const bool ends_record = m_opts.messages && (header.flags & static_cast<u8>(flag::EOR));
+    stream->recv_buffer.push(packet.take_data(), ends_record);
+
+    *received_data = true;
+    *buffered_data = true;
+    return true;
 }
 
-void connection::handle_synack(const packet &packet, const sockaddr_in &peer) noexcept {
-    RUDP_ASSERT(packet.header.seqnum == m_acknum,
+template <typename Take>
+void connection::handle_in_order(const packet_header &header, const sockaddr_in &peer,
+                                 bool has_payload, Take &&take, const data_callback *on_data,
+                                 bool *received_data, bool *buffered_data) noexcept {
+    constexpr u8 synack = static_cast<u8>(flag::SYN) | static_cast<u8>(flag::ACK);
+    if ((header.flags & synack) == synack) {
+        handle_synack(header, peer);
+    }
+
+    if (header.flags & static_cast<u8>(flag::ACK)) {
+        handle_ack(header);
+    }
+
+    m_acknum += get_sequence_advance(header);
+
+    // NOTE: The payload may already have been delivered past a gap.
+    if (header.length > 0) {
+        *buffered_data |= deliver(header, has_payload, std::forward<Take>(take), on_data);
+        *received_data = true;
+    }
+}
+
+void connection::handle_synack(const packet_header &header, const sockaddr_in &peer) noexcept {
+    RUDP_ASSERT(header.seqnum == m_acknum,
                 "m_acknum must be in sync with the current packet being handled.");
 
     // NOTE: We expect a SYNACK in response to our SYN (active_open()).
@@ -130,24 +357,132 @@ void connection::handle_synack(const packet &packet, const sockaddr_in &peer) no
 
         // TODO: on_first_packet()
         m_peer = peer;
+
+        // NOTE: The offer must be sent before our final ACK reaches the passive side, since that
+        // ACK is what tells it to collect the offer.
+        if (m_opts.shm && (header.flags & static_cast<u8>(flag::SHM)) && m_shm_nonce.has_value()) {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_pending_transport = shm::offer(peer, m_shm_nonce.value());
+            m_shm_offered = (m_pending_transport != nullptr);
+        }
+
         m_state.transition(state::kind::established);
         m_cv.notify_one();
     }
 }
 
-void connection::handle_ack(const packet &packet) noexcept {
-    RUDP_ASSERT(packet.header.seqnum == m_acknum,
+void connection::switch_transport() noexcept {
+    auto [err, event_loop] = event_loop::instance();
+    RUDP_ASSERT(err == event_loop::result::error::none && event_loop != nullptr,
+                "assert_external_state() guarantees an event loop.");
+    event_loop->assert_event_thread(__PRETTY_FUNCTION__);
+
+    if (!event_loop->add_handler(handler_type::connection, m_pending_transport->fd(),
+                                 [this]() { handle_events(); })) {
+        RUDP_ASSERT(false, "Failed to register the new transport; the peer has already switched.");
+    }
+
+    // NOTE: Anything still queued on the old transport is dropped along with it.
+    event_loop->remove_handler(handler_type::connection, m_transport->fd());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_transport = std::move(m_pending_transport);
+        m_fd = m_transport->fd();
+        m_shm_active = true;
+    }
+
+    m_cv.notify_one();
+}
+
+bool connection::accept_shm_offer() noexcept {
+    std::shared_ptr<class transport> accepted =
+        shm::accept(m_shm_listenfd, m_peer, m_shm_nonce.value());
+    if (!accepted && errno == EAGAIN) {
+        return false;
+    }
+
+    close_shm_listener();
+    RUDP_ASSERT(accepted != nullptr,
+                "The active side has switched to an offer which we could not accept; you must "
+                "decide how to handle this.");
+
+    m_pending_transport = std::move(accepted);
+    switch_transport();
+    return true;
+}
+
+void connection::close_shm_listener() noexcept {
+    auto [err, event_loop] = event_loop::instance();
+    RUDP_ASSERT(err == event_loop::result::error::none && event_loop != nullptr,
+                "assert_external_state() guarantees an event loop.");
+
+    event_loop->remove_handler(handler_type::connection, m_shm_listenfd);
+    close(m_shm_listenfd);
+    m_shm_listenfd = constants::UNINITIALISED_FD;
+}
+
+void connection::handle_ack(const packet_header &header) noexcept {
+    RUDP_ASSERT(header.seqnum == m_acknum,
                 "m_acknum must be in sync with the current packet being handled.");
     RUDP_ASSERT(!equals(m_peer, constants::UNINITIALISED_PEER),
                 "A connection must have processed a valid SYN(ACK) from our peer prior to "
                 "processing an individual ACK.");
 
-    while (!m_sent.empty() && m_sent.begin()->first < packet.header.acknum) {
-        const auto &[sent_packet, _, __] = m_sent.begin()->second;
-        RUDP_ASSERT(sent_packet.header.seqnum == m_sent.begin()->first,
-                    "A sent packet in m_sent must have it's sequence number as it's key.");
+    // NOTE: A data packet's bytes are only freed once acknowledged, as until then a
+    // retransmission may need to view them again.
+    size_t newly_acked = 0;
+    std::optional<std::chrono::steady_clock::time_point> newest_sent_at;
+    bool ambiguous = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_sent.acknowledge(header.acknum, [&](const sent_packet &acked) {
+            newly_acked++;
+            newest_sent_at = acked.sent_at;
+            ambiguous |= (acked.retransmits > 0);
+            if (acked.header.length == 0) {
+                return;
+            }
+
+            stream *stream = find_stream(acked.header.stream);
+            RUDP_ASSERT(stream != nullptr, "A stream outlives the packets sent on it.");
+            stream->send_buffer.release(acked.position + acked.header.length);
+        });
+    }
+
+    // NOTE: Without timestamps the round trip is timed as in Karn's algorithm, from the newest
+    // packet an ACK covers, and only when nothing it covers was ever retransmitted, since then we
+    // cannot tell which transmission it answers. Otherwise each loss would leave the timeout
+    // backed off for good.
+    if (!(m_capabilities & CAPABILITY_TIMESTAMPS) && newest_sent_at.has_value() && !ambiguous) {
+        sample_rtt(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - newest_sent_at.value()));
+    }
+
+    const size_t cwnd = m_cwnd.load(std::memory_order_relaxed);
+    m_cwnd_acked = (cwnd < constants::MAX_INFLIGHT_PACKETS) ? m_cwnd_acked + newly_acked : 0;
+    if (m_cwnd_acked >= cwnd) {
+        m_cwnd_acked -= cwnd;
+        m_cwnd.store(cwnd + 1, std::memory_order_relaxed);
+    }
+
+    // NOTE: Checked without the lock first, as only we modify the queue and it is usually empty.
+    if (!m_zc_unacked.empty()) {
+        bool completed = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            while (!m_zc_unacked.empty() && m_zc_unacked.front().acked_by <= header.acknum) {
+                m_zc_completed = m_zc_unacked.front().id + 1;
+                m_zc_unacked.pop_front();
+                completed = true;
+            }
+        }
 
-        m_sent.erase(sent_packet.header.seqnum);
+        // NOTE: The user thread may be blocked in wait_for_zc_completion(), or waiting on an epoll.
+        if (completed) {
+            m_cv.notify_one();
+            m_readiness->notify();
+        }
     }
 
     // NOTE: We expect an 'ACK' in response to our SYNACK (passive_open()).
@@ -155,6 +490,16 @@ void connection::handle_ack(const packet &packet) noexcept {
         RUDP_ASSERT(m_listener_established,
                     "A callback must be registered in the passive open case.");
 
+        // NOTE: An offer is always queued before the ACK which confirms it is sent.
+        if (m_shm_listenfd != constants::UNINITIALISED_FD) {
+            if (header.flags & static_cast<u8>(flag::SHM)) {
+                [[maybe_unused]] bool accepted = accept_shm_offer();
+                RUDP_ASSERT(accepted, "The active side confirmed an offer which was never sent.");
+            } else {
+                close_shm_listener();
+            }
+        }
+
         m_state.transition(state::kind::established);
         m_listener_established();
     }
@@ -175,11 +520,11 @@ bool connection::send_control_packet(u8 flags, std::optional<sockaddr_in> to) no
     return send_packet(packet, to);
 }
 
-bool connection::send_packet(const packet &packet, std::optional<sockaddr_in> to) noexcept {
+bool connection::send_packet(packet &packet, std::optional<sockaddr_in> to) noexcept {
     RUDP_ASSERT(m_state.current() != state::kind::created,
                 "A state transition must preceed any sending of packets.");
-    RUDP_ASSERT(!m_sent.contains(m_seqnum),
-                "A packet must not be sent twice through send_store_packet().");
+    RUDP_ASSERT(m_sent.find(packet.header.seqnum) == nullptr,
+                "A packet must not be sent twice through send_packet().");
 
     // clang-format off
     bool needs_ack = 
@@ -188,21 +533,286 @@ bool connection::send_packet(const packet &packet, std::optional<sockaddr_in> to
         !packet.data().empty();
     // clang-format on 
 
-    if (needs_ack) {
-        m_sent[packet.header.seqnum] = {
-            .packet = packet,
+    const sockaddr_in &peer = (to.has_value()) ? to.value() : m_peer;
+    bool sent = (transmit(packet, &peer) > 0);
+
+    // NOTE: Data which fails to send stays on the send buffer and is retried by process_sends(), so
+    // only control packets are tracked for retransmission regardless of the outcome.
+    if (needs_ack && (sent || packet.data().empty())) {
+        m_sent.push({
+            .header = packet.header,
+            .position = 0,
             .sent_at = std::chrono::steady_clock::now(),
             .retransmits = 0,
+            .policy = {},
+        });
+    }
+
+    return sent;
+}
+
+ssize_t connection::transmit(packet &packet, const sockaddr_in *to) noexcept {
+    // NOTE: Options are added afresh on every transmission, retransmissions included.
+    const bool syn = packet.header.flags & static_cast<u8>(flag::SYN);
+    if (syn && SUPPORTED_CAPABILITIES != 0) {
+        const u32 net_capabilities = htonl(SUPPORTED_CAPABILITIES);
+        [[maybe_unused]] const bool added =
+            packet.add_option(option::capabilities,
+                              std::span(reinterpret_cast<const u8 *>(&net_capabilities),
+                                        sizeof(net_capabilities)));
+        RUDP_ASSERT(added, "The capabilities always fit an empty options area.");
+    }
+
+    // NOTE: Offered in the SYN ahead of negotiation, so the handshake itself yields a sample.
+    if ((m_capabilities & CAPABILITY_TIMESTAMPS) ||
+        (syn && (SUPPORTED_CAPABILITIES & CAPABILITY_TIMESTAMPS))) {
+        const std::array<u32, 2> net_timestamps{
+            htonl(to_timestamp(std::chrono::steady_clock::now())),
+            htonl(m_ts_recent),
         };
+        [[maybe_unused]] const bool added =
+            packet.add_option(option::timestamp,
+                              std::span(reinterpret_cast<const u8 *>(net_timestamps.data()),
+                                        sizeof(net_timestamps)));
+        RUDP_ASSERT(added, "The timestamps always fit alongside the capabilities.");
     }
 
-    const sockaddr_in &peer = (to.has_value()) ? to.value() : m_peer;
-    return (packet::sendto(m_fd, packet, &peer) > 0);
+    // NOTE: A SYNACK offering shared memory names the nonce which the offer must hand back.
+    constexpr u8 synack = static_cast<u8>(flag::SYN) | static_cast<u8>(flag::ACK);
+    if ((packet.header.flags & synack) == synack &&
+        (packet.header.flags & static_cast<u8>(flag::SHM)) && m_shm_nonce.has_value()) {
+        const u64 nonce = m_shm_nonce.value();
+        [[maybe_unused]] const bool added = packet.add_option(
+            option::shm_nonce, std::span(reinterpret_cast<const u8 *>(&nonce), sizeof(nonce)));
+        RUDP_ASSERT(added, "The nonce always fits alongside the timestamps.");
+    }
+
+    // NOTE: Only data is sent ECN-capable, as a mark on a control packet would have nothing to
+    // slow down.
+    ecn codepoint = ecn::not_ect;
+    if (m_capabilities & CAPABILITY_ECN) {
+        codepoint = (packet.header.length > 0) ? ecn::ect0 : ecn::not_ect;
+
+        if ((packet.header.flags & static_cast<u8>(flag::ACK)) && m_ce_received > 0) {
+            const u32 net_count = htonl(m_ce_received);
+            [[maybe_unused]] const bool added = packet.add_option(
+                option::ecn_echo,
+                std::span(reinterpret_cast<const u8 *>(&net_count), sizeof(net_count)));
+            RUDP_ASSERT(added, "The echo always fits alongside the timestamps.");
+        }
+    }
+
+    // NOTE: Compressed on the way out, so that what is tracked for retransmission keeps its
+    // original length, and a retransmission is compressed afresh.
+    if (compresses(packet)) {
+        std::array<u8, constants::MAX_DATA_BYTES> block;
+        class packet compressed = packet;
+        if (compress(compressed, block)) {
+            return packet::sendto(*m_transport, compressed, to, m_layout, codepoint);
+        }
+    }
+
+    return packet::sendto(*m_transport, packet, to, m_layout, codepoint);
+}
+
+bool connection::compresses(const packet &packet) const noexcept {
+    // NOTE: A repair's parity is seldom worth the attempt.
+    return m_opts.compression && (m_capabilities & CAPABILITY_COMPRESSION) &&
+           packet.data().size() >= MIN_COMPRESS_BYTES &&
+           !(packet.header.flags & static_cast<u8>(flag::REPAIR));
+}
+
+bool connection::compress(class packet &packet, std::span<u8> block) noexcept {
+    if (m_compress_skip > 0) {
+        m_compress_skip--;
+        return false;
+    }
+
+    // NOTE: Only a payload which saves more than the option costs is worth sending compressed.
+    const std::span<const u8> payload = packet.data();
+    const size_t size = lz_compress(payload, block.first(payload.size() - COMPRESSED_OPTION_BYTES));
+    if (size == 0) {
+        m_compress_backoff = std::clamp<u32>(2 * m_compress_backoff, 1, MAX_COMPRESS_SKIP);
+        m_compress_skip = m_compress_backoff;
+        return false;
+    }
+    m_compress_backoff = 0;
+
+    const u16 net_length = htons(static_cast<u16>(payload.size()));
+    [[maybe_unused]] const bool added = packet.add_option(
+        option::compressed,
+        std::span(reinterpret_cast<const u8 *>(&net_length), sizeof(net_length)));
+    RUDP_ASSERT(added, "The original length always fits alongside a segment's other options.");
+
+    packet.header.length = static_cast<u16>(size);
+    packet.view_data(block.first(size), nullptr);
+    return true;
+}
+
+bool connection::decompress(class packet &packet) noexcept {
+    std::optional<std::span<const u8>> found = packet.find_option(option::compressed);
+    if (!found.has_value()) {
+        return true;
+    }
+
+    u16 net_length = 0;
+    if (found->size() != sizeof(net_length)) {
+        return false;
+    }
+    std::memcpy(&net_length, found->data(), sizeof(net_length));
+
+    const u16 length = ntohs(net_length);
+    if (length == 0 || length > MAX_LZ_BLOCK) {
+        return false;
+    }
+
+    // NOTE: Decompressed into a payload of its own, which is then moved into the receive buffer
+    // whole.
+    std::vector<u8> original(length);
+    const std::optional<size_t> size = lz_decompress(packet.data(), original);
+    if (size != length) {
+        return false;
+    }
+
+    packet.header.length = length;
+    packet.assign_data(std::move(original));
+    return true;
 }
 
-u32 connection::get_sequence_advance(const packet& packet) noexcept {
-    u32 advance = packet.header.flags & static_cast<u8>(flag::SYN);
-    advance += packet.header.length;
+void connection::negotiate(const packet &packet) noexcept {
+    std::optional<std::span<const u8>> offered = packet.find_option(option::capabilities);
+
+    u32 net_capabilities = 0;
+    if (offered.has_value() && offered->size() == sizeof(net_capabilities)) {
+        std::memcpy(&net_capabilities, offered->data(), sizeof(net_capabilities));
+    }
+
+    m_capabilities = SUPPORTED_CAPABILITIES & ntohl(net_capabilities);
+}
+
+void connection::read_shm_nonce(const packet &packet) noexcept {
+    constexpr u8 synack = static_cast<u8>(flag::SYN) | static_cast<u8>(flag::ACK);
+    if ((packet.header.flags & synack) != synack) {
+        return;
+    }
+
+    // NOTE: Only ever compared with itself, so it is left in whatever order the peer drew it.
+    std::optional<std::span<const u8>> option = packet.find_option(option::shm_nonce);
+    u64 nonce = 0;
+    if (option.has_value() && option->size() == sizeof(nonce)) {
+        std::memcpy(&nonce, option->data(), sizeof(nonce));
+        m_shm_nonce = nonce;
+    }
+}
+
+void connection::handle_timestamp(const packet &packet,
+                                  std::chrono::steady_clock::time_point arrived) noexcept {
+    std::optional<std::span<const u8>> option = packet.find_option(option::timestamp);
+    if (!option.has_value() || option->size() != 2 * sizeof(u32)) {
+        return;
+    }
+
+    std::array<u32, 2> net_timestamps{};
+    std::memcpy(net_timestamps.data(), option->data(), sizeof(net_timestamps));
+    const u32 value = ntohl(net_timestamps[0]);
+    const u32 echo = ntohl(net_timestamps[1]);
+
+    // NOTE: As in RFC 7323, the value to echo comes from the latest packet which is not past a
+    // gap, so that a delayed ACK does not understate the round trip. The SYN's is taken as is,
+    // since there is nothing yet to compare it with.
+    const packet_header &header = packet.header;
+    const bool syn = header.flags & static_cast<u8>(flag::SYN);
+    if (syn || (header.seqnum <= m_acknum && !before(value, m_ts_recent))) {
+        m_ts_recent = value;
+    }
+
+    // NOTE: Only an ACK which covers something new says when that was sent. An echo of zero is
+    // what the peer sends before it has heard from us.
+    if (!(header.flags & static_cast<u8>(flag::ACK)) || echo == 0 || m_sent.empty() ||
+        header.acknum <= m_sent.front().header.seqnum) {
+        return;
+    }
+
+    // NOTE: Measured to when the ACK arrived rather than when we got to it, so that a busy event
+    // thread does not pass for a slow path.
+    const std::chrono::microseconds rtt(to_timestamp(arrived) - echo);
+    sample_rtt(rtt);
+
+    // NOTE: Eifel detection, RFC 3522: the oldest outstanding packet was retransmitted, yet the
+    // ACK covering it echoes a time from before then, so the original arrived after all. As in
+    // RFC 4015 the estimate is reseeded from the sample, so that a path whose delay has jumped
+    // does not time out again straight away.
+    const sent_packet &oldest = m_sent.front();
+    if (oldest.retransmits > 0 && before(echo, to_timestamp(oldest.sent_at))) {
+        m_srtt = std::max(m_srtt.value(), rtt);
+        m_rttvar = std::max(m_rttvar, rtt / 2);
+        m_rto = std::clamp<std::chrono::microseconds>(m_srtt.value() + 4 * m_rttvar,
+                                                      constants::MIN_RETRANSMIT_TIME,
+                                                      constants::MAX_RETRANSMIT_TIME);
+    }
+}
+
+void connection::sample_rtt(std::chrono::microseconds rtt) noexcept {
+    if (!m_srtt.has_value()) {
+        m_srtt = rtt;
+        m_rttvar = rtt / 2;
+    } else {
+        const std::chrono::microseconds error = (m_srtt.value() > rtt) ? m_srtt.value() - rtt
+                                                                       : rtt - m_srtt.value();
+        m_rttvar = (3 * m_rttvar + error) / 4;
+        m_srtt = (7 * m_srtt.value() + rtt) / 8;
+    }
+
+    // NOTE: A fresh sample also ends any backoff.
+    m_rto = std::clamp<std::chrono::microseconds>(m_srtt.value() + 4 * m_rttvar,
+                                                  constants::MIN_RETRANSMIT_TIME,
+                                                  constants::MAX_RETRANSMIT_TIME);
+}
+
+void connection::sample_queueing_delay(std::chrono::steady_clock::time_point arrived) noexcept {
+    const auto queued = std::max(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now() - arrived),
+                                 std::chrono::microseconds::zero());
+
+    const u64 smoothed = m_queueing_delay.load(std::memory_order_relaxed);
+    m_queueing_delay.store((7 * smoothed + static_cast<u64>(queued.count())) / 8,
+                           std::memory_order_relaxed);
+}
+
+void connection::handle_ecn_echo(const packet &packet) noexcept {
+    if (!(packet.header.flags & static_cast<u8>(flag::ACK))) {
+        return;
+    }
+
+    std::optional<std::span<const u8>> echo = packet.find_option(option::ecn_echo);
+    if (!echo.has_value() || echo->size() != sizeof(u32)) {
+        return;
+    }
+
+    u32 net_count = 0;
+    std::memcpy(&net_count, echo->data(), sizeof(net_count));
+    const u32 count = ntohl(net_count);
+
+    // NOTE: A reordered ACK carries a count we have already seen.
+    if (!before(m_ce_echoed, count)) {
+        return;
+    }
+    m_ce_echoed = count;
+
+    // NOTE: Marks on the rest of the window were made by the same congestion.
+    if (packet.header.acknum < m_recover) {
+        return;
+    }
+
+    const size_t cwnd = m_cwnd.load(std::memory_order_relaxed);
+    m_cwnd.store(std::max(cwnd / 2, constants::MIN_INFLIGHT_PACKETS), std::memory_order_relaxed);
+    m_cwnd_acked = 0;
+    m_recover = m_seqnum;
+}
+
+u32 connection::get_sequence_advance(const packet_header &header) noexcept {
+    u32 advance = header.flags & static_cast<u8>(flag::SYN);
+    advance += header.length;
 
     return advance;
 }
@@ -215,58 +825,210 @@ void connection::process_sends() noexcept {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(m_mtx);
+    std::unique_lock<std::mutex> lock(m_mtx);
+    bool freed = false;
+
+    // NOTE: A packet from each stream with data in turn, so that one stream's backlog cannot
+    // starve the others of the window.
+    bool blocked = false;
+    bool sending = true;
+    while (sending && !blocked) {
+        sending = false;
+
+        for (auto &[id, stream] : m_streams) {
+            if (stream.send_buffer.empty()) {
+                continue;
+            }
 
-    while (!send_buffer.empty()) {
-        const u16 to_send = static_cast<u16>(
-            std::min(static_cast<size_t>(constants::MAX_DATA_BYTES), send_buffer.size()));
+            if (m_sent.size() >= m_cwnd.load(std::memory_order_relaxed)) {
+                blocked = true;
+                break;
+            }
 
-        packet packet(packet_header{
-            .seqnum = m_seqnum,
-            .acknum = m_acknum,
-            .length = to_send,
-        });
+            const size_t buffered = stream.send_buffer.size();
+            if (!send_segment(id, stream)) {
+                blocked = true;
+                break;
+            }
 
-        auto it = send_buffer.begin();
-        for (size_t i = 0; i < to_send; i++) {
-            packet.push_data(*it);
-            ++it;
+            freed |= stream.send_buffer.size() < buffered;
+            sending = true;
         }
+    }
 
-        if (!send_packet(packet)) {
-            if (errno == ECONNRESET) {
-                RUDP_ASSERT(false, "Connection reset; you must decide how to handle this.");
-            }
+    // NOTE: A partial group is repaired as it stands once it has waited half a timeout, so that
+    // the repair still beats a retransmission of the tail of a burst, where a loss costs the most.
+    // Repairing whenever the buffer drained instead cost small messages a packet apiece. A group
+    // whose every segment has since been acknowledged needs no repair, and is closed without one.
+    if (m_fec_encoder.size() > 0 && std::chrono::steady_clock::now() - m_fec_opened >= m_rto / 2) {
+        if (m_sent.empty()) {
+            static_cast<void>(m_fec_encoder.repair(m_seqnum, m_acknum));
+        } else {
+            send_repair();
+        }
+    }
 
-            RUDP_ASSERT(
-                errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOMEM,
-                "sendto() can only fail due to non-blocking or the environment, but we got %s.",
-                strerror(errno));
-            break;
+    // NOTE: The user thread may be blocked in wait_for_send_space(), or waiting on an epoll.
+    if (freed) {
+        lock.unlock();
+        m_cv.notify_one();
+        m_readiness->notify();
+    }
+}
+
+bool connection::send_segment(u16 id, stream &stream) noexcept {
+    send_queue::slice slice = stream.send_buffer.front(constants::MAX_DATA_BYTES);
+    const u16 to_send = static_cast<u16>(slice.data.size());
+
+    // NOTE: A message which expires before it is ever sent takes up no sequence space, so it can
+    // be dropped without the peer knowing.
+    const std::optional<std::chrono::steady_clock::time_point> &deadline = slice.policy.deadline;
+    if (deadline.has_value() && std::chrono::steady_clock::now() >= deadline.value()) {
+        stream.send_buffer.discard(to_send);
+        return true;
+    }
+
+    packet packet(packet_header{
+        .flags = slice.ends_record ? static_cast<u8>(flag::EOR) : state::NO_FLAGS,
+        .seqnum = m_seqnum,
+        .acknum = m_acknum,
+        .length = to_send,
+        .stream = id,
+        .offset = stream.sent,
+    });
+    packet.view_data(slice.data, nullptr);
+
+    const bool repairable = sends_repairs();
+    if (repairable) {
+        m_fec_encoder.tag(packet);
+    }
+
+    if (!send_packet(packet)) {
+        if (errno == ECONNRESET) {
+            RUDP_ASSERT(false, "Connection reset; you must decide how to handle this.");
+        }
+
+        RUDP_ASSERT(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOMEM,
+                    "sendto() can only fail due to non-blocking or the environment, but we got %s.",
+                    strerror(errno));
+        return false;
+    }
+
+    sent_packet &sent = m_sent.back();
+    RUDP_ASSERT(sent.header.seqnum == m_seqnum, "A sent segment is pushed last.");
+    sent.position = slice.position;
+
+    if (repairable) {
+        if (m_fec_encoder.size() == 0) {
+            m_fec_opened = std::chrono::steady_clock::now();
+        }
+
+        m_fec_encoder.add(packet.header, slice.data);
+        if (m_fec_encoder.size() == m_opts.fec_group) {
+            send_repair();
         }
+    }
+
+    if (slice.policy.partial()) {
+        sent.policy = slice.policy;
+
+        // NOTE: An unreliable message is followed straight away by the marker which abandons it,
+        // so that losing it never holds up its stream.
+        if (slice.policy.max_retransmits == 0) {
+            abandon(sent);
+        }
+    }
+
+    stream.send_buffer.pop(to_send);
+    stream.sent += to_send;
+    m_seqnum += to_send;
 
-        send_buffer.erase(send_buffer.begin(), send_buffer.begin() + to_send);
-        m_seqnum += to_send;
+    if (slice.completes.has_value()) {
+        m_zc_unacked.push_back({.id = slice.completes.value(), .acked_by = m_seqnum});
     }
+
+    return true;
+}
+
+bool connection::sends_repairs() const noexcept {
+    return m_opts.fec_group > 0 && (m_capabilities & CAPABILITY_FEC);
+}
+
+void connection::send_repair() noexcept {
+    // NOTE: A repair is never retransmitted, as the segments it covers are anyway.
+    packet repair = m_fec_encoder.repair(m_seqnum, m_acknum);
+    transmit(repair, &m_peer);
+}
+
+void connection::abandon(sent_packet &sent) noexcept {
+    RUDP_ASSERT(sent.policy.partial(), "Only a partially reliable message may be abandoned.");
+
+    // NOTE: The marker keeps the segment's sequence space and stream offset, which the peer skips
+    // past, and is itself retransmitted until acknowledged.
+    sent.header.flags |= static_cast<u8>(flag::SKIP);
+    sent.policy = {};
+    sent.retransmits = 0;
+    sent.sent_at = std::chrono::steady_clock::now();
+
+    packet marker(sent.header);
+    transmit(marker, &m_peer);
 }
 
 void connection::retransmit() noexcept {
-    for (auto &[_, sent_packet] : m_sent) {
+    const auto now = std::chrono::steady_clock::now();
+
+    bool retransmitted = false;
+    m_sent.for_each([this, now, &retransmitted](sent_packet &sent_packet) {
+        const bool due = now - sent_packet.sent_at > m_rto;
+
+        // NOTE: A deadline is checked on every pass, rather than only when a retransmission is
+        // due, so that an expired message stops holding up its stream as soon as possible.
+        const reliability &policy = sent_packet.policy;
+        const bool expired = policy.deadline.has_value() && now >= policy.deadline.value();
+        const bool exhausted = due && policy.max_retransmits.has_value() &&
+                               sent_packet.retransmits >= policy.max_retransmits.value();
+        if (expired || exhausted) {
+            abandon(sent_packet);
+            return;
+        }
+
         if (sent_packet.retransmits == constants::MAX_RETRANSMITS) {
             RUDP_ASSERT(false, "Max retransmits reached; you must decide how to handle this.");
         }
 
-        auto now = std::chrono::steady_clock::now();
-        if (now - sent_packet.sent_at > constants::RETRANSMIT_TIME) {
+        if (due) {
             sent_packet.retransmits++;
             sent_packet.sent_at = now;
 
-            packet::sendto(m_fd, sent_packet.packet, &m_peer);
+            resend(sent_packet);
+            retransmitted = true;
         }
+    });
+
+    // NOTE: Once per pass, however many packets went, as they most likely share the one cause.
+    if (retransmitted) {
+        m_rto = std::min<std::chrono::microseconds>(2 * m_rto, constants::MAX_RETRANSMIT_TIME);
+    }
+}
+
+void connection::resend(const sent_packet &sent) noexcept {
+    packet packet(sent.header);
+
+    // NOTE: A marker carries no payload, and neither does a control packet.
+    std::unique_lock<std::mutex> lock(m_mtx, std::defer_lock);
+    if (sent.header.length > 0 && !(sent.header.flags & static_cast<u8>(flag::SKIP))) {
+        lock.lock();
+        stream *stream = find_stream(sent.header.stream);
+        RUDP_ASSERT(stream != nullptr, "A stream outlives the packets sent on it.");
+        packet.view_data(stream->send_buffer.view(sent.position, sent.header.length), nullptr);
     }
+
+    const bool synced = !equals(m_peer, constants::UNINITIALISED_PEER);
+    transmit(packet, synced ? &m_peer : &m_listening_peer);
 }
 
-bool connection::passive_open(const sockaddr_in &peer, const packet &packet) noexcept {
+bool connection::passive_open(const sockaddr_in &peer, const packet &packet,
+                              std::chrono::steady_clock::time_point arrived) noexcept {
     RUDP_ASSERT(equals(m_peer, constants::UNINITIALISED_PEER),
                 "A connection cannot cannot both respond to an intial open and have previously "
                 "processed a packet from it's peer.");
@@ -274,7 +1036,56 @@ bool connection::passive_open(const sockaddr_in &peer, const packet &packet) noe
     m_acknum = packet.header.seqnum + 1;
     m_peer = peer;
     m_state.transition(state::kind::syn_rcvd);
-    return send_control_packet(m_state.derive_flags());
+
+    if (packet.header.version >= COMPACT_VERSION) {
+        m_layout = layout::compact;
+    }
+
+    negotiate(packet);
+    sample_queueing_delay(arrived);
+    handle_timestamp(packet, arrived);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_next_stream = 2;
+    }
+
+    u8 flags = m_state.derive_flags();
+    linuxfd_t listenfd = constants::UNINITIALISED_FD;
+
+    if (m_opts.shm && (packet.header.flags & static_cast<u8>(flag::SHM)) &&
+        shm::is_same_host(peer)) {
+        u64 nonce = 0;
+        listenfd = shm::listen(*m_transport, &nonce);
+        if (listenfd >= 0) {
+            flags |= static_cast<u8>(flag::SHM);
+            m_shm_nonce = nonce;
+        }
+    }
+
+    if (!send_control_packet(flags)) {
+        if (listenfd >= 0) {
+            close(listenfd);
+        }
+
+        return false;
+    }
+
+    if (listenfd >= 0) {
+        auto [err, event_loop] = event_loop::instance();
+        RUDP_ASSERT(err == event_loop::result::error::none && event_loop != nullptr,
+                    "A connection must not exist unless an event loop was succesfully created.");
+
+        // NOTE: Without a handler we would only notice the offer once the final ACK arrives.
+        if (event_loop->add_handler(handler_type::connection, listenfd,
+                                    [this]() { handle_events(); })) {
+            m_shm_listenfd = listenfd;
+        } else {
+            close(listenfd);
+        }
+    }
+
+    return true;
 }
 
 bool connection::active_open(const sockaddr_in &listening_peer) noexcept {
@@ -283,48 +1094,186 @@ bool connection::active_open(const sockaddr_in &listening_peer) noexcept {
                 "packet from it's peer.");
 
     m_state.transition(state::kind::syn_sent);
-    return send_control_packet(m_state.derive_flags(), listening_peer);
+    m_listening_peer = listening_peer;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_next_stream = 1;
+    }
+
+    u8 flags = m_state.derive_flags();
+    if (m_opts.shm && shm::is_same_host(listening_peer)) {
+        flags |= static_cast<u8>(flag::SHM);
+    }
+
+    return send_control_packet(flags, listening_peer);
+}
+
+bool connection::established() noexcept {
+    assert_external_state(__PRETTY_FUNCTION__);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return is_established();
 }
 
 void connection::wait_for_established() noexcept {
     assert_external_state(__PRETTY_FUNCTION__);
 
     std::unique_lock<std::mutex> lock(m_mtx);
-    m_cv.wait(lock, [this]() { return m_state.current() == state::kind::established; });
+    m_cv.wait(lock, [this]() { return is_established(); });
+}
+
+u32 connection::events() noexcept {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (!is_established()) {
+        return 0;
+    }
+
+    // NOTE: Readable when any stream is, or there is a stream to accept; writable only for the
+    // default stream, as there is no way to say which.
+    const bool readable = !m_unaccepted.empty() || std::ranges::any_of(m_streams, [this](auto &it) {
+        return has_recv_data(it.second, 1);
+    });
+
+    u32 events = 0;
+    if (readable) {
+        events |= static_cast<u32>(EPOLLIN);
+    }
+
+    if (default_stream().send_buffer.size() < constants::MAX_SEND_BUFFER_BYTES) {
+        events |= static_cast<u32>(EPOLLOUT);
+    }
+
+    // NOTE: As with MSG_ZEROCOPY, pending completions are signalled through the error condition.
+    if (m_zc_completed != zc_reported) {
+        events |= static_cast<u32>(EPOLLERR);
+    }
+
+    return events;
+}
+
+bool connection::has_recv_data(const stream &stream, size_t at_least) const noexcept {
+    // NOTE: Guarded by m_mtx. In message mode only a complete record can be received.
+    const recv_queue &buffer = stream.recv_buffer;
+    return m_opts.messages ? buffer.records() > 0 : buffer.size() >= at_least;
+}
+
+stream *connection::find_stream(u16 id) noexcept {
+    auto it = m_streams.find(id);
+    return (it == m_streams.end()) ? nullptr : &it->second;
+}
+
+stream &connection::default_stream() noexcept {
+    stream *found = find_stream(DEFAULT_STREAM);
+    RUDP_ASSERT(found != nullptr, "The default stream exists for the life of the connection.");
+    return *found;
+}
+
+std::optional<u16> connection::open_stream() noexcept {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (m_next_stream > std::numeric_limits<u16>::max()) {
+        return std::nullopt;
+    }
+
+    const u16 id = static_cast<u16>(m_next_stream);
+    m_next_stream += 2;
+
+    m_streams.try_emplace(id);
+    return id;
 }
 
-void connection::wait_for_send_space() noexcept {
+std::optional<u16> connection::accept_stream() noexcept {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (m_unaccepted.empty()) {
+        return std::nullopt;
+    }
+
+    const u16 id = m_unaccepted.front();
+    m_unaccepted.pop_front();
+    return id;
+}
+
+bool connection::is_established() const noexcept {
+    // NOTE: Guarded by m_mtx. An established connection still switching transport is not yet
+    // usable by the user thread.
+    return m_state.current() == state::kind::established && !m_pending_transport;
+}
+
+void connection::wait_for_send_space(u16 id, size_t at_least) noexcept {
     assert_external_state(__PRETTY_FUNCTION__);
     RUDP_ASSERT(m_state.current() == state::kind::established,
                 "A connection must be established before the user thread can send data.");
+    RUDP_ASSERT(at_least <= constants::MAX_SEND_BUFFER_BYTES,
+                "A connection cannot wait for more space than it's send buffer has.");
 
     std::unique_lock<std::mutex> lock(m_mtx);
-    m_cv.wait(lock, [this]() {
-        RUDP_ASSERT(send_buffer.size() <= constants::MAX_DATA_BYTES,
-                    "A connection's send buffer should never exceed it's cap.");
+    const stream *stream = find_stream(id);
+    RUDP_ASSERT(stream != nullptr, "A stream must exist before the user thread can send on it.");
 
-        return send_buffer.size() < constants::MAX_DATA_BYTES;
+    m_cv.wait(lock, [stream, at_least]() {
+        RUDP_ASSERT(stream->send_buffer.size() <= constants::MAX_SEND_BUFFER_BYTES,
+                    "A stream's send buffer should never exceed it's cap.");
+
+        return constants::MAX_SEND_BUFFER_BYTES - stream->send_buffer.size() >= at_least;
     });
 }
 
-void connection::wait_for_recv_data() noexcept {
+void connection::wait_for_recv_data(u16 id, size_t at_least) noexcept {
     assert_external_state(__PRETTY_FUNCTION__);
     RUDP_ASSERT(m_state.current() == state::kind::established,
                 "A connection must be established before the user thread can receive data. %d",
                 static_cast<int>(m_state.current()));
 
     std::unique_lock<std::mutex> lock(m_mtx);
-    m_cv.wait(lock, [this]() { return !recv_buffer.empty(); });
+    const stream *stream = find_stream(id);
+    RUDP_ASSERT(stream != nullptr, "A stream must exist before the user thread can receive on it.");
+
+    m_cv.wait(lock, [this, stream, at_least]() { return has_recv_data(*stream, at_least); });
+}
+
+void connection::wait_for_zc_completion() noexcept {
+    assert_external_state(__PRETTY_FUNCTION__);
+    RUDP_ASSERT(m_state.current() == state::kind::established,
+                "A connection must be established before the user thread can send data.");
+
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_cv.wait(lock, [this]() { return m_zc_completed != zc_reported; });
+}
+
+void connection::wait_for_stream() noexcept {
+    assert_external_state(__PRETTY_FUNCTION__);
+    RUDP_ASSERT(m_state.current() == state::kind::established,
+                "A connection must be established before the user thread can accept streams.");
+
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_cv.wait(lock, [this]() { return !m_unaccepted.empty(); });
 }
 
 void connection::on_established(std::function<void()> callback) noexcept {
     m_listener_established = std::move(callback);
 }
 
+void connection::on_data(std::shared_ptr<const data_callback> callback) noexcept {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_on_data = std::move(callback);
+}
+
 const sockaddr_in &connection::peer() const noexcept {
     return m_peer;
 }
 
+bool connection::shm_active() const noexcept {
+    return m_shm_active;
+}
+
+std::chrono::microseconds connection::queueing_delay() const noexcept {
+    return std::chrono::microseconds(m_queueing_delay.load(std::memory_order_relaxed));
+}
+
+size_t connection::congestion_window() const noexcept {
+    return m_cwnd.load(std::memory_order_relaxed);
+}
+
 void connection::assert_external_state(const char *caller) const noexcept {
     auto [err, event_loop] = internal::event_loop::instance();
     RUDP_ASSERT(err == internal::event_loop::result::error::none && event_loop != nullptr,
@@ -333,7 +1282,7 @@ void connection::assert_external_state(const char *caller) const noexcept {
     event_loop->assert_initialised_state(caller);
     event_loop->assert_handler_exists(caller, handler_type::connection, m_fd);
 
-    RUDP_ASSERT(is_valid_sockfd(m_fd), "A connection's underlying file descriptor must be valid.");
+    RUDP_ASSERT(is_valid_fd(m_fd), "A connection's underlying file descriptor must be valid.");
 }
 
 
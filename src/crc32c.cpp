@@ -0,0 +1,153 @@
+#include "internal/crc32c.hpp"
+
+#include <array>
+#include <cstring>
+#include <span>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+namespace {
+    // NOTE: The reflected Castagnoli polynomial.
+    constexpr u32 POLYNOMIAL = 0x82F63B78;
+
+    constexpr std::array<u32, 256> TABLE = []() {
+        std::array<u32, 256> table{};
+        for (u32 i = 0; i < table.size(); i++) {
+            u32 crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (POLYNOMIAL & (0u - (crc & 1)));
+            }
+            table[i] = crc;
+        }
+        return table;
+    }();
+
+    u32 software(u32 crc, const u8 *data, size_t len, u8 *output) noexcept {
+        if (output != nullptr) {
+            std::memcpy(output, data, len);
+        }
+
+        for (size_t i = 0; i < len; i++) {
+            crc = TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#if defined(__x86_64__)
+    // NOTE: Sized so that two rounds of three strides cover a full payload.
+    constexpr size_t STRIDE = constants::MAX_DATA_BYTES / 6 / sizeof(u64) * sizeof(u64);
+
+    // NOTE: The CRC register is linear, so feeding it STRIDE zero bytes is a table lookup per byte
+    // of the register: SHIFT[j][v] is the effect on byte j having value v.
+    using shift_table = std::array<std::array<u32, 256>, sizeof(u32)>;
+
+    [[nodiscard]] const shift_table &shift_table_instance() noexcept {
+        static const shift_table table = []() {
+            shift_table result{};
+            for (size_t j = 0; j < result.size(); j++) {
+                for (u32 v = 0; v < 256; v++) {
+                    u32 crc = v << (8 * j);
+                    for (size_t zero = 0; zero < STRIDE; zero++) {
+                        crc = TABLE[crc & 0xFF] ^ (crc >> 8);
+                    }
+                    result[j][v] = crc;
+                }
+            }
+            return result;
+        }();
+        return table;
+    }
+
+    [[nodiscard]] u32 shift(const shift_table &table, u32 crc) noexcept {
+        return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^ table[2][(crc >> 16) & 0xFF] ^
+               table[3][crc >> 24];
+    }
+
+    __attribute__((target("sse4.2"))) u64 step(u64 crc, const u8 *data, u8 *output) noexcept {
+        u64 word{};
+        std::memcpy(&word, data, sizeof(word));
+        if (output != nullptr) {
+            std::memcpy(output, &word, sizeof(word));
+        }
+        return _mm_crc32_u64(crc, word);
+    }
+
+    // NOTE: Eight bytes at a time, each word stored to output straight from the register it was
+    // checksummed from when copying. The crc32 instruction takes three cycles but can issue every
+    // cycle, so three strides are checksummed side by side and then joined, which the register's
+    // linearity allows: crc(a ++ b) is crc(a) shifted past b, xor crc(b) from zero.
+    __attribute__((target("sse4.2"))) u32 hardware(u32 crc, const u8 *data, size_t len,
+                                                    u8 *output) noexcept {
+        size_t i = 0;
+        if (len >= 3 * STRIDE) {
+            const shift_table &table = shift_table_instance();
+
+            for (; i + 3 * STRIDE <= len; i += 3 * STRIDE) {
+                u64 a = crc;
+                u64 b = 0;
+                u64 c = 0;
+
+                for (size_t j = i; j < i + STRIDE; j += sizeof(u64)) {
+                    const bool copying = output != nullptr;
+                    a = step(a, data + j, copying ? output + j : nullptr);
+                    b = step(b, data + j + STRIDE, copying ? output + j + STRIDE : nullptr);
+                    c = step(c, data + j + 2 * STRIDE, copying ? output + j + 2 * STRIDE : nullptr);
+                }
+
+                crc = shift(table, shift(table, static_cast<u32>(a)) ^ static_cast<u32>(b)) ^
+                      static_cast<u32>(c);
+            }
+        }
+
+        u64 wide = crc;
+        for (; i + sizeof(u64) <= len; i += sizeof(u64)) {
+            wide = step(wide, data + i, (output != nullptr) ? output + i : nullptr);
+        }
+
+        crc = static_cast<u32>(wide);
+        for (; i < len; i++) {
+            if (output != nullptr) {
+                output[i] = data[i];
+            }
+            crc = _mm_crc32_u8(crc, data[i]);
+        }
+        return crc;
+    }
+
+    [[nodiscard]] bool has_sse42() noexcept {
+        static const bool supported = []() {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.2") != 0;
+        }();
+        return supported;
+    }
+#endif
+
+    u32 dispatch(u32 crc, std::span<const u8> data, u8 *output) noexcept {
+#if defined(__x86_64__)
+        if (has_sse42()) {
+            return hardware(crc, data.data(), data.size(), output);
+        }
+#endif
+        return software(crc, data.data(), data.size(), output);
+    }
+}  // namespace
+
+u32 crc32c(u32 crc, std::span<const u8> data) noexcept {
+    return dispatch(crc, data, nullptr);
+}
+
+u32 crc32c_copy(u32 crc, std::span<const u8> data, u8 *output) noexcept {
+    return dispatch(crc, data, output);
+}
+
+u32 crc32c_software(u32 crc, std::span<const u8> data) noexcept {
+    return software(crc, data.data(), data.size(), nullptr);
+}
+
+}  // namespace rudp::internal
@@ -0,0 +1,264 @@
+#include "internal/epoll.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+#include "internal/socket.hpp"
+
+namespace rudp::internal {
+namespace {
+    constexpr u32 readable_writable = EPOLLIN | EPOLLOUT;
+    constexpr u32 always_reported = EPOLLERR;
+    constexpr u32 supported =
+        readable_writable | static_cast<u32>(EPOLLET) | static_cast<u32>(EPOLLONESHOT);
+
+    // NOTE: Leaked deliberately, as with g_sockets.
+    std::unordered_map<rudpfd_t, std::shared_ptr<epoll_instance>> &g_epolls =
+        *new std::unordered_map<rudpfd_t, std::shared_ptr<epoll_instance>>();
+    std::mutex &g_epolls_mtx = *new std::mutex();
+
+    [[nodiscard]] u32 socket_events(rudpfd_t fd) {
+        socket *sock = find_socket(fd);
+        return (sock == nullptr) ? 0 : sock->events();
+    }
+}  // namespace
+
+void readiness::notify() noexcept {
+    if (m_watching.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    for (const auto &[fd, watcher] : m_watchers) {
+        if (std::shared_ptr<epoll_instance> epoll = watcher.lock()) {
+            epoll->enqueue(fd);
+        }
+    }
+}
+
+void readiness::attach(rudpfd_t fd, const std::shared_ptr<epoll_instance> &epoll) noexcept {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_watchers.emplace_back(fd, epoll);
+    m_watching.store(m_watchers.size(), std::memory_order_release);
+}
+
+void readiness::detach(const epoll_instance *epoll) noexcept {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    std::erase_if(m_watchers, [epoll](const auto &watcher) {
+        return watcher.second.expired() || watcher.second.lock().get() == epoll;
+    });
+    m_watching.store(m_watchers.size(), std::memory_order_release);
+}
+
+epoll_instance::~epoll_instance() {
+    if (m_eventfd != constants::UNINITIALISED_FD) {
+        ::close(m_eventfd);
+    }
+}
+
+int epoll_instance::ctl(int op, rudpfd_t fd, const std::shared_ptr<class readiness> &readiness,
+                        const epoll_event *event) noexcept {
+    switch (op) {
+    case EPOLL_CTL_ADD: {
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (m_interests.contains(fd)) {
+                errno = EEXIST;
+                return -1;
+            }
+
+            epoll_event registered = *event;
+            registered.events &= supported;
+            m_interests.emplace(fd, interest{.event = registered, .queued = false, .armed = true});
+        }
+
+        // NOTE: As with epoll(7), a socket which is already ready is reported straight away.
+        readiness->attach(fd, shared_from_this());
+        enqueue(fd);
+        return 0;
+    }
+    case EPOLL_CTL_MOD: {
+        std::lock_guard<std::mutex> lock(m_mtx);
+
+        auto it = m_interests.find(fd);
+        if (it == m_interests.end()) {
+            errno = ENOENT;
+            return -1;
+        }
+
+        it->second.event = *event;
+        it->second.event.events &= supported;
+        it->second.armed = true;
+        enqueue_locked(fd, it->second);
+        return 0;
+    }
+    case EPOLL_CTL_DEL: {
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (m_interests.erase(fd) == 0) {
+                errno = ENOENT;
+                return -1;
+            }
+        }
+
+        readiness->detach(this);
+        return 0;
+    }
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+}
+
+int epoll_instance::wait(epoll_event *events, int maxevents, int timeout) noexcept {
+    RUDP_ASSERT(events != nullptr && maxevents > 0, "rudp::epoll_wait() validates its arguments.");
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    const auto has_ready = [this]() { return !m_ready.empty(); };
+
+    std::unique_lock<std::mutex> lock(m_mtx);
+
+    while (true) {
+        if (timeout < 0) {
+            m_cv.wait(lock, has_ready);
+        } else if (!m_cv.wait_until(lock, deadline, has_ready)) {
+            return 0;
+        }
+
+        // Take queued sockets off the ready list, staging them in the caller's array.
+        int staged = 0;
+        while (staged < maxevents && !m_ready.empty()) {
+            rudpfd_t fd = m_ready.front();
+            m_ready.pop_front();
+
+            // NOTE: The socket may have been deleted, or deleted and re-added, since it was queued.
+            auto it = m_interests.find(fd);
+            if (it == m_interests.end() || !it->second.queued) {
+                continue;
+            }
+
+            it->second.queued = false;
+            events[staged].events = it->second.event.events | always_reported;
+            events[staged].data.fd = fd;
+            staged++;
+        }
+
+        if (m_ready.empty() && m_eventfd != constants::UNINITIALISED_FD) {
+            u64 count{};
+            [[maybe_unused]] ssize_t drained = read(m_eventfd, &count, sizeof(count));
+        }
+
+        // NOTE: Socket state is guarded by locks the event thread takes before notifying us, so
+        // we must not hold ours while reading it.
+        lock.unlock();
+        for (int i = 0; i < staged; i++) {
+            events[i].events &= socket_events(events[i].data.fd);
+        }
+        lock.lock();
+
+        // Report the sockets which are still ready, compacting in place.
+        int reported = 0;
+        for (int i = 0; i < staged; i++) {
+            const rudpfd_t fd = events[i].data.fd;
+            const u32 ready = events[i].events;
+
+            auto it = m_interests.find(fd);
+            if (it == m_interests.end()) {
+                continue;
+            }
+
+            // NOTE: As with epoll(7), EPOLLERR is reported whether or not it was asked for, unless
+            // the socket has been disarmed by EPOLLONESHOT.
+            interest &entry = it->second;
+            const u32 wanted = (entry.event.events & readable_writable) | always_reported;
+            const u32 reportable = entry.armed ? wanted : 0;
+            if ((ready & reportable) == 0) {
+                continue;
+            }
+
+            events[reported].events = ready & reportable;
+            events[reported].data = entry.event.data;
+            reported++;
+
+            if (entry.event.events & static_cast<u32>(EPOLLONESHOT)) {
+                entry.armed = false;
+            } else if (!(entry.event.events & static_cast<u32>(EPOLLET))) {
+                // NOTE: Level-triggered sockets stay on the ready list until a wait finds them
+                // not ready, so nothing has to notify us when a socket stops being ready.
+                enqueue_locked(fd, entry);
+            }
+        }
+
+        if (reported > 0) {
+            return reported;
+        }
+    }
+}
+
+void epoll_instance::enqueue(rudpfd_t fd) noexcept {
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    auto it = m_interests.find(fd);
+    if (it != m_interests.end()) {
+        enqueue_locked(fd, it->second);
+    }
+}
+
+void epoll_instance::enqueue_locked(rudpfd_t fd, interest &entry) noexcept {
+    if (entry.queued) {
+        return;
+    }
+
+    entry.queued = true;
+    m_ready.push_back(fd);
+    m_cv.notify_one();
+
+    if (m_ready.size() == 1 && m_eventfd != constants::UNINITIALISED_FD) {
+        u64 one = 1;
+        [[maybe_unused]] ssize_t written = write(m_eventfd, &one, sizeof(one));
+    }
+}
+
+linuxfd_t epoll_instance::pollable_fd() noexcept {
+    std::lock_guard<std::mutex> lock(m_mtx);
+
+    if (m_eventfd == constants::UNINITIALISED_FD) {
+        // NOTE: On failure this is left as UNINITIALISED_FD, so a later call may retry.
+        m_eventfd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_eventfd < 0) {
+            return -1;
+        }
+
+        // NOTE: Sockets may already be queued, e.g. ready when they were added.
+        if (!m_ready.empty()) {
+            u64 one = 1;
+            [[maybe_unused]] ssize_t written = write(m_eventfd, &one, sizeof(one));
+        }
+    }
+
+    return m_eventfd;
+}
+
+std::shared_ptr<epoll_instance> find_epoll(rudpfd_t fd) noexcept {
+    std::lock_guard<std::mutex> lock(g_epolls_mtx);
+
+    auto it = g_epolls.find(fd);
+    return (it == g_epolls.end()) ? nullptr : it->second;
+}
+
+void insert_epoll(rudpfd_t fd, std::shared_ptr<epoll_instance> epoll) noexcept {
+    std::lock_guard<std::mutex> lock(g_epolls_mtx);
+    g_epolls.insert_or_assign(fd, std::move(epoll));
+}
+
+}  // namespace rudp::internal
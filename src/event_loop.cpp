@@ -1,6 +1,7 @@
 #include "internal/event_loop.hpp"
 
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
 
 #include <cerrno>
@@ -26,6 +27,9 @@ RUDP_STATIC_ASSERT(max_events > 0,
                    "max_events must be non-negative or else epoll_wait() will error.");
 
 void event_loop::loop() noexcept {
+    // NOTE: m_thread may not have been assigned yet, so we record our own id; the user thread
+    // observes it through m_thread_started.
+    m_thread_id = std::this_thread::get_id();
     m_running = true;
 
     assert_initialised_state(__PRETTY_FUNCTION__);
@@ -35,7 +39,7 @@ void event_loop::loop() noexcept {
     epoll_event events[max_events]{};
 
     while (m_running) {
-        int nfds = epoll_wait(m_epollfd, events, max_events, 50);
+        int nfds = ::epoll_wait(m_epollfd, events, max_events, 50);
         if (nfds < 0) {
             RUDP_ASSERT(errno == EINTR, "EINTR is the only possible error, but we received %s.",
                         strerror(errno));
@@ -51,20 +55,28 @@ void event_loop::loop() noexcept {
         });
 
         for (int i = 0; i < nfds; i++) {
-            u64 id = events[i].data.u64;
-            RUDP_ASSERT(m_handlers.contains(id),
-                        "There must exist a handler for every epoll registered file descriptor.");
+            // NOTE: A handler earlier in the batch may have removed this one, e.g.
+            // connection::switch_transport(), in which case the event is stale.
+            std::function<void()> handler;
+            {
+                std::lock_guard<std::mutex> lock(m_handlers_mtx);
+
+                auto it = m_handlers.find(events[i].data.u64);
+                if (it == m_handlers.end()) {
+                    continue;
+                }
+
+                // NOTE: A handler may also replace itself, so we must not call through the map.
+                handler = it->second;
+            }
 
-            m_handlers[id]();
+            handler();
         }
 
-        for (const auto &[_, socket] : g_sockets) {
-            if (socket.connected()) {
-                connection *connection = socket.connection();
-
-                connection->retransmit();
-                connection->process_sends();
-            }
+        std::lock_guard<std::mutex> lock(g_sockets_mtx);
+        for (connection *connection : g_connections) {
+            connection->retransmit();
+            connection->process_sends();
         }
     }
 };
@@ -81,12 +93,27 @@ event_loop::result event_loop::instance() noexcept {
     std::call_once(initialise, []() {
         auto loop = std::make_unique<event_loop>();
 
-        loop->m_epollfd = epoll_create1(0);
+        loop->m_epollfd = ::epoll_create1(0);
         if (loop->m_epollfd < 0) {
             error = result::error::epoll_creation;
             return;
         }
 
+        loop->m_wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (loop->m_wakefd < 0 ||
+            !loop->add_handler(handler_type::wakeup, loop->m_wakefd, [wakefd = loop->m_wakefd]() {
+                u64 count{};
+                [[maybe_unused]] ssize_t drained = read(wakefd, &count, sizeof(count));
+            })) {
+            if (loop->m_wakefd >= 0) {
+                close(loop->m_wakefd);
+            }
+
+            close(loop->m_epollfd);
+            error = result::error::wakeup_creation;
+            return;
+        }
+
         try {
             loop->m_thread = std::thread(&event_loop::loop, loop.get());
 
@@ -105,6 +132,7 @@ event_loop::result event_loop::instance() noexcept {
                 loop->m_thread.detach();
             }
 
+            close(loop->m_wakefd);
             close(loop->m_epollfd);
             error = result::error::thread_creation;
         }
@@ -115,12 +143,14 @@ event_loop::result event_loop::instance() noexcept {
 
 bool event_loop::add_handler(handler_type type, linuxfd_t fd,
                              std::function<void()> handler) noexcept {
-    RUDP_ASSERT(type == handler_type::connection || type == handler_type::listener,
-                "A handler must be of type connection or listener.");
-    RUDP_ASSERT(is_valid_sockfd(fd),
+    RUDP_ASSERT(type == handler_type::connection || type == handler_type::listener ||
+                    type == handler_type::wakeup,
+                "A handler must be of type connection, listener or wakeup.");
+    RUDP_ASSERT(is_valid_fd(fd),
                 "add_handler() must never be called with an invalid underlying file descriptor.");
 
     u64 id = calculate_id(type, fd);
+    std::lock_guard<std::mutex> lock(m_handlers_mtx);
     RUDP_ASSERT(!m_handlers.contains(id), "A handler must not be added twice.");
 
     // Register the handler.
@@ -129,7 +159,7 @@ bool event_loop::add_handler(handler_type type, linuxfd_t fd,
         .data = {.u64 = id},
     };
 
-    if (epoll_ctl(m_epollfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+    if (::epoll_ctl(m_epollfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
         RUDP_ASSERT(errno == ENOMEM || errno == ENOSPC,
                     "epoll_ctl() can only fail due to the environment, but we got %s.",
                     strerror(errno));
@@ -144,14 +174,15 @@ bool event_loop::remove_handler(handler_type type, linuxfd_t fd) noexcept {
     RUDP_ASSERT(type == handler_type::connection || type == handler_type::listener,
                 " A handler must be of type connection or listener.");
     RUDP_ASSERT(
-        is_valid_sockfd(fd),
+        is_valid_fd(fd),
         "remove_handler() must never be called with an invalid underlying file descriptor.");
 
     u64 id = calculate_id(type, fd);
+    std::lock_guard<std::mutex> lock(m_handlers_mtx);
     RUDP_ASSERT(m_handlers.contains(id), "A handler must exist in order to be deleted.");
 
     // Deregister the handler.
-    if (epoll_ctl(m_epollfd, EPOLL_CTL_DEL, fd, nullptr) < 0) {
+    if (::epoll_ctl(m_epollfd, EPOLL_CTL_DEL, fd, nullptr) < 0) {
         RUDP_ASSERT(errno == ENOMEM || errno == ENOSPC,
                     "epoll_ctl() can only fail due to the environment, but we got %s.",
                     strerror(errno));
@@ -162,6 +193,11 @@ bool event_loop::remove_handler(handler_type type, linuxfd_t fd) noexcept {
     return true;
 }
 
+void event_loop::wake() noexcept {
+    u64 one = 1;
+    [[maybe_unused]] ssize_t written = write(m_wakefd, &one, sizeof(one));
+}
+
 u64 event_loop::calculate_id(handler_type type, linuxfd_t fd) noexcept {
     return (static_cast<u64>(type) << 32) | static_cast<u32>(fd);
 }
@@ -177,12 +213,12 @@ void event_loop::assert_initialised_state(const char *caller) const noexcept {
 
 // NOTE: These asserts assume the thread is already initialised.
 void event_loop::assert_event_thread(const char *caller) const noexcept {
-    RUDP_ASSERT(std::this_thread::get_id() == m_thread.get_id(),
+    RUDP_ASSERT(std::this_thread::get_id() == m_thread_id,
                 "[%s] The caller should run only on the event thread.", caller);
 }
 
 void event_loop::assert_user_thread(const char *caller) const noexcept {
-    RUDP_ASSERT(std::this_thread::get_id() != m_thread.get_id(),
+    RUDP_ASSERT(std::this_thread::get_id() != m_thread_id,
                 "[%s] The caller should run only on the user thread.", caller);
 }
 // NOTE ends
@@ -190,6 +226,7 @@ void event_loop::assert_user_thread(const char *caller) const noexcept {
 void event_loop::assert_handler_exists(const char *caller, handler_type type,
                                        linuxfd_t fd) const noexcept {
     u64 id = calculate_id(type, fd);
+    std::lock_guard<std::mutex> lock(m_handlers_mtx);
     RUDP_ASSERT(m_handlers.contains(id),
                 "[%s] The handler of type=%d and fd=%d must be registered.", caller,
                 static_cast<u32>(type), fd);
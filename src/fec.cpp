@@ -0,0 +1,229 @@
+#include "internal/fec.hpp"
+
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+#include "internal/packet.hpp"
+#include "internal/tlv.hpp"
+
+namespace rudp::internal {
+namespace {
+    constexpr size_t TAG_BYTES = 3;
+    constexpr size_t REPAIR_BYTES = 16;
+
+    // NOTE: The group, the count of segments in it, then the XOR of their flags, length, stream,
+    // sequence number and offset, in network order.
+    struct repair_fields {
+        u16 group;
+        u8 count;
+        packet_header header;
+    };
+
+    void put16(u8 *out, u16 value) {
+        value = htons(value);
+        std::memcpy(out, &value, sizeof(value));
+    }
+
+    void put32(u8 *out, u32 value) {
+        value = htonl(value);
+        std::memcpy(out, &value, sizeof(value));
+    }
+
+    [[nodiscard]] u16 get16(const u8 *in) {
+        u16 value{};
+        std::memcpy(&value, in, sizeof(value));
+        return ntohs(value);
+    }
+
+    [[nodiscard]] u32 get32(const u8 *in) {
+        u32 value{};
+        std::memcpy(&value, in, sizeof(value));
+        return ntohl(value);
+    }
+
+    [[nodiscard]] std::optional<repair_fields> parse_repair(const packet &repair) {
+        std::optional<std::span<const u8>> found = repair.find_option(option::fec_repair);
+        if (!found.has_value() || found->size() != REPAIR_BYTES) {
+            return std::nullopt;
+        }
+
+        const u8 *in = found->data();
+        repair_fields fields{.group = get16(in), .count = in[2], .header = {}};
+        fields.header.flags = in[3];
+        fields.header.length = get16(in + 4);
+        fields.header.stream = get16(in + 6);
+        fields.header.seqnum = get32(in + 8);
+        fields.header.offset = get32(in + 12);
+
+        if (fields.count == 0 || fields.count > MAX_FEC_GROUP) {
+            return std::nullopt;
+        }
+
+        return fields;
+    }
+}  // namespace
+
+void fec_parity::add(const packet_header &header, std::span<const u8> payload) noexcept {
+    flags ^= header.flags;
+    length ^= header.length;
+    stream ^= header.stream;
+    seqnum ^= header.seqnum;
+    offset ^= header.offset;
+
+    const size_t len = std::min(payload.size(), data.size());
+    for (size_t i = 0; i < len; i++) {
+        data[i] ^= payload[i];
+    }
+    covered = std::max(covered, static_cast<u16>(len));
+}
+
+void fec_encoder::tag(packet &segment) const noexcept {
+    std::array<u8, TAG_BYTES> tag{};
+    put16(&tag[0], m_group);
+    tag[2] = m_count;
+
+    [[maybe_unused]] const bool added = segment.add_option(option::fec, tag);
+    RUDP_ASSERT(added, "A tag always fits an empty options area.");
+}
+
+void fec_encoder::add(const packet_header &header, std::span<const u8> payload) noexcept {
+    RUDP_ASSERT(m_count < MAX_FEC_GROUP, "A full group must be repaired before the next begins.");
+
+    if (!m_parity) {
+        m_parity = std::make_unique<fec_parity>();
+    } else if (m_count == 0) {
+        *m_parity = {};
+    }
+
+    m_parity->add(header, payload);
+    m_count++;
+}
+
+packet fec_encoder::repair(u32 seqnum, u32 acknum) noexcept {
+    RUDP_ASSERT(m_count > 0 && m_parity, "Only a group with a segment in it can be repaired.");
+
+    // NOTE: A repair takes up no sequence space; its sequence number is only the sender's next.
+    packet repair(packet_header{
+        .flags = static_cast<u8>(flag::REPAIR),
+        .seqnum = seqnum,
+        .acknum = acknum,
+        .length = m_parity->covered,
+    });
+
+    std::array<u8, REPAIR_BYTES> fields{};
+    put16(&fields[0], m_group);
+    fields[2] = m_count;
+    fields[3] = m_parity->flags;
+    put16(&fields[4], m_parity->length);
+    put16(&fields[6], m_parity->stream);
+    put32(&fields[8], m_parity->seqnum);
+    put32(&fields[12], m_parity->offset);
+
+    [[maybe_unused]] const bool added = repair.add_option(option::fec_repair, fields);
+    RUDP_ASSERT(added, "A repair's fields always fit an empty options area.");
+    repair.view_data(std::span(m_parity->data).first(m_parity->covered), nullptr);
+
+    m_group++;
+    m_count = 0;
+    return repair;
+}
+
+std::optional<packet> fec_decoder::add(const packet &segment) noexcept {
+    std::optional<std::span<const u8>> tag = segment.find_option(option::fec);
+    if (!tag.has_value() || tag->size() != TAG_BYTES || (*tag)[2] >= MAX_FEC_GROUP) {
+        return std::nullopt;
+    }
+
+    group_state *state = find(get16(tag->data()));
+    const u32 bit = u32{1} << (*tag)[2];
+    if (state == nullptr || state->done || (state->received & bit)) {
+        return std::nullopt;
+    }
+
+    state->received |= bit;
+    state->parity.add(segment.header, segment.data());
+    return rebuild(*state);
+}
+
+std::optional<packet> fec_decoder::repair(const packet &repair) noexcept {
+    std::optional<repair_fields> fields = parse_repair(repair);
+    if (!fields.has_value()) {
+        return std::nullopt;
+    }
+
+    group_state *state = find(fields->group);
+    if (state == nullptr || state->done || state->count != 0) {
+        return std::nullopt;
+    }
+
+    state->count = fields->count;
+    state->acknum = repair.header.acknum;
+    state->parity.add(fields->header, repair.data());
+    return rebuild(*state);
+}
+
+fec_decoder::group_state *fec_decoder::find(u16 group) noexcept {
+    if (!m_groups) {
+        m_groups = std::make_unique<std::array<group_state, WINDOW>>();
+    }
+
+    group_state &state = (*m_groups)[group % WINDOW];
+    if (state.group == group) {
+        return &state;
+    }
+
+    if (static_cast<s16>(group - state.group) < 0) {
+        return nullptr;
+    }
+
+    state = {};
+    state.group = group;
+    return &state;
+}
+
+std::optional<packet> fec_decoder::rebuild(group_state &state) noexcept {
+    if (state.count == 0) {
+        return std::nullopt;
+    }
+
+    const int received = std::popcount(state.received);
+    if (received + 1 < state.count) {
+        return std::nullopt;
+    }
+
+    state.done = true;
+    if (received >= state.count) {
+        return std::nullopt;
+    }
+
+    // NOTE: Only ever data is tagged, so anything else means the group was not what we took it for.
+    const fec_parity &parity = state.parity;
+    if ((parity.flags & ~static_cast<u8>(flag::EOR)) != 0 || parity.length == 0 ||
+        parity.length > constants::MAX_DATA_BYTES) {
+        return std::nullopt;
+    }
+
+    packet rebuilt(packet_header{
+        .flags = parity.flags,
+        .seqnum = parity.seqnum,
+        .acknum = state.acknum,
+        .length = parity.length,
+        .stream = parity.stream,
+        .offset = parity.offset,
+    });
+    rebuilt.assign_data(
+        std::vector<u8>(parity.data.begin(), parity.data.begin() + parity.length));
+    return rebuilt;
+}
+
+}  // namespace rudp::internal
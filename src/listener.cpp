@@ -5,10 +5,13 @@
 #include <sys/socket.h>
 
 #include <cerrno>
+#include <chrono>
 #include <condition_variable>
 #include <cstring>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <unordered_set>
 
 #include "internal/assert.hpp"
 #include "internal/common.hpp"
@@ -24,8 +27,9 @@ void listener::handle_events() noexcept {
 
     while (true) {
         sockaddr_in peer_addr{};
+        arrival arrived{};
 
-        std::optional<packet> packet_opt = packet::recvfrom(m_fd, &peer_addr);
+        std::optional<packet> packet_opt = packet::recvfrom(*m_transport, &peer_addr, &arrived);
         if (!packet_opt.has_value()) {
             RUDP_ASSERT(
                 errno == EWOULDBLOCK || errno == EAGAIN || errno == EINTR,
@@ -39,30 +43,27 @@ void listener::handle_events() noexcept {
         }
 
         packet packet = packet_opt.value();
-        if (packet.header.flags != static_cast<u8>(flag::SYN)) {
+        if (!(packet.header.flags & static_cast<u8>(flag::SYN)) ||
+            (packet.header.flags & static_cast<u8>(flag::ACK))) {
             continue;
         }
 
-        // Create and bind a new FD for the connection to be spawned.
-        linuxfd_t fd = create_raw_socket();
-        if (fd < 0) {
+        const u64 peer_key = (static_cast<u64>(peer_addr.sin_addr.s_addr) << 16) |
+                             static_cast<u64>(peer_addr.sin_port);
+        if (m_handshaking.contains(peer_key)) {
             continue;
         }
 
-        struct sockaddr_in bound_addr{};
-        bound_addr.sin_family = AF_INET;
-        bound_addr.sin_addr.s_addr = INADDR_ANY;
-        bound_addr.sin_port = 0;
-
-        if (bind(fd, reinterpret_cast<struct sockaddr *>(&bound_addr), sizeof(bound_addr)) < 0) {
-            close(fd);
+        // Create and bind a new transport for the connection to be spawned.
+        std::shared_ptr<transport> spawned = m_transport->spawn();
+        if (!spawned) {
             continue;
         }
 
         // Create and register the connection.
-        auto connection = std::make_unique<internal::connection>(fd);
+        auto readiness = std::make_shared<class readiness>();
+        auto connection = std::make_unique<internal::connection>(spawned, m_opts, readiness);
         if (!connection) {
-            close(fd);
             continue;
         }
 
@@ -71,27 +72,36 @@ void listener::handle_events() noexcept {
                     "assert_external_state() guarantees an event loop.");
 
         if (!event_loop->add_handler(
-                handler_type::connection, fd,
+                handler_type::connection, spawned->fd(),
                 [connection = connection.get()]() { connection->handle_events(); })) {
-            close(fd);
             continue;
         }
 
         // Register the callback and respond to the active open.
         rudpfd_t newfd = g_next_fd++;
-        connection->on_established([this, newfd]() {
-            std::lock_guard<std::mutex> lock(m_mtx);
-            m_ready.push(newfd);
-            m_cv.notify_one();
+        connection->on_established([this, newfd, peer_key]() {
+            m_handshaking.erase(peer_key);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                m_ready.push(newfd);
+                m_cv.notify_one();
+            }
+
+            m_readiness->notify();
         });
 
-        if (!connection->passive_open(peer_addr, packet)) {
-            event_loop->remove_handler(handler_type::connection, fd);
-            close(fd);
+        if (!connection->passive_open(peer_addr, packet, arrived.at)) {
+            event_loop->remove_handler(handler_type::connection, spawned->fd());
             continue;
         }
 
-        g_sockets[newfd] = internal::socket{std::move(connection)};
+        m_handshaking.insert(peer_key);
+        insert_socket(newfd, internal::socket{
+                                 .data = std::move(connection),
+                                 .opts = m_opts,
+                                 .readiness = std::move(readiness),
+                             });
     }
 }
 
@@ -107,15 +117,34 @@ rudpfd_t listener::wait_and_accept() noexcept {
     return fd;
 }
 
+std::optional<rudpfd_t> listener::try_accept() noexcept {
+    assert_external_state(__PRETTY_FUNCTION__);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (m_ready.empty()) {
+        return std::nullopt;
+    }
+
+    rudpfd_t fd = m_ready.front();
+    m_ready.pop();
+    return fd;
+}
+
+u32 listener::events() noexcept {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_ready.empty() ? 0 : static_cast<u32>(EPOLLIN);
+}
+
 void listener::assert_external_state(const char *caller) const noexcept {
     auto [err, event_loop] = event_loop::instance();
     RUDP_ASSERT(err == event_loop::result::error::none && event_loop != nullptr,
                 "A listener must not exist unless an event loop was succesfully created.");
 
     event_loop->assert_initialised_state(caller);
-    event_loop->assert_handler_exists(caller, handler_type::listener, m_fd);
+    event_loop->assert_handler_exists(caller, handler_type::listener, m_transport->fd());
 
-    RUDP_ASSERT(is_valid_sockfd(m_fd), "A listener's underlying file descriptor must be valid.");
+    RUDP_ASSERT(is_valid_fd(m_transport->fd()),
+                "A listener's underlying file descriptor must be valid.");
 }
 
 }  // namespace rudp::internal
@@ -0,0 +1,222 @@
+#include "internal/loopback.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+#include "internal/transport.hpp"
+
+namespace rudp::internal {
+namespace {
+    constexpr u16 first_ephemeral_port = 49152;
+
+    // NOTE: The registry is only touched on bind() and on a peer cache miss, never per datagram.
+    struct registry {
+        std::mutex mtx;
+        std::unordered_map<u16, std::weak_ptr<loopback_transport::endpoint>> endpoints;
+        u16 next_ephemeral{first_ephemeral_port};
+
+        // NOTE: Leaked deliberately; transports owned by g_sockets outlive function statics.
+        static registry &instance() {
+            static registry *instance = new registry();
+            return *instance;
+        }
+    };
+
+    void signal(loopback_transport::endpoint &endpoint) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (endpoint.armed.exchange(false)) {
+            u64 one = 1;
+            [[maybe_unused]] ssize_t written = ::write(endpoint.eventfd, &one, sizeof(one));
+        }
+    }
+}  // namespace
+
+loopback_transport::endpoint::~endpoint() {
+    if (eventfd != constants::UNINITIALISED_FD) {
+        ::close(eventfd);
+    }
+}
+
+loopback_transport::~loopback_transport() {
+    if (m_addr.sin_port == 0) {
+        return;
+    }
+
+    auto &registry = registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    registry.endpoints.erase(ntohs(m_addr.sin_port));
+}
+
+std::shared_ptr<transport> loopback_transport::create() noexcept {
+    auto endpoint = std::make_shared<loopback_transport::endpoint>();
+
+    endpoint->eventfd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (endpoint->eventfd < 0) {
+        // NOTE: errno is forwarded from eventfd().
+        return nullptr;
+    }
+
+    return std::make_shared<loopback_transport>(std::move(endpoint));
+}
+
+std::shared_ptr<transport> loopback_transport::spawn() const noexcept {
+    auto spawned = loopback_transport::create();
+    if (!spawned) {
+        return nullptr;
+    }
+
+    struct sockaddr_in bound_addr{};
+    bound_addr.sin_family = AF_INET;
+    bound_addr.sin_addr.s_addr = INADDR_ANY;
+    bound_addr.sin_port = 0;
+
+    if (spawned->bind(bound_addr) < 0) {
+        return nullptr;
+    }
+
+    return spawned;
+}
+
+linuxfd_t loopback_transport::fd() const noexcept {
+    return m_endpoint->eventfd;
+}
+
+int loopback_transport::bind(const sockaddr_in &addr) noexcept {
+    RUDP_ASSERT(m_addr.sin_port == 0, "A loopback transport must not be bound twice.");
+
+    auto &registry = registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mtx);
+
+    u16 port = ntohs(addr.sin_port);
+    if (port == 0) {
+        // NOTE: Search the ephemeral range once, starting from where we last left off.
+        for (u32 attempts = 0; attempts <= 0xFFFF - first_ephemeral_port; attempts++) {
+            u16 candidate = registry.next_ephemeral;
+            registry.next_ephemeral = (candidate == 0xFFFF) ? first_ephemeral_port
+                                                            : static_cast<u16>(candidate + 1);
+
+            auto it = registry.endpoints.find(candidate);
+            if (it == registry.endpoints.end() || it->second.expired()) {
+                port = candidate;
+                break;
+            }
+        }
+
+        if (port == 0) {
+            errno = EADDRINUSE;
+            return -1;
+        }
+    } else {
+        auto it = registry.endpoints.find(port);
+        if (it != registry.endpoints.end() && !it->second.expired()) {
+            errno = EADDRINUSE;
+            return -1;
+        }
+    }
+
+    registry.endpoints[port] = m_endpoint;
+
+    m_addr.sin_family = AF_INET;
+    m_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    m_addr.sin_port = htons(port);
+    return 0;
+}
+
+int loopback_transport::getsockname(sockaddr_in *addr) const noexcept {
+    *addr = m_addr;
+    return 0;
+}
+
+ssize_t loopback_transport::sendmsg(std::span<const iovec> iov, const sockaddr_in &addr,
+                                    ecn codepoint) noexcept {
+    const size_t len = iov_length(iov);
+    if (len > MAX_DATAGRAM_BYTES) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    u16 port = ntohs(addr.sin_port);
+    if (port != m_cached_port || !m_cached_peer) {
+        auto &registry = registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mtx);
+
+        auto it = registry.endpoints.find(port);
+        m_cached_port = port;
+        m_cached_peer = (it != registry.endpoints.end()) ? it->second.lock() : nullptr;
+    }
+
+    // NOTE: Like UDP, a datagram to nobody is silently dropped.
+    if (!m_cached_peer) {
+        return static_cast<ssize_t>(len);
+    }
+
+    bool pushed = m_cached_peer->queue.push([&](datagram &slot) {
+        slot.from = m_addr;
+        slot.sent_at = std::chrono::steady_clock::now();
+        slot.codepoint = codepoint;
+        slot.length = len;
+        gather(slot.data.data(), iov);
+    });
+
+    if (!pushed) {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    signal(*m_cached_peer);
+    return static_cast<ssize_t>(len);
+}
+
+ssize_t loopback_transport::recvfrom(void *buf, size_t len, sockaddr_in *addr,
+                                     arrival *arrival) noexcept {
+    ssize_t result = -1;
+    auto reader = [&](const datagram &slot) {
+        size_t copy = std::min(len, slot.length);
+        std::memcpy(buf, slot.data.data(), copy);
+
+        if (addr != nullptr) {
+            *addr = slot.from;
+        }
+
+        // NOTE: There is no wire, so a datagram arrives as it is sent.
+        if (arrival != nullptr) {
+            *arrival = {.at = slot.sent_at, .codepoint = slot.codepoint};
+        }
+        result = static_cast<ssize_t>(copy);
+    };
+
+    if (m_endpoint->queue.pop(reader)) {
+        return result;
+    }
+
+    // NOTE: The queue looked empty, so we clear the eventfd and re-arm before checking once more;
+    // a producer that pushed in between either sees the re-arm or is seen by the second pop.
+    u64 count{};
+    [[maybe_unused]] ssize_t drained = ::read(m_endpoint->eventfd, &count, sizeof(count));
+    m_endpoint->armed.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_endpoint->queue.pop(reader)) {
+        return result;
+    }
+
+    errno = EAGAIN;
+    return -1;
+}
+
+}  // namespace rudp::internal
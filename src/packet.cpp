@@ -3,19 +3,28 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstring>
+#include <limits>
+#include <memory>
 #include <optional>
+#include <span>
 #include <variant>
 #include <vector>
 
 #include "internal/assert.hpp"
 #include "internal/common.hpp"
+#include "internal/crc32c.hpp"
 #include "internal/simulator.hpp"
+#include "internal/transport.hpp"
 
 namespace rudp::internal {
 
-RUDP_STATIC_ASSERT(sizeof(packet_header) == 16,
+RUDP_STATIC_ASSERT(sizeof(packet_header) == 24,
                    "Don't forget to update the serialisation functions :)");
 RUDP_STATIC_ASSERT(offsetof(packet_header, magic) == 0);
 RUDP_STATIC_ASSERT(offsetof(packet_header, version) == 2);
@@ -23,78 +32,288 @@ RUDP_STATIC_ASSERT(offsetof(packet_header, flags) == 3);
 RUDP_STATIC_ASSERT(offsetof(packet_header, seqnum) == 4);
 RUDP_STATIC_ASSERT(offsetof(packet_header, acknum) == 8);
 RUDP_STATIC_ASSERT(offsetof(packet_header, length) == 12);
+RUDP_STATIC_ASSERT(offsetof(packet_header, stream) == 14);
+RUDP_STATIC_ASSERT(offsetof(packet_header, offset) == 16);
+RUDP_STATIC_ASSERT(offsetof(packet_header, checksum) == 20);
 
-std::vector<u8> packet::serialise() const noexcept {
-    std::vector<u8> result;
-    result.reserve(sizeof(packet_header) + m_data.size());
+namespace {
+    // NOTE: The header, its checksum, then any options.
+    using header_bytes = std::array<u8, MAX_HEADER_BYTES + 1 + MAX_OPTION_BYTES>;
 
-    u16 net_magic = htons(header.magic);
-    u32 net_seqnum = htonl(header.seqnum);
-    u32 net_acknum = htonl(header.acknum);
-    u32 net_length = htonl(header.length);
+    constexpr size_t CHECKSUM_BYTES = sizeof(packet_header::checksum);
+    constexpr size_t MAX_VARINT_BYTES = 5;
 
-    // Header.
-    const u8 *magic = reinterpret_cast<const u8 *>(&net_magic);
-    result.insert(result.end(), magic, magic + sizeof(net_magic));
+    void put_varint(u8 *&out, u32 value) noexcept {
+        while (value >= 0x80) {
+            *out++ = static_cast<u8>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<u8>(value);
+    }
 
-    result.push_back(header.version);
-    result.push_back(header.flags);
+    [[nodiscard]] bool get_varint(std::span<const u8> data, size_t &i, u32 &value) noexcept {
+        value = 0;
+        for (size_t shift = 0; shift < 7 * MAX_VARINT_BYTES; shift += 7) {
+            if (i >= data.size()) {
+                return false;
+            }
+
+            const u8 byte = data[i++];
+            value |= static_cast<u32>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
 
-    const u8 *seqnum = reinterpret_cast<const u8 *>(&net_seqnum);
-    result.insert(result.end(), seqnum, seqnum + sizeof(net_seqnum));
+        return false;
+    }
 
-    const u8 *acknum = reinterpret_cast<const u8 *>(&net_acknum);
-    result.insert(result.end(), acknum, acknum + sizeof(net_acknum));
+    // NOTE: Each layout encodes every field bar the checksum, which always follows the rest of the
+    // header, and decodes up to it, returning where it starts. Specialised per layout, so that
+    // neither pays for the other's branches.
+    template <layout Layout>
+    struct codec;
+
+    template <>
+    struct codec<layout::full> {
+        static constexpr size_t MAX_BYTES = offsetof(packet_header, checksum);
+
+        [[nodiscard]] static size_t encode(const packet_header &header, u8 *out) noexcept {
+            u16 net_magic = htons(header.magic);
+            u32 net_seqnum = htonl(header.seqnum);
+            u32 net_acknum = htonl(header.acknum);
+            u16 net_length = htons(header.length);
+            u16 net_stream = htons(header.stream);
+            u32 net_offset = htonl(header.offset);
+
+            std::memcpy(&out[offsetof(packet_header, magic)], &net_magic, sizeof(net_magic));
+            out[offsetof(packet_header, version)] = header.version;
+            out[offsetof(packet_header, flags)] = header.flags;
+            std::memcpy(&out[offsetof(packet_header, seqnum)], &net_seqnum, sizeof(net_seqnum));
+            std::memcpy(&out[offsetof(packet_header, acknum)], &net_acknum, sizeof(net_acknum));
+            std::memcpy(&out[offsetof(packet_header, length)], &net_length, sizeof(net_length));
+            std::memcpy(&out[offsetof(packet_header, stream)], &net_stream, sizeof(net_stream));
+            std::memcpy(&out[offsetof(packet_header, offset)], &net_offset, sizeof(net_offset));
+
+            return MAX_BYTES;
+        }
 
-    const u8 *length = reinterpret_cast<const u8 *>(&net_length);
-    result.insert(result.end(), length, length + sizeof(net_length));
+        [[nodiscard]] static std::optional<size_t> decode(std::span<const u8> data,
+                                                          packet_header &header) noexcept {
+            if (data.size() < sizeof(packet_header)) {
+                return std::nullopt;
+            }
 
-    // Data.
-    result.insert(result.end(), m_data.begin(), m_data.end());
+            size_t i = 0;
 
-    return result;
-}
+            u16 net_magic{};
+            std::memcpy(&net_magic, &data[i], sizeof(net_magic));
+            header.magic = ntohs(net_magic);
+            i += 2;
 
-std::optional<packet> packet::deserialise(const std::vector<u8> &data) {
-    if (data.size() < sizeof(packet_header)) {
-        return std::nullopt;
+            if (header.magic != packet_header{}.magic) {
+                return std::nullopt;
+            }
+
+            header.version = data[i++];
+            header.flags = data[i++];
+
+            u32 net_seqnum{};
+            std::memcpy(&net_seqnum, &data[i], sizeof(net_seqnum));
+            header.seqnum = ntohl(net_seqnum);
+            i += 4;
+
+            u32 net_acknum{};
+            std::memcpy(&net_acknum, &data[i], sizeof(net_acknum));
+            header.acknum = ntohl(net_acknum);
+            i += 4;
+
+            u16 net_length{};
+            std::memcpy(&net_length, &data[i], sizeof(net_length));
+            header.length = ntohs(net_length);
+            i += 2;
+
+            u16 net_stream{};
+            std::memcpy(&net_stream, &data[i], sizeof(net_stream));
+            header.stream = ntohs(net_stream);
+            i += 2;
+
+            u32 net_offset{};
+            std::memcpy(&net_offset, &data[i], sizeof(net_offset));
+            header.offset = ntohl(net_offset);
+            i += 4;
+
+            return i;
+        }
+    };
+
+    // NOTE: The version, flags, then varints for the sequence and acknowledgement numbers, the
+    // stream and the offset. A marker alone carries its length, as it has no payload to imply it.
+    // A bare ACK comes to around a dozen bytes against the full layout's 24.
+    template <>
+    struct codec<layout::compact> {
+        // NOTE: The length is at most MAX_DATA_BYTES and the stream a u16, so narrower varints.
+        static constexpr size_t MAX_BYTES = 2 + 3 * MAX_VARINT_BYTES + 2 + 3;
+
+        [[nodiscard]] static size_t encode(const packet_header &header, u8 *out) noexcept {
+            u8 *const start = out;
+
+            *out++ = COMPACT_VERSION;
+            *out++ = header.flags;
+            put_varint(out, header.seqnum);
+            put_varint(out, header.acknum);
+            if (header.flags & static_cast<u8>(flag::SKIP)) {
+                put_varint(out, header.length);
+            }
+            put_varint(out, header.stream);
+            put_varint(out, header.offset);
+
+            return static_cast<size_t>(out - start);
+        }
+
+        [[nodiscard]] static std::optional<size_t> decode(std::span<const u8> data,
+                                                          packet_header &header) noexcept {
+            if (data.size() < 2 || data[0] != COMPACT_VERSION) {
+                return std::nullopt;
+            }
+
+            size_t i = 0;
+            header.version = data[i++];
+            header.flags = data[i++];
+
+            u32 length = 0;
+            u32 stream = 0;
+            const bool skip = header.flags & static_cast<u8>(flag::SKIP);
+            if (!get_varint(data, i, header.seqnum) || !get_varint(data, i, header.acknum) ||
+                (skip && !get_varint(data, i, length)) || !get_varint(data, i, stream) ||
+                !get_varint(data, i, header.offset) || i + CHECKSUM_BYTES > data.size()) {
+                return std::nullopt;
+            }
+
+            // NOTE: The payload is whatever follows the checksum and any options.
+            size_t trailer = CHECKSUM_BYTES;
+            if (header.flags & static_cast<u8>(flag::OPT)) {
+                if (i + trailer >= data.size()) {
+                    return std::nullopt;
+                }
+                trailer += 1 + static_cast<size_t>(data[i + trailer]);
+            }
+
+            if (i + trailer > data.size()) {
+                return std::nullopt;
+            }
+
+            if (!skip) {
+                length = static_cast<u32>(data.size() - i - trailer);
+            }
+
+            if (length > constants::MAX_DATA_BYTES || stream > std::numeric_limits<u16>::max()) {
+                return std::nullopt;
+            }
+
+            header.length = static_cast<u16>(length);
+            header.stream = static_cast<u16>(stream);
+            return i;
+        }
+    };
+
+    RUDP_STATIC_ASSERT((packet_header{}.magic >> 8) != COMPACT_VERSION,
+                       "The layouts are told apart by their first byte.");
+    RUDP_STATIC_ASSERT(codec<layout::full>::MAX_BYTES + CHECKSUM_BYTES <= MAX_HEADER_BYTES);
+    RUDP_STATIC_ASSERT(codec<layout::compact>::MAX_BYTES + CHECKSUM_BYTES == MAX_HEADER_BYTES);
+
+    // NOTE: The checksum covers the header, with its own bytes zeroed, any options and the
+    // payload. Whether there are options is up to the packet, whatever its header says.
+    template <layout Layout>
+    [[nodiscard]] size_t serialise_header(const packet &packet, std::span<const u8> options,
+                                          header_bytes &out) noexcept {
+        packet_header header = packet.header;
+        header.flags &= static_cast<u8>(~static_cast<u8>(flag::OPT));
+        if (!options.empty()) {
+            header.flags |= static_cast<u8>(flag::OPT);
+        }
+
+        const size_t len = codec<Layout>::encode(header, out.data());
+        size_t total = len + CHECKSUM_BYTES;
+
+        if (!options.empty()) {
+            out[total++] = static_cast<u8>(options.size());
+            std::memcpy(&out[total], options.data(), options.size());
+            total += options.size();
+        }
+
+        u32 crc = crc32c(CRC32C_INITIAL, std::span(out).first(total));
+        crc = crc32c_finish(crc32c(crc, packet.data()));
+
+        u32 net_checksum = htonl(crc);
+        std::memcpy(&out[len], &net_checksum, sizeof(net_checksum));
+
+        return total;
     }
 
-    size_t i = 0;
-    packet_header header;
+    // NOTE: Returns where the payload starts, with crc covering everything before it.
+    template <layout Layout>
+    [[nodiscard]] std::optional<size_t> deserialise_header(std::span<const u8> data,
+                                                           packet_header &header,
+                                                           u32 &crc) noexcept {
+        std::optional<size_t> end = codec<Layout>::decode(data, header);
+        if (!end.has_value() || end.value() + CHECKSUM_BYTES > data.size()) {
+            return std::nullopt;
+        }
+
+        const size_t i = end.value();
+
+        u32 net_checksum{};
+        std::memcpy(&net_checksum, &data[i], sizeof(net_checksum));
+        header.checksum = ntohl(net_checksum);
 
-    // Header.
-    u16 net_magic{};
-    std::memcpy(&net_magic, &data[i], sizeof(net_magic));
-    header.magic = ntohs(net_magic);
-    i += 2;
+        constexpr std::array<u8, CHECKSUM_BYTES> zeroed{};
+        crc = crc32c(CRC32C_INITIAL, data.first(i));
+        crc = crc32c(crc, zeroed);
 
-    if (header.magic != packet_header{}.magic) {
+        return i + CHECKSUM_BYTES;
+    }
+}  // namespace
+
+std::optional<packet> packet::deserialise(const std::vector<u8> &data) {
+    if (data.empty()) {
         return std::nullopt;
     }
 
-    header.version = data[i++];
-    header.flags = data[i++];
+    packet_header header;
+    u32 crc = 0;
+
+    // NOTE: The full layout leads with the magic, whose first byte no version number shares.
+    std::optional<size_t> start =
+        (data[0] == COMPACT_VERSION)
+            ? deserialise_header<layout::compact>(data, header, crc)
+            : deserialise_header<layout::full>(data, header, crc);
+    if (!start.has_value()) {
+        return std::nullopt;
+    }
 
-    u32 net_seqnum{};
-    std::memcpy(&net_seqnum, &data[i], sizeof(net_seqnum));
-    header.seqnum = ntohl(net_seqnum);
-    i += 4;
+    size_t i = start.value();
+    packet packet(header);
 
-    u32 net_acknum{};
-    std::memcpy(&net_acknum, &data[i], sizeof(net_acknum));
-    header.acknum = ntohl(net_acknum);
-    i += 4;
+    if (header.flags & static_cast<u8>(flag::OPT)) {
+        if (i >= data.size() || data[i] > MAX_OPTION_BYTES || i + 1 + data[i] > data.size()) {
+            return std::nullopt;
+        }
 
-    u32 net_length{};
-    std::memcpy(&net_length, &data[i], sizeof(net_length));
-    header.length = ntohl(net_length);
-    i += 4;
+        const std::span<const u8> area = std::span(data).subspan(i, 1 + data[i]);
+        if (!valid_options(area.subspan(1))) {
+            return std::nullopt;
+        }
 
-    packet packet(header);
+        crc = crc32c(crc, area);
+        std::memcpy(packet.m_options.data(), area.data() + 1, area.size() - 1);
+        packet.m_options_size = area.size() - 1;
+        packet.header.flags &= static_cast<u8>(~static_cast<u8>(flag::OPT));
+        i += area.size();
+    }
 
-    // Data.
-    if (header.length > 0) {
+    // Data. NOTE: A marker for an abandoned segment carries its length but none of its payload.
+    if (header.length > 0 && !(header.flags & static_cast<u8>(flag::SKIP))) {
         if (i + header.length > data.size()) {
             return std::nullopt;
         }
@@ -102,35 +321,72 @@ std::optional<packet> packet::deserialise(const std::vector<u8> &data) {
         size_t copy = std::min(static_cast<size_t>(header.length),
                                static_cast<size_t>(constants::MAX_DATA_BYTES));
 
-        packet.m_data.assign(
-            data.begin() + static_cast<std::vector<u8>::difference_type>(i),
-            data.begin() + static_cast<std::vector<u8>::difference_type>(i + copy));
+        // NOTE: Checked as it is copied out, so the payload is only read once.
+        packet.m_data.resize(copy);
+        crc = crc32c_copy(crc, std::span(data).subspan(i, copy), packet.m_data.data());
+    }
+
+    // NOTE: Corruption the UDP checksum misses, or which it was never asked to catch, is treated
+    // as loss.
+    if (crc32c_finish(crc) != header.checksum) {
+        return std::nullopt;
     }
 
     return packet;
 }
 
-const std::vector<u8> &packet::data() const noexcept {
-    return m_data;
+std::span<const u8> packet::data() const noexcept {
+    return m_view.empty() ? std::span<const u8>(m_data) : m_view;
 }
 
-void packet::push_data(u8 byte) noexcept {
-    m_data.push_back(byte);
+std::vector<u8> packet::take_data() noexcept {
+    return std::move(m_data);
 }
 
-ssize_t packet::sendto(linuxfd_t fd, const packet &packet, const sockaddr_in *addr) {
-    std::vector<u8> serialised = packet.serialise();
+void packet::assign_data(std::vector<u8> data) noexcept {
+    m_data = std::move(data);
+    m_view = {};
+    m_owner = nullptr;
+}
+
+void packet::view_data(std::span<const u8> data, std::shared_ptr<const void> owner) noexcept {
+    m_data.clear();
+    m_view = data;
+    m_owner = std::move(owner);
+}
+
+ssize_t packet::sendto(transport &transport, const packet &packet, const sockaddr_in *addr,
+                       layout layout, ecn codepoint) {
+    header_bytes header{};
+    const std::span<const u8> options = std::span(packet.m_options).first(packet.m_options_size);
+    const size_t header_len = (layout == layout::compact)
+                                  ? serialise_header<layout::compact>(packet, options, header)
+                                  : serialise_header<layout::full>(packet, options, header);
+    std::span<const u8> data = packet.data();
+
+    // NOTE: The payload goes to the transport straight from wherever it lives.
+    const std::array<iovec, 2> iov{{
+        {.iov_base = header.data(), .iov_len = header_len},
+        {.iov_base = const_cast<u8 *>(data.data()), .iov_len = data.size()},
+    }};
+
+    return simulator::sendmsg(transport, std::span(iov).first(data.empty() ? 1 : 2), *addr,
+                              codepoint);
+}
+
+bool packet::add_option(option kind, std::span<const u8> value) noexcept {
+    return append_option(m_options, m_options_size, kind, value);
+}
 
-    return simulator::sendto(fd, serialised.data(), serialised.size(), 0,
-                             reinterpret_cast<const sockaddr *>(addr), sizeof(*addr));
+std::optional<std::span<const u8>> packet::find_option(option kind) const noexcept {
+    return internal::find_option(std::span(m_options).first(m_options_size), kind);
 }
 
-std::optional<packet> packet::recvfrom(linuxfd_t fd, sockaddr_in *addr) {
-    std::vector<u8> buffer(sizeof(packet_header) + constants::MAX_DATA_BYTES);
+std::optional<packet> packet::recvfrom(transport &transport, sockaddr_in *addr,
+                                       arrival *arrival) {
+    std::vector<u8> buffer(MAX_DATAGRAM_BYTES);
 
-    socklen_t addrlen = sizeof(sockaddr_in);
-    ssize_t bytes = ::recvfrom(fd, buffer.data(), buffer.size(), 0,
-                               reinterpret_cast<sockaddr *>(addr), &addrlen);
+    ssize_t bytes = transport.recvfrom(buffer.data(), buffer.size(), addr, arrival);
     if (bytes <= 0) {
         return std::nullopt;
     }
@@ -0,0 +1,126 @@
+#include "internal/recv_queue.hpp"
+
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+void recv_queue::push(std::vector<u8> &&payload, bool ends_record) noexcept {
+    if (payload.empty()) {
+        return;
+    }
+
+    m_size += payload.size();
+    if (ends_record) {
+        m_records++;
+    }
+
+    m_chunks.push_back({std::make_shared<const std::vector<u8>>(std::move(payload)), ends_record});
+}
+
+size_t recv_queue::copy(u8 *output, size_t len, bool peek) noexcept {
+    const iovec iov{.iov_base = output, .iov_len = len};
+    return copy(std::span(&iov, 1), peek);
+}
+
+size_t recv_queue::copy(std::span<const iovec> iov, bool peek) noexcept {
+    const size_t copied = gather(iov, m_chunks.end());
+    if (!peek) {
+        consume(copied);
+    }
+
+    return copied;
+}
+
+size_t recv_queue::copy_record(std::span<const iovec> iov, bool peek, bool *truncated) noexcept {
+    RUDP_ASSERT(m_records > 0, "Only a complete record can be copied out.");
+
+    size_t length = 0;
+    auto end = m_chunks.begin();
+    while (true) {
+        length += end->payload->size();
+        if ((end++)->ends_record) {
+            break;
+        }
+    }
+    length -= m_offset;
+
+    const size_t copied = gather(iov, end);
+    *truncated = copied < length;
+
+    if (!peek) {
+        consume(length);
+    }
+
+    return copied;
+}
+
+std::span<const u8> recv_queue::loan(chunk *owner) noexcept {
+    RUDP_ASSERT(!m_chunks.empty(), "A payload can only be loaned from a non-empty queue.");
+
+    *owner = m_chunks.front().payload;
+    std::span<const u8> remainder = std::span(**owner).subspan(m_offset);
+    consume(remainder.size());
+
+    return remainder;
+}
+
+size_t recv_queue::gather(std::span<const iovec> iov,
+                          std::deque<entry>::const_iterator end) const noexcept {
+    size_t copied = 0;
+    size_t offset = m_offset;
+    auto it = m_chunks.begin();
+
+    for (const iovec &buffer : iov) {
+        u8 *output = static_cast<u8 *>(buffer.iov_base);
+        size_t filled = 0;
+
+        while (filled < buffer.iov_len && it != end) {
+            const std::vector<u8> &payload = *it->payload;
+            const size_t take = std::min(buffer.iov_len - filled, payload.size() - offset);
+
+            std::memcpy(output + filled, payload.data() + offset, take);
+            filled += take;
+            offset += take;
+
+            if (offset == payload.size()) {
+                offset = 0;
+                ++it;
+            }
+        }
+
+        copied += filled;
+    }
+
+    return copied;
+}
+
+void recv_queue::consume(size_t len) noexcept {
+    RUDP_ASSERT(len <= m_size, "Only buffered bytes can be consumed.");
+    m_size -= len;
+
+    while (len > 0) {
+        const size_t available = m_chunks.front().payload->size() - m_offset;
+        if (len < available) {
+            m_offset += len;
+            return;
+        }
+
+        len -= available;
+        m_offset = 0;
+        if (m_chunks.front().ends_record) {
+            m_records--;
+        }
+        m_chunks.pop_front();
+    }
+}
+
+}  // namespace rudp::internal
@@ -0,0 +1,152 @@
+#include "internal/reorder_queue.hpp"
+
+#include <netinet/in.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+#include "internal/packet.hpp"
+
+namespace rudp::internal {
+
+bool reorder_queue::insert(const packet &packet, const sockaddr_in &peer, u32 acknum) noexcept {
+    const packet_header &header = packet.header;
+    RUDP_ASSERT(header.seqnum >= acknum, "Only a packet ahead of acknum is held for reordering.");
+
+    if (header.seqnum - acknum + header.length > CAPACITY) {
+        return false;
+    }
+
+    if (!m_ring) {
+        m_ring = std::make_unique<u8[]>(CAPACITY);
+        m_starts = std::make_unique<u64[]>(CAPACITY / WORD_BITS);
+        m_packets.reserve(constants::MAX_INFLIGHT_PACKETS);
+        m_waiting.reserve(constants::MAX_INFLIGHT_PACKETS);
+    }
+
+    if (m_packets.empty()) {
+        m_base = acknum;
+    }
+
+    auto [it, created] = m_packets.try_emplace(
+        header.seqnum,
+        received_packet{.header = header, .peer = peer, .filled = false, .delivered = false});
+    received_packet *received = &it->second;
+
+    if (created) {
+        const size_t bit = header.seqnum & (CAPACITY - 1);
+        m_starts[bit / WORD_BITS] |= u64{1} << (bit % WORD_BITS);
+    } else {
+        received->header.flags |= header.flags;
+        received->header.acknum = std::max(received->header.acknum, header.acknum);
+    }
+
+    const std::span<const u8> data = packet.data();
+    if (!data.empty() && !received->filled) {
+        // NOTE: A payload which runs off the end of the ring wraps around to the start.
+        const size_t start = header.seqnum & (CAPACITY - 1);
+        const size_t first = std::min(data.size(), CAPACITY - start);
+        std::memcpy(m_ring.get() + start, data.data(), first);
+        std::memcpy(m_ring.get(), data.data() + first, data.size() - first);
+
+        // NOTE: The header of the packet with the payload wins, bar what the others acknowledged.
+        const u8 flags = received->header.flags;
+        const u32 acknowledged = received->header.acknum;
+        received->header = header;
+        received->header.flags = flags;
+        received->header.acknum = acknowledged;
+        received->filled = true;
+    }
+
+    const bool skip = received->header.flags & static_cast<u8>(flag::SKIP);
+    if ((received->filled || skip) && !received->delivered) {
+        m_waiting.try_emplace(waiting_key(received->header.stream, received->header.offset),
+                              received->header.seqnum);
+    }
+
+    return true;
+}
+
+std::vector<u8> reorder_queue::read(const received_packet &received) const noexcept {
+    RUDP_ASSERT(received.filled, "Only a packet whose payload arrived can be read.");
+
+    const size_t start = received.header.seqnum & (CAPACITY - 1);
+    const size_t len = received.header.length;
+    const size_t first = std::min(len, CAPACITY - start);
+
+    std::vector<u8> payload(len);
+    std::memcpy(payload.data(), m_ring.get() + start, first);
+    std::memcpy(payload.data() + first, m_ring.get(), len - first);
+    return payload;
+}
+
+std::optional<received_packet> reorder_queue::pop(u32 seqnum) noexcept {
+    auto it = m_packets.find(seqnum);
+    if (it == m_packets.end()) {
+        return std::nullopt;
+    }
+
+    received_packet popped = it->second;
+    erase(seqnum);
+    return popped;
+}
+
+received_packet *reorder_queue::take_waiting(u16 stream, u32 offset) noexcept {
+    auto it = m_waiting.find(waiting_key(stream, offset));
+    if (it == m_waiting.end()) {
+        return nullptr;
+    }
+
+    auto found = m_packets.find(it->second);
+    m_waiting.erase(it);
+    RUDP_ASSERT(found != m_packets.end(), "A waiting packet must be held.");
+
+    found->second.delivered = true;
+    return &found->second;
+}
+
+void reorder_queue::release(u32 acknum) noexcept {
+    // NOTE: A word of the bitmap at a time, each set bit a packet which the gap's filling passed.
+    u32 seqnum = m_base;
+    const u32 end = m_base + static_cast<u32>(std::min<size_t>(acknum - m_base, CAPACITY));
+    while (seqnum != end && !m_packets.empty()) {
+        const size_t bit = seqnum & (CAPACITY - 1);
+        const size_t count = std::min<size_t>(end - seqnum, WORD_BITS - bit % WORD_BITS);
+
+        u64 word = m_starts[bit / WORD_BITS] >> (bit % WORD_BITS);
+        if (count < WORD_BITS) {
+            word &= (u64{1} << count) - 1;
+        }
+
+        for (; word != 0; word &= word - 1) {
+            erase(seqnum + static_cast<u32>(std::countr_zero(word)));
+        }
+        seqnum += static_cast<u32>(count);
+    }
+
+    m_base = acknum;
+}
+
+void reorder_queue::erase(u32 seqnum) noexcept {
+    auto it = m_packets.find(seqnum);
+    RUDP_ASSERT(it != m_packets.end(), "Only a held packet can be erased.");
+
+    const packet_header &header = it->second.header;
+    auto waiting = m_waiting.find(waiting_key(header.stream, header.offset));
+    if (waiting != m_waiting.end() && waiting->second == seqnum) {
+        m_waiting.erase(waiting);
+    }
+
+    const size_t bit = seqnum & (CAPACITY - 1);
+    m_starts[bit / WORD_BITS] &= ~(u64{1} << (bit % WORD_BITS));
+    m_packets.erase(it);
+}
+
+}  // namespace rudp::internal
@@ -1,25 +1,242 @@
 #include <sys/fcntl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 // TODO: Check imports project-wide.
 #include <algorithm>
+#include <chrono>
+#include <climits>
 #include <cstdio>
 #include <cstring>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <rudp.hpp>
+#include <span>
 
 #include "internal/assert.hpp"
 #include "internal/common.hpp"
 #include "internal/connection.hpp"
+#include "internal/epoll.hpp"
 #include "internal/event_loop.hpp"
+#include "internal/fec.hpp"
 #include "internal/listener.hpp"
 #include "internal/socket.hpp"
+#include "internal/transport.hpp"
 
 namespace rudp {
+namespace {
+    // NOTE: As with sendmsg(2) and recvmsg(2), too many buffers is EMSGSIZE and a buffer which is
+    // missing is EFAULT. The control and name fields are not read.
+    [[nodiscard]] bool validate_msghdr(const struct msghdr *msg) noexcept {
+        if (msg == nullptr || (msg->msg_iovlen > 0 && msg->msg_iov == nullptr)) {
+            errno = EFAULT;
+            return false;
+        }
+
+        if (msg->msg_iovlen > IOV_MAX) {
+            errno = EMSGSIZE;
+            return false;
+        }
+
+        size_t len = 0;
+        for (const iovec &buffer : std::span(msg->msg_iov, msg->msg_iovlen)) {
+            if (buffer.iov_base == nullptr && buffer.iov_len > 0) {
+                errno = EFAULT;
+                return false;
+            }
+
+            len += buffer.iov_len;
+            if (len > static_cast<size_t>(std::numeric_limits<ssize_t>::max())) {
+                errno = EINVAL;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // NOTE: The shared body of send(), sendmsg(), send_stream() and send_pr(), once the buffers
+    // have been validated.
+    [[nodiscard]] ssize_t send_iov(int sockfd, u16 id, std::span<const iovec> iov, int flags,
+                                   internal::reliability policy = {}) noexcept {
+        // Socket validation.
+        internal::socket *found = internal::find_socket(sockfd);
+        if (found == nullptr) {
+            errno = EBADF;
+            return -1;
+        }
+
+        internal::socket &sock = *found;
+        if (!sock.connected()) {
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+
+        // NOTE: In message mode a send is one record, which is buffered whole or not at all, as is
+        // a partially reliable message.
+        const size_t len = internal::iov_length(iov);
+        const bool messages = sock.opts.messages;
+        const bool whole = messages || policy.partial();
+
+        if (messages && len > internal::constants::MAX_SEND_BUFFER_BYTES) {
+            errno = EMSGSIZE;
+            return -1;
+        }
+
+        internal::connection *connection = sock.connection();
+        internal::stream *stream =
+            connection->synchronise([&]() { return connection->find_stream(id); });
+        if (stream == nullptr) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        // Block, unless non-blocking, until there is space on the buffer.
+        const bool nonblocking = sock.nonblocking() || (flags & MSG_DONTWAIT);
+
+        if (nonblocking) {
+            if (!connection->established()) {
+                errno = EAGAIN;
+                return -1;
+            }
+        } else {
+            connection->wait_for_established();
+            connection->wait_for_send_space(id, whole ? len : 1);
+        }
+
+        // Fill out the available space on the buffer, from every buffer under the one lock.
+        bool was_empty = false;
+        ssize_t copied = connection->synchronise([&]() {
+            const size_t space =
+                internal::constants::MAX_SEND_BUFFER_BYTES - stream->send_buffer.size();
+            if (whole && space < len) {
+                return static_cast<ssize_t>(0);
+            }
+
+            const size_t copy = std::min(len, static_cast<size_t>(space));
+            if (copy > 0) {
+                was_empty = stream->send_buffer.empty();
+            }
+
+            if (policy.partial()) {
+                RUDP_ASSERT(iov.size() == 1, "send_pr() sends from a single buffer.");
+                stream->send_buffer.push_message(static_cast<const u8 *>(iov[0].iov_base), len,
+                                                 policy);
+                if (messages) {
+                    stream->send_buffer.end_record();
+                }
+
+                return static_cast<ssize_t>(len);
+            }
+
+            size_t remaining = copy;
+            for (const iovec &buffer : iov) {
+                const size_t take = std::min(buffer.iov_len, remaining);
+                stream->send_buffer.push(static_cast<const u8 *>(buffer.iov_base), take);
+                remaining -= take;
+            }
+
+            if (messages) {
+                stream->send_buffer.end_record();
+            }
+
+            return static_cast<ssize_t>(copy);
+        });
+
+        // NOTE: A non-empty buffer is already waiting on the event loop, e.g. for the window to
+        // open.
+        if (was_empty) {
+            auto [err, event_loop] = internal::event_loop::instance();
+            RUDP_ASSERT(err == internal::event_loop::result::error::none && event_loop != nullptr,
+                        "A connected socket must have a running event loop.");
+            event_loop->wake();
+        }
+
+        if (copied == 0) {
+            RUDP_ASSERT(nonblocking, "A blocking send() must wait for space on the buffer.");
+            errno = EAGAIN;
+            return -1;
+        }
+
+        return copied;
+    }
+
+    // NOTE: The shared body of recv(), recvmsg() and recv_stream(), once the buffers have been
+    // validated. A truncated record is reported through msg_flags, if given.
+    [[nodiscard]] ssize_t recv_iov(int sockfd, u16 id, std::span<const iovec> iov, int flags,
+                                   int *msg_flags = nullptr) noexcept {
+        // Socket validation.
+        internal::socket *found = internal::find_socket(sockfd);
+        if (found == nullptr) {
+            errno = EBADF;
+            return -1;
+        }
+
+        internal::socket &sock = *found;
+        if (!sock.connected()) {
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+
+        internal::connection *connection = sock.connection();
+        internal::stream *stream =
+            connection->synchronise([&]() { return connection->find_stream(id); });
+        if (stream == nullptr) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        // Block, unless non-blocking, until there is data on the buffer; with MSG_WAITALL, until
+        // there is enough to fill every buffer, or in message mode, until there is a whole record.
+        const bool nonblocking = sock.nonblocking() || (flags & MSG_DONTWAIT);
+
+        if (nonblocking) {
+            if (!connection->established()) {
+                errno = EAGAIN;
+                return -1;
+            }
+        } else {
+            connection->wait_for_established();
+            connection->wait_for_recv_data(id,
+                                           (flags & MSG_WAITALL) ? internal::iov_length(iov) : 1);
+        }
+
+        // Pull what is available on the buffer, leaving it there if peeking.
+        const bool peek = (flags & MSG_PEEK) != 0;
+        bool truncated = false;
+
+        ssize_t copied = connection->synchronise([&]() {
+            internal::recv_queue &buffer = stream->recv_buffer;
+            if (!sock.opts.messages) {
+                return static_cast<ssize_t>(buffer.copy(iov, peek));
+            }
+
+            if (buffer.records() == 0) {
+                return static_cast<ssize_t>(0);
+            }
+
+            return static_cast<ssize_t>(buffer.copy_record(iov, peek, &truncated));
+        });
+
+        if (truncated && msg_flags != nullptr) {
+            *msg_flags |= MSG_TRUNC;
+        }
+
+        if (copied == 0) {
+            RUDP_ASSERT(nonblocking, "A blocking recv() must wait for data on the buffer.");
+            errno = EAGAIN;
+            return -1;
+        }
+
+        return copied;
+    }
+}  // namespace
 
 int socket(void) noexcept {
     rudpfd_t fd = internal::g_next_fd++;
-    internal::g_sockets.try_emplace(fd);
+    internal::insert_socket(fd, internal::socket{});
     return fd;
 }
 
@@ -41,34 +258,33 @@ int bind(int sockfd, struct sockaddr *addr, socklen_t addrlen) noexcept {
     }
 
     // Socket validation.
-    auto sock_it = internal::g_sockets.find(sockfd);
-    if (sock_it == internal::g_sockets.end()) {
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
         errno = EBADF;
         return -1;
     }
 
-    internal::socket &sock = sock_it->second;
+    internal::socket &sock = *found;
     if (!sock.created()) {
         errno = EOPNOTSUPP;
         return -1;
     }
 
-    // Create and bind an underlying FD.
-    linuxfd_t fd = internal::create_raw_socket();
-    if (fd < 0) {
-        // NOTE: errno is forwarded from socket() or fcntl().
+    // Create and bind an underlying transport.
+    std::shared_ptr<internal::transport> transport =
+        internal::transport::create(sock.opts.transport_kind);
+    if (!transport) {
+        // NOTE: errno is forwarded from the transport's creation.
         return -1;
     }
 
-    if (::bind(fd, addr, addrlen) < 0) {
-        int saved = errno;
-        ::close(fd);
-        errno = saved;
+    if (transport->bind(*reinterpret_cast<sockaddr_in *>(addr)) < 0) {
+        // NOTE: errno is forwarded from the transport's bind().
         return -1;
     }
 
     // Transition state.
-    sock.data = fd;
+    sock.transition(std::move(transport));
     return 0;
 }
 
@@ -84,24 +300,25 @@ int listen(int sockfd, int backlog) noexcept {
     }
 
     // Socket validation.
-    auto sock_it = internal::g_sockets.find(sockfd);
-    if (sock_it == internal::g_sockets.end()) {
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
         errno = EBADF;
         return -1;
     }
 
-    internal::socket &sock = sock_it->second;
+    internal::socket &sock = *found;
     if (!sock.bound()) {
         errno = EOPNOTSUPP;
         return -1;
     }
 
-    linuxfd_t fd = sock.fd();
-    RUDP_ASSERT(internal::is_valid_sockfd(fd),
+    std::shared_ptr<internal::transport> transport = sock.transport();
+    RUDP_ASSERT(internal::is_valid_fd(transport->fd()),
                 "A bound socket must have a valid underlying file descriptor.");
 
     // Create and initialise the listener.
-    auto listener = std::make_unique<internal::listener>(fd, backlog);
+    auto listener = std::make_unique<internal::listener>(transport, sock.opts, backlog,
+                                                         sock.readiness);
     if (!listener) {
         errno = ENOMEM;
         return -1;
@@ -109,7 +326,7 @@ int listen(int sockfd, int backlog) noexcept {
 
     auto [err, event_loop] = internal::event_loop::instance();
     if (err != internal::event_loop::result::error::none) {
-        // NOTE: errno is already set in the epoll_creation case.
+        // NOTE: errno is already set in the epoll_creation and wakeup_creation cases.
         if (err == internal::event_loop::result::error::thread_creation) {
             errno = ENOMEM;
         }
@@ -118,18 +335,23 @@ int listen(int sockfd, int backlog) noexcept {
     }
     event_loop->assert_initialised_state(__PRETTY_FUNCTION__);
 
-    if (!event_loop->add_handler(internal::handler_type::listener, fd,
+    if (!event_loop->add_handler(internal::handler_type::listener, transport->fd(),
                                  [listener = listener.get()]() { listener->handle_events(); })) {
         // NOTE: errno is forwarded from epoll_ctl().
         return -1;
     }
 
     // Transition state.
-    sock.data = std::move(listener);
+    sock.transition(std::move(listener));
     return 0;
 }
 
 int accept(int sockfd, struct sockaddr *addr, socklen_t *addrlen) noexcept {
+    return internal::accept_socket(sockfd, addr, addrlen, 0);
+}
+
+int internal::accept_socket(int sockfd, struct sockaddr *addr, socklen_t *addrlen,
+                            int flags) noexcept {
     bool fillout_peer_addr = (addr != nullptr);
 
     // Argument validation.
@@ -146,36 +368,41 @@ int accept(int sockfd, struct sockaddr *addr, socklen_t *addrlen) noexcept {
     }
 
     // Socket validation.
-    auto sock_it = internal::g_sockets.find(sockfd);
-    if (sock_it == internal::g_sockets.end()) {
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
         errno = EBADF;
         return -1;
     }
 
-    internal::socket &sock = sock_it->second;
+    internal::socket &sock = *found;
     if (!sock.listening()) {
         errno = EOPNOTSUPP;
         return -1;
     }
 
-    // Block until we have a connection to return.
+    // Block, unless non-blocking, until we have a connection to return.
     internal::listener *listener = sock.listener();
     RUDP_ASSERT(listener != nullptr, "A listening socket's unique_ptr must be non-null.");
 
-    rudpfd_t fd = listener->wait_and_accept();
-    RUDP_ASSERT(internal::g_sockets.contains(fd),
-                "wait_and_accept() must return a valid rudpfd_t.");
-    RUDP_ASSERT(internal::g_sockets.at(fd).connected(),
-                "A socket freshly spawned by listen() must be connected.");
+    const bool nonblocking = sock.nonblocking() || (flags & MSG_DONTWAIT);
+    std::optional<rudpfd_t> ready =
+        nonblocking ? listener->try_accept() : listener->wait_and_accept();
+    if (!ready.has_value()) {
+        errno = EAGAIN;
+        return -1;
+    }
 
-    auto &spawned = internal::g_sockets.at(fd);
+    rudpfd_t fd = ready.value();
+    internal::socket *spawned = internal::find_socket(fd);
+    RUDP_ASSERT(spawned != nullptr, "wait_and_accept() must return a valid rudpfd_t.");
+    RUDP_ASSERT(spawned->connected(), "A socket freshly spawned by listen() must be connected.");
 
     // Conditionally fill out the peer address information.
     if (fillout_peer_addr) {
         RUDP_ASSERT(addrlen != nullptr,
                     "addrlen must be validated as non-null when filling out the peer address.");
 
-        struct sockaddr_in peer_addr = spawned.connection()->peer();
+        struct sockaddr_in peer_addr = spawned->connection()->peer();
         memcpy(addr, &peer_addr, std::min(static_cast<unsigned long>(*addrlen), sizeof(peer_addr)));
         *addrlen = sizeof(peer_addr);
     }
@@ -184,6 +411,11 @@ int accept(int sockfd, struct sockaddr *addr, socklen_t *addrlen) noexcept {
 }
 
 int connect(int sockfd, struct sockaddr *addr, socklen_t addrlen) noexcept {
+    return internal::connect_socket(sockfd, addr, addrlen, 0);
+}
+
+int internal::connect_socket(int sockfd, struct sockaddr *addr, socklen_t addrlen,
+                             int flags) noexcept {
     // Argument validation.
     if (addr == nullptr) {
         errno = EFAULT;
@@ -201,13 +433,18 @@ int connect(int sockfd, struct sockaddr *addr, socklen_t addrlen) noexcept {
     }
 
     // Socket validation.
-    auto sock_it = internal::g_sockets.find(sockfd);
-    if (sock_it == internal::g_sockets.end()) {
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
         errno = EBADF;
         return -1;
     }
 
-    internal::socket &sock = sock_it->second;
+    internal::socket &sock = *found;
+    if (sock.connected() && !sock.connection()->established()) {
+        errno = EALREADY;
+        return -1;
+    }
+
     if (!sock.created() && !sock.bound()) {
         errno = EOPNOTSUPP;
         return -1;
@@ -229,12 +466,12 @@ int connect(int sockfd, struct sockaddr *addr, socklen_t addrlen) noexcept {
         }
     }
 
-    linuxfd_t fd = sock.fd();
-    RUDP_ASSERT(internal::is_valid_sockfd(fd),
+    std::shared_ptr<internal::transport> transport = sock.transport();
+    RUDP_ASSERT(internal::is_valid_fd(transport->fd()),
                 "A bound socket must have a valid underlying file descriptor.");
 
     // Create and register the connection.
-    auto connection = std::make_unique<internal::connection>(fd);
+    auto connection = std::make_unique<internal::connection>(transport, sock.opts, sock.readiness);
     if (!connection) {
         errno = ENOMEM;
         return -1;
@@ -242,7 +479,7 @@ int connect(int sockfd, struct sockaddr *addr, socklen_t addrlen) noexcept {
 
     auto [err, event_loop] = internal::event_loop::instance();
     if (err != internal::event_loop::result::error::none) {
-        // NOTE: errno is already set in the epoll_creation case.
+        // NOTE: errno is already set in the epoll_creation and wakeup_creation cases.
         if (err == internal::event_loop::result::error::thread_creation) {
             errno = ENOMEM;
         }
@@ -251,23 +488,36 @@ int connect(int sockfd, struct sockaddr *addr, socklen_t addrlen) noexcept {
     }
     event_loop->assert_initialised_state(__PRETTY_FUNCTION__);
 
+    // NOTE: The SYN is sent before the handler is registered, so that the event loop cannot handle
+    // the SYNACK before the SYN is recorded as sent. The SYNACK waits on the socket until then.
+    if (!connection->active_open(*reinterpret_cast<sockaddr_in *>(addr))) {
+        // NOTE: errno is forwarded from sendto().
+        return -1;
+    }
+
     if (!event_loop->add_handler(
-            internal::handler_type::connection, fd,
+            internal::handler_type::connection, transport->fd(),
             [connection = connection.get()]() { connection->handle_events(); })) {
         // NOTE: errno is forwarded from epoll_ctl().
         return -1;
     }
 
-    // Block until a connection is established.
-    if (!connection->active_open(*reinterpret_cast<sockaddr_in *>(addr))) {
-        event_loop->remove_handler(internal::handler_type::connection, fd);
-        // NOTE: errno is forwarded from sendto().
-        return -1;
+    // Block, unless non-blocking, until a connection is established.
+    const bool nonblocking = sock.nonblocking() || (flags & MSG_DONTWAIT);
+    if (!nonblocking) {
+        connection->wait_for_established();
     }
-    connection->wait_for_established();
 
     // Transition state.
-    sock.data = std::move(connection);
+    // NOTE: A non-blocking socket is connected from here on, but send() and recv() report EAGAIN
+    // and connect() reports EALREADY until the handshake completes.
+    sock.transition(std::move(connection));
+
+    if (nonblocking) {
+        errno = EINPROGRESS;
+        return -1;
+    }
+
     return 0;
 }
 
@@ -276,7 +526,7 @@ RUDP_STATIC_ASSERT(
         std::numeric_limits<decltype(internal::constants::MAX_SEND_BUFFER_BYTES)>::max(),
     "send()'s cast of constants::MAX_SEND_BUFFER_BYTES to a ssize_t must be value-preserving.");
 
-ssize_t send(int sockfd, const void *buf, size_t len, int /** flags */) noexcept {
+ssize_t send(int sockfd, const void *buf, size_t len, int flags) noexcept {
     // Argument validation.
     if (buf == nullptr) {
         errno = EFAULT;
@@ -287,38 +537,146 @@ ssize_t send(int sockfd, const void *buf, size_t len, int /** flags */) noexcept
         return 0;
     }
 
+    const iovec iov{.iov_base = const_cast<void *>(buf), .iov_len = len};
+    return send_iov(sockfd, internal::connection::DEFAULT_STREAM, std::span(&iov, 1), flags);
+}
+
+ssize_t sendmsg(int sockfd, const struct msghdr *msg, int flags) noexcept {
+    // Argument validation.
+    if (!validate_msghdr(msg)) {
+        return -1;
+    }
+
+    const std::span<const iovec> iov(msg->msg_iov, msg->msg_iovlen);
+    if (internal::iov_length(iov) == 0) {
+        return 0;
+    }
+
+    return send_iov(sockfd, internal::connection::DEFAULT_STREAM, iov, flags);
+}
+
+ssize_t send_zc(int sockfd, const void *buf, size_t len, int flags) noexcept {
+    // Argument validation.
+    if (buf == nullptr) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    // Socket validation.
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
+        errno = EBADF;
+        return -1;
+    }
+
+    internal::socket &sock = *found;
+    if (!sock.connected()) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+
+    // NOTE: As in send(), a record must be able to fit in the send buffer.
+    if (sock.opts.messages && len > internal::constants::MAX_SEND_BUFFER_BYTES) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    // Block, unless non-blocking, until established. The buffer takes no space, so that is all.
+    internal::connection *connection = sock.connection();
+    const bool nonblocking = sock.nonblocking() || (flags & MSG_DONTWAIT);
+
+    if (nonblocking) {
+        if (!connection->established()) {
+            errno = EAGAIN;
+            return -1;
+        }
+    } else {
+        connection->wait_for_established();
+    }
+
+    // Queue the buffer itself, under the next id.
+    bool was_empty = false;
+    connection->synchronise([&]() {
+        internal::send_queue &buffer = connection->default_stream().send_buffer;
+
+        was_empty = buffer.empty();
+        buffer.push_borrowed(std::span(static_cast<const u8 *>(buf), len),
+                             connection->zc_next_id++);
+        if (sock.opts.messages) {
+            buffer.end_record();
+        }
+    });
+
+    if (was_empty) {
+        auto [err, event_loop] = internal::event_loop::instance();
+        RUDP_ASSERT(err == internal::event_loop::result::error::none && event_loop != nullptr,
+                    "A connected socket must have a running event loop.");
+        event_loop->wake();
+    }
+
+    return static_cast<ssize_t>(len);
+}
+
+int send_zc_completions(int sockfd, uint32_t *first, uint32_t *last, int flags) noexcept {
+    // Argument validation.
+    if (first == nullptr || last == nullptr) {
+        errno = EFAULT;
+        return -1;
+    }
+
     // Socket validation.
-    auto sock_it = internal::g_sockets.find(sockfd);
-    if (sock_it == internal::g_sockets.end()) {
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
         errno = EBADF;
         return -1;
     }
 
-    internal::socket &sock = sock_it->second;
+    internal::socket &sock = *found;
     if (!sock.connected()) {
         errno = EOPNOTSUPP;
         return -1;
     }
 
-    // Fill out the available space on the buffer.
+    // Block, unless non-blocking, until a send completes.
     internal::connection *connection = sock.connection();
-    connection->wait_for_send_space();
+    const bool nonblocking = sock.nonblocking() || (flags & MSG_DONTWAIT);
 
-    return connection->synchronise([&]() {
-        const size_t space =
-            internal::constants::MAX_SEND_BUFFER_BYTES - connection->send_buffer.size();
-        const size_t copy = std::min(len, static_cast<size_t>(space));
+    if (nonblocking) {
+        if (!connection->established()) {
+            errno = EAGAIN;
+            return -1;
+        }
+    } else {
+        connection->wait_for_established();
+        connection->wait_for_zc_completion();
+    }
 
-        if (copy > 0) {
-            const u8 *data = static_cast<const u8 *>(buf);
-            connection->send_buffer.insert(connection->send_buffer.end(), data, data + copy);
+    // Report everything completed since we last reported.
+    bool reported = connection->synchronise([&]() {
+        if (connection->zc_completed() == connection->zc_reported) {
+            return false;
         }
 
-        return static_cast<ssize_t>(copy);
+        *first = connection->zc_reported;
+        *last = connection->zc_completed() - 1;
+        connection->zc_reported = connection->zc_completed();
+        return true;
     });
+
+    if (!reported) {
+        RUDP_ASSERT(nonblocking, "A blocking send_zc_completions() must wait for a completion.");
+        errno = EAGAIN;
+        return -1;
+    }
+
+    return 0;
 }
 
-ssize_t recv(int sockfd, void *buf, size_t len, int /** flags */) noexcept {
+ssize_t recv(int sockfd, void *buf, size_t len, int flags) noexcept {
     // Argument validation.
     if (buf == nullptr) {
         errno = EFAULT;
@@ -329,38 +687,642 @@ ssize_t recv(int sockfd, void *buf, size_t len, int /** flags */) noexcept {
         return 0;
     }
 
+    const iovec iov{.iov_base = buf, .iov_len = len};
+    return recv_iov(sockfd, internal::connection::DEFAULT_STREAM, std::span(&iov, 1), flags);
+}
+
+ssize_t recvmsg(int sockfd, struct msghdr *msg, int flags) noexcept {
+    // Argument validation.
+    if (!validate_msghdr(msg)) {
+        return -1;
+    }
+
+    // NOTE: A connected stream has no source address or ancillary data to report.
+    msg->msg_namelen = 0;
+    msg->msg_controllen = 0;
+    msg->msg_flags = 0;
+
+    const std::span<const iovec> iov(msg->msg_iov, msg->msg_iovlen);
+    if (internal::iov_length(iov) == 0) {
+        return 0;
+    }
+
+    return recv_iov(sockfd, internal::connection::DEFAULT_STREAM, iov, flags, &msg->msg_flags);
+}
+
+ssize_t recv_zc(int sockfd, const void **buf, int flags) noexcept {
+    // Argument validation.
+    if (buf == nullptr) {
+        errno = EFAULT;
+        return -1;
+    }
+
     // Socket validation.
-    auto sock_it = internal::g_sockets.find(sockfd);
-    if (sock_it == internal::g_sockets.end()) {
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
         errno = EBADF;
         return -1;
     }
 
-    internal::socket &sock = sock_it->second;
+    internal::socket &sock = *found;
     if (!sock.connected()) {
         errno = EOPNOTSUPP;
         return -1;
     }
 
-    // Pull what is available on the buffer.
+    // Block, unless non-blocking, until there is data on the buffer.
     internal::connection *connection = sock.connection();
-    connection->wait_for_recv_data();
-
-    return connection->synchronise([&]() {
-        const size_t available = connection->recv_buffer.size();
-        const size_t copy = std::min(len, available);
+    const bool nonblocking = sock.nonblocking() || (flags & MSG_DONTWAIT);
 
-        if (copy > 0) {
-            u8 *output = static_cast<u8 *>(buf);
+    if (nonblocking) {
+        if (!connection->established()) {
+            errno = EAGAIN;
+            return -1;
+        }
+    } else {
+        connection->wait_for_established();
+        connection->wait_for_recv_data(internal::connection::DEFAULT_STREAM);
+    }
 
-            for (size_t i = 0; i < copy; ++i) {
-                output[i] = connection->recv_buffer.front();
-                connection->recv_buffer.pop_front();
-            }
+    // Loan out the payload at the front of the buffer.
+    ssize_t loaned = connection->synchronise([&]() {
+        internal::recv_queue &buffer = connection->default_stream().recv_buffer;
+        if (buffer.empty()) {
+            return static_cast<ssize_t>(0);
         }
 
-        return static_cast<ssize_t>(copy);
+        internal::recv_queue::chunk owner;
+        std::span<const u8> payload = buffer.loan(&owner);
+
+        connection->loans.emplace(payload.data(), std::move(owner));
+        *buf = payload.data();
+        return static_cast<ssize_t>(payload.size());
     });
+
+    if (loaned == 0) {
+        RUDP_ASSERT(nonblocking, "A blocking recv_zc() must wait for data on the buffer.");
+        errno = EAGAIN;
+        return -1;
+    }
+
+    return loaned;
+}
+
+int release(int sockfd, const void *buf) noexcept {
+    // Socket validation.
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
+        errno = EBADF;
+        return -1;
+    }
+
+    internal::socket &sock = *found;
+    if (!sock.connected()) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+
+    // Drop our reference, freeing the payload.
+    internal::connection *connection = sock.connection();
+    if (connection->synchronise([&]() { return connection->loans.erase(buf); }) == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
+
+int on_data(int sockfd, data_callback callback) noexcept {
+    // Socket validation.
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
+        errno = EBADF;
+        return -1;
+    }
+
+    internal::socket &sock = *found;
+    if (!sock.connected()) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+
+    // Install the callback.
+    std::shared_ptr<const data_callback> installed;
+    if (callback) {
+        installed = std::make_shared<const data_callback>(std::move(callback));
+        if (!installed) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+
+    sock.connection()->on_data(std::move(installed));
+    return 0;
+}
+
+int open_stream(int sockfd) noexcept {
+    // Socket validation.
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
+        errno = EBADF;
+        return -1;
+    }
+
+    internal::socket &sock = *found;
+    if (!sock.connected()) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+
+    // Number the next stream of our own; the peer learns of it from its first byte.
+    std::optional<u16> opened = sock.connection()->open_stream();
+    if (!opened.has_value()) {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    return opened.value();
+}
+
+int accept_stream(int sockfd, int flags) noexcept {
+    // Socket validation.
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
+        errno = EBADF;
+        return -1;
+    }
+
+    internal::socket &sock = *found;
+    if (!sock.connected()) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+
+    // Block, unless non-blocking, until the peer opens a stream.
+    internal::connection *connection = sock.connection();
+    const bool nonblocking = sock.nonblocking() || (flags & MSG_DONTWAIT);
+
+    if (nonblocking) {
+        if (!connection->established()) {
+            errno = EAGAIN;
+            return -1;
+        }
+    } else {
+        connection->wait_for_established();
+        connection->wait_for_stream();
+    }
+
+    std::optional<u16> accepted = connection->accept_stream();
+    if (!accepted.has_value()) {
+        RUDP_ASSERT(nonblocking, "A blocking accept_stream() must wait for a stream.");
+        errno = EAGAIN;
+        return -1;
+    }
+
+    return accepted.value();
+}
+
+ssize_t send_stream(int sockfd, int stream, const void *buf, size_t len, int flags) noexcept {
+    // Argument validation.
+    if (buf == nullptr) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    if (stream < 0 || stream > std::numeric_limits<u16>::max()) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    const iovec iov{.iov_base = const_cast<void *>(buf), .iov_len = len};
+    return send_iov(sockfd, static_cast<u16>(stream), std::span(&iov, 1), flags);
+}
+
+ssize_t send_pr(int sockfd, int stream, const void *buf, size_t len, int policy, int value,
+                int flags) noexcept {
+    // NOTE: A reliable message is an ordinary send, so is neither held to one packet nor buffered
+    // whole.
+    if (policy == RUDP_PR_RELIABLE) {
+        return send_stream(sockfd, stream, buf, len, flags);
+    }
+
+    // Argument validation.
+    if (buf == nullptr) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    if (stream < 0 || stream > std::numeric_limits<u16>::max() || value < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (len > internal::constants::MAX_DATA_BYTES) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    internal::reliability reliability{};
+    switch (policy) {
+    case RUDP_PR_UNRELIABLE:
+        reliability.max_retransmits = 0;
+        break;
+    case RUDP_PR_DEADLINE:
+        reliability.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(value);
+        break;
+    case RUDP_PR_RETRANSMITS:
+        if (value >= internal::constants::MAX_RETRANSMITS) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        reliability.max_retransmits = static_cast<u8>(value);
+        break;
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+
+    const iovec iov{.iov_base = const_cast<void *>(buf), .iov_len = len};
+    return send_iov(sockfd, static_cast<u16>(stream), std::span(&iov, 1), flags, reliability);
+}
+
+ssize_t recv_stream(int sockfd, int stream, void *buf, size_t len, int flags) noexcept {
+    // Argument validation.
+    if (buf == nullptr) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    if (stream < 0 || stream > std::numeric_limits<u16>::max()) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+    const iovec iov{.iov_base = buf, .iov_len = len};
+    return recv_iov(sockfd, static_cast<u16>(stream), std::span(&iov, 1), flags);
+}
+
+int setsockopt(int sockfd, int level, int optname, const void *optval, socklen_t optlen) noexcept {
+    // Argument validation.
+    if (optval == nullptr) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    if (level != SOL_RUDP) {
+        errno = ENOPROTOOPT;
+        return -1;
+    }
+
+    // Socket validation.
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
+        errno = EBADF;
+        return -1;
+    }
+
+    internal::socket &sock = *found;
+
+    // Apply the option.
+    switch (optname) {
+    case RUDP_TRANSPORT: {
+        if (optlen != sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        if (!sock.created()) {
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+
+        int value{};
+        memcpy(&value, optval, sizeof(value));
+
+        if (value == RUDP_TRANSPORT_UDP) {
+            sock.opts.transport_kind = internal::transport::kind::udp;
+        } else if (value == RUDP_TRANSPORT_LOOPBACK) {
+            sock.opts.transport_kind = internal::transport::kind::loopback;
+        } else {
+            errno = EINVAL;
+            return -1;
+        }
+
+        return 0;
+    }
+    case RUDP_SHM: {
+        if (optlen != sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        if (!sock.created() && !sock.bound()) {
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+
+        int value{};
+        memcpy(&value, optval, sizeof(value));
+        sock.opts.shm = (value != 0);
+        return 0;
+    }
+    case RUDP_MESSAGES: {
+        if (optlen != sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        if (!sock.created() && !sock.bound()) {
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+
+        int value{};
+        memcpy(&value, optval, sizeof(value));
+        sock.opts.messages = (value != 0);
+        return 0;
+    }
+    case RUDP_FEC: {
+        if (optlen != sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        if (!sock.created() && !sock.bound()) {
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+
+        int value{};
+        memcpy(&value, optval, sizeof(value));
+        if (value < 0 || static_cast<size_t>(value) > internal::MAX_FEC_GROUP) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        sock.opts.fec_group = static_cast<u8>(value);
+        return 0;
+    }
+    case RUDP_COMPRESSION: {
+        if (optlen != sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        if (!sock.created() && !sock.bound()) {
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+
+        int value{};
+        memcpy(&value, optval, sizeof(value));
+        sock.opts.compression = (value != 0);
+        return 0;
+    }
+    default:
+        errno = ENOPROTOOPT;
+        return -1;
+    }
+}
+
+int getsockopt(int sockfd, int level, int optname, void *optval, socklen_t *optlen) noexcept {
+    // Argument validation.
+    if (optval == nullptr || optlen == nullptr) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    if (level != SOL_RUDP) {
+        errno = ENOPROTOOPT;
+        return -1;
+    }
+
+    // Socket validation.
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
+        errno = EBADF;
+        return -1;
+    }
+
+    const internal::socket &sock = *found;
+
+    // Read the option.
+    switch (optname) {
+    case RUDP_TRANSPORT: {
+        if (*optlen < sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        int value = (sock.opts.transport_kind == internal::transport::kind::loopback)
+                        ? RUDP_TRANSPORT_LOOPBACK
+                        : RUDP_TRANSPORT_UDP;
+
+        memcpy(optval, &value, sizeof(value));
+        *optlen = sizeof(value);
+        return 0;
+    }
+    case RUDP_SHM: {
+        if (*optlen < sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        int value = sock.opts.shm ? 1 : 0;
+        memcpy(optval, &value, sizeof(value));
+        *optlen = sizeof(value);
+        return 0;
+    }
+    case RUDP_MESSAGES: {
+        if (*optlen < sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        int value = sock.opts.messages ? 1 : 0;
+        memcpy(optval, &value, sizeof(value));
+        *optlen = sizeof(value);
+        return 0;
+    }
+    case RUDP_FEC: {
+        if (*optlen < sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        int value = sock.opts.fec_group;
+        memcpy(optval, &value, sizeof(value));
+        *optlen = sizeof(value);
+        return 0;
+    }
+    case RUDP_COMPRESSION: {
+        if (*optlen < sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        int value = sock.opts.compression ? 1 : 0;
+        memcpy(optval, &value, sizeof(value));
+        *optlen = sizeof(value);
+        return 0;
+    }
+    case RUDP_SHM_ACTIVE: {
+        if (*optlen < sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        int value = (sock.connected() && sock.connection()->shm_active()) ? 1 : 0;
+        memcpy(optval, &value, sizeof(value));
+        *optlen = sizeof(value);
+        return 0;
+    }
+    case RUDP_QUEUEING_DELAY: {
+        if (*optlen < sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        const auto delay = sock.connected() ? sock.connection()->queueing_delay()
+                                            : std::chrono::microseconds::zero();
+        int value = static_cast<int>(std::min<std::chrono::microseconds::rep>(
+            delay.count(), std::numeric_limits<int>::max()));
+        memcpy(optval, &value, sizeof(value));
+        *optlen = sizeof(value);
+        return 0;
+    }
+    case RUDP_CONGESTION_WINDOW: {
+        if (*optlen < sizeof(int)) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        const size_t window = sock.connected() ? sock.connection()->congestion_window()
+                                               : internal::constants::MAX_INFLIGHT_PACKETS;
+        int value = static_cast<int>(window);
+        memcpy(optval, &value, sizeof(value));
+        *optlen = sizeof(value);
+        return 0;
+    }
+    default:
+        errno = ENOPROTOOPT;
+        return -1;
+    }
+}
+
+int fcntl(int sockfd, int cmd, int arg) noexcept {
+    // Socket validation.
+    internal::socket *found = internal::find_socket(sockfd);
+    if (found == nullptr) {
+        errno = EBADF;
+        return -1;
+    }
+
+    internal::socket &sock = *found;
+
+    switch (cmd) {
+    case F_GETFL:
+        return O_RDWR | sock.flags;
+    case F_SETFL:
+        // NOTE: As with fcntl(2), flags which cannot be changed are silently ignored.
+        sock.flags = arg & O_NONBLOCK;
+        return 0;
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+}
+
+int epoll_create(int size) noexcept {
+    // Argument validation.
+    if (size <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    auto epoll = std::make_shared<internal::epoll_instance>();
+    if (!epoll) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    rudpfd_t fd = internal::g_next_fd++;
+    internal::insert_epoll(fd, std::move(epoll));
+    return fd;
+}
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event) noexcept {
+    // Argument validation.
+    if (event == nullptr && op != EPOLL_CTL_DEL) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    // Instance validation.
+    std::shared_ptr<internal::epoll_instance> epoll = internal::find_epoll(epfd);
+    if (!epoll) {
+        errno = (internal::find_socket(epfd) != nullptr) ? EINVAL : EBADF;
+        return -1;
+    }
+
+    // Socket validation.
+    // NOTE: Nesting instances is not supported, so an instance is rejected like any other
+    // descriptor which cannot be watched.
+    internal::socket *found = internal::find_socket(fd);
+    if (found == nullptr) {
+        errno = internal::find_epoll(fd) ? EPERM : EBADF;
+        return -1;
+    }
+
+    // NOTE: errno is set by the instance, e.g. EEXIST and ENOENT.
+    return epoll->ctl(op, fd, found->readiness, event);
+}
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout) noexcept {
+    // Argument validation.
+    if (events == nullptr) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    if (maxevents <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Instance validation.
+    std::shared_ptr<internal::epoll_instance> epoll = internal::find_epoll(epfd);
+    if (!epoll) {
+        errno = (internal::find_socket(epfd) != nullptr) ? EINVAL : EBADF;
+        return -1;
+    }
+
+    return epoll->wait(events, maxevents, timeout);
+}
+
+int epoll_eventfd(int epfd) noexcept {
+    // Instance validation.
+    std::shared_ptr<internal::epoll_instance> epoll = internal::find_epoll(epfd);
+    if (!epoll) {
+        errno = (internal::find_socket(epfd) != nullptr) ? EINVAL : EBADF;
+        return -1;
+    }
+
+    // NOTE: errno is set by eventfd(2), e.g. EMFILE.
+    return epoll->pollable_fd();
 }
 
 int close(int sockfd) noexcept;
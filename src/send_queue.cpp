@@ -0,0 +1,188 @@
+#include "internal/send_queue.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+void send_queue::push(const u8 *data, size_t len) noexcept {
+    m_size += len;
+    m_unsent += len;
+
+    while (len > 0) {
+        if (m_segments.empty() || !appendable(m_segments.back())) {
+            segment &added = m_segments.emplace_back(segment{.block = {},
+                                                             .data = {},
+                                                             .start = m_pushed,
+                                                             .id = 0,
+                                                             .borrowed = false,
+                                                             .discarded = false,
+                                                             .policy = {}});
+
+            // NOTE: Sized to the write, so a connection trickling small sends holds a small block.
+            added.block.reserve(
+                std::clamp(len, static_cast<size_t>(constants::MAX_DATA_BYTES), MAX_BLOCK_BYTES));
+        }
+
+        segment &back = m_segments.back();
+        const size_t take = std::min(len, back.block.capacity() - back.block.size());
+
+        back.block.insert(back.block.end(), data, data + take);
+        back.data = std::span<const u8>(back.block.data(), back.block.size());
+
+        data += take;
+        len -= take;
+        m_pushed += take;
+    }
+
+    settle();
+}
+
+void send_queue::push_borrowed(std::span<const u8> data, u32 id) noexcept {
+    m_unsent += data.size();
+    m_segments.push_back({.block = {},
+                          .data = data,
+                          .start = m_pushed,
+                          .id = id,
+                          .borrowed = true,
+                          .discarded = false,
+                          .policy = {}});
+
+    m_pushed += data.size();
+    settle();
+}
+
+void send_queue::push_message(const u8 *data, size_t len, reliability policy) noexcept {
+    RUDP_ASSERT(len > 0 && len <= constants::MAX_DATA_BYTES,
+                "A partially reliable message must fit in one packet.");
+
+    m_size += len;
+    m_unsent += len;
+
+    segment &added = m_segments.emplace_back(segment{.block = std::vector<u8>(data, data + len),
+                                                     .data = {},
+                                                     .start = m_pushed,
+                                                     .id = 0,
+                                                     .borrowed = false,
+                                                     .discarded = false,
+                                                     .policy = policy});
+    added.data = std::span<const u8>(added.block.data(), added.block.size());
+
+    m_pushed += len;
+    settle();
+}
+
+void send_queue::end_record() noexcept {
+    m_record_ends.push_back(m_pushed);
+}
+
+send_queue::slice send_queue::front(size_t max) const noexcept {
+    RUDP_ASSERT(!empty(), "A slice can only be taken from a non-empty queue.");
+
+    const segment &current = m_segments[m_cursor];
+    const size_t offset = m_popped - current.start;
+    size_t take = std::min(max, current.data.size() - offset);
+
+    bool ends_record = false;
+    if (!m_record_ends.empty() && m_record_ends.front() - m_popped <= take) {
+        take = m_record_ends.front() - m_popped;
+        ends_record = true;
+    }
+
+    slice result{.data = current.data.subspan(offset, take),
+                 .position = m_popped,
+                 .completes = std::nullopt,
+                 .ends_record = ends_record,
+                 .policy = current.policy};
+    if (current.borrowed && offset + take == current.data.size()) {
+        result.completes = current.id;
+    }
+
+    return result;
+}
+
+void send_queue::pop(size_t len) noexcept {
+    RUDP_ASSERT(m_cursor < m_segments.size(), "Only bytes which were sliced can be popped.");
+
+    const segment &current = m_segments[m_cursor];
+    RUDP_ASSERT(m_popped + len <= current.start + current.data.size(),
+                "A pop cannot span two segments.");
+
+    m_popped += len;
+    m_unsent -= len;
+    if (!current.borrowed) {
+        m_size -= len;
+    }
+
+    if (!m_record_ends.empty() && m_record_ends.front() == m_popped) {
+        m_record_ends.pop_front();
+    }
+
+    settle();
+}
+
+void send_queue::discard(size_t len) noexcept {
+    segment &current = m_segments[m_cursor];
+    RUDP_ASSERT(current.policy.partial() && m_popped == current.start && len == current.data.size(),
+                "Only a whole partially reliable message can be discarded.");
+
+    // NOTE: It is never sent, so no acknowledgement will release it.
+    current.discarded = true;
+    pop(len);
+    trim();
+}
+
+std::span<const u8> send_queue::view(u64 position, size_t len) const noexcept {
+    RUDP_ASSERT(position >= m_released && position + len <= m_popped,
+                "Only sent bytes which have not been released can be viewed.");
+
+    auto it = std::ranges::upper_bound(m_segments, position, {}, &segment::start);
+    RUDP_ASSERT(it != m_segments.begin(), "Unreleased bytes must lie within a segment.");
+
+    const segment &found = *std::prev(it);
+    RUDP_ASSERT(position + len <= found.start + found.data.size(),
+                "A packet's payload never spans two segments.");
+
+    return found.data.subspan(position - found.start, len);
+}
+
+void send_queue::release(u64 position) noexcept {
+    m_released = std::max(m_released, position);
+    trim();
+}
+
+bool send_queue::appendable(const segment &candidate) const noexcept {
+    return !candidate.borrowed && !candidate.policy.partial() &&
+           candidate.block.size() < candidate.block.capacity();
+}
+
+void send_queue::settle() noexcept {
+    while (m_cursor + 1 < m_segments.size() &&
+           m_popped == m_segments[m_cursor].start + m_segments[m_cursor].data.size()) {
+        m_cursor++;
+    }
+}
+
+void send_queue::trim() noexcept {
+    while (!m_segments.empty()) {
+        const segment &oldest = m_segments.front();
+        const u64 end = oldest.start + oldest.data.size();
+
+        // NOTE: A segment goes once every byte has been sent and then released, or discarded.
+        if (end > m_popped || (end > m_released && !oldest.discarded)) {
+            break;
+        }
+
+        m_segments.pop_front();
+        if (m_cursor > 0) {
+            m_cursor--;
+        }
+    }
+}
+
+}  // namespace rudp::internal
@@ -0,0 +1,80 @@
+#include "internal/sent_queue.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+
+sent_queue::sent_queue() noexcept
+    : m_slots(std::make_unique<sent_packet[]>(INITIAL_CAPACITY)),
+      m_seqnums(std::make_unique<u32[]>(INITIAL_CAPACITY)), m_capacity(INITIAL_CAPACITY) {}
+
+void sent_queue::push(sent_packet &&sent) noexcept {
+    RUDP_ASSERT(empty() || back().header.seqnum < sent.header.seqnum,
+                "Packets must be pushed in the order they were sent.");
+
+    if (size() == m_capacity) {
+        grow();
+    }
+
+    m_seqnums[m_tail & (m_capacity - 1)] = sent.header.seqnum;
+    slot(m_tail) = std::move(sent);
+    m_tail++;
+}
+
+sent_packet *sent_queue::find(u32 target) noexcept {
+    if (empty() || target < seqnum(m_head)) {
+        return nullptr;
+    }
+
+    // NOTE: Each packet spans between one and MAX_DATA_BYTES of sequence space, which bounds where
+    // the target can be; when every segment is full, the lower bound is exact.
+    const u64 distance = target - seqnum(m_head);
+    u64 low = m_head + distance / constants::MAX_DATA_BYTES;
+    u64 high = std::min(m_tail, m_head + distance + 1);
+
+    if (low < m_tail && seqnum(low) == target) {
+        return &slot(low);
+    }
+
+    while (low < high) {
+        const u64 middle = low + (high - low) / 2;
+        if (seqnum(middle) < target) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if (low == m_tail || seqnum(low) != target) {
+        return nullptr;
+    }
+
+    return &slot(low);
+}
+
+void sent_queue::clear() noexcept {
+    m_head = m_tail;
+}
+
+void sent_queue::grow() noexcept {
+    const size_t capacity = m_capacity * 2;
+    auto slots = std::make_unique<sent_packet[]>(capacity);
+    auto seqnums = std::make_unique<u32[]>(capacity);
+
+    // NOTE: Segment numbers keep their meaning, so each packet moves to its slot in the new ring.
+    for (u64 i = m_head; i < m_tail; i++) {
+        slots[i & (capacity - 1)] = std::move(slot(i));
+        seqnums[i & (capacity - 1)] = seqnum(i);
+    }
+
+    m_slots = std::move(slots);
+    m_seqnums = std::move(seqnums);
+    m_capacity = capacity;
+}
+
+}  // namespace rudp::internal
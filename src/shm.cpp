@@ -0,0 +1,366 @@
+#include "internal/shm.hpp"
+
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+#include "internal/transport.hpp"
+
+namespace rudp::internal {
+namespace {
+    // NOTE: rings[0] carries datagrams from the active to the passive side, rings[1] the reverse.
+    constexpr size_t region_bytes = 2 * sizeof(shm_ring);
+    constexpr size_t passed_fds = 3;  // memfd, active->passive eventfd, passive->active eventfd
+
+    [[nodiscard]] sockaddr_un abstract_address(u16 port, socklen_t *len) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+
+        // NOTE: A leading NUL puts us in the abstract namespace, so nothing is left on disk.
+        int written = snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1, "rudp-shm-%u", port);
+        *len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 +
+                                      static_cast<size_t>(written));
+        return addr;
+    }
+
+    [[nodiscard]] shm_ring *ring_at(void *region, size_t index) {
+        return reinterpret_cast<shm_ring *>(static_cast<u8 *>(region) + index * sizeof(shm_ring));
+    }
+
+    void close_all(const linuxfd_t *fds, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            if (fds[i] >= 0) {
+                ::close(fds[i]);
+            }
+        }
+    }
+
+    // NOTE: Collects whatever descriptors and credentials came with a datagram, so that every
+    // descriptor can be closed should the offer be turned down.
+    void parse_control(msghdr &msg, linuxfd_t *fds, size_t *received, const ucred **creds) {
+        *received = 0;
+        *creds = nullptr;
+
+        for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET) {
+                continue;
+            }
+
+            if (cmsg->cmsg_type == SCM_RIGHTS) {
+                size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(linuxfd_t);
+                size_t fit = std::min(count, passed_fds - *received);
+                std::memcpy(fds + *received, CMSG_DATA(cmsg), fit * sizeof(linuxfd_t));
+
+                // NOTE: More than we asked for can only come from a forged offer; close the rest.
+                for (size_t i = fit; i < count; i++) {
+                    linuxfd_t extra{};
+                    std::memcpy(&extra, CMSG_DATA(cmsg) + i * sizeof(linuxfd_t), sizeof(extra));
+                    ::close(extra);
+                }
+                *received += fit;
+            } else if (cmsg->cmsg_type == SCM_CREDENTIALS &&
+                       cmsg->cmsg_len >= CMSG_LEN(sizeof(ucred))) {
+                *creds = reinterpret_cast<const ucred *>(CMSG_DATA(cmsg));
+            }
+        }
+    }
+}  // namespace
+
+shm_transport::~shm_transport() {
+    munmap(m_region, region_bytes);
+    ::close(m_tx_eventfd);
+    ::close(m_rx_eventfd);
+}
+
+std::shared_ptr<transport> shm_transport::spawn() const noexcept {
+    errno = EOPNOTSUPP;
+    return nullptr;
+}
+
+linuxfd_t shm_transport::fd() const noexcept {
+    return m_rx_eventfd;
+}
+
+int shm_transport::bind(const sockaddr_in & /** addr */) noexcept {
+    errno = EOPNOTSUPP;
+    return -1;
+}
+
+int shm_transport::getsockname(sockaddr_in * /** addr */) const noexcept {
+    errno = EOPNOTSUPP;
+    return -1;
+}
+
+ssize_t shm_transport::sendmsg(std::span<const iovec> iov, const sockaddr_in & /** addr */,
+                               ecn codepoint) noexcept {
+    const size_t len = iov_length(iov);
+    if (len > MAX_DATAGRAM_BYTES) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    u32 tail = m_tx->tail.load(std::memory_order_relaxed);
+    if (tail - m_tx->head.load(std::memory_order_acquire) == shm_ring::SLOTS) {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    shm_ring::slot &slot = m_tx->slots[tail % shm_ring::SLOTS];
+    slot.sent_at = std::chrono::steady_clock::now();
+    slot.codepoint = codepoint;
+    slot.length = static_cast<u32>(len);
+    gather(slot.data, iov);
+    m_tx->tail.store(tail + 1, std::memory_order_release);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_tx->armed.exchange(0) != 0) {
+        u64 one = 1;
+        [[maybe_unused]] ssize_t written = ::write(m_tx_eventfd, &one, sizeof(one));
+    }
+
+    return static_cast<ssize_t>(len);
+}
+
+ssize_t shm_transport::recvfrom(void *buf, size_t len, sockaddr_in *addr,
+                                arrival *arrival) noexcept {
+    u32 head = m_rx->head.load(std::memory_order_relaxed);
+
+    if (head == m_rx->tail.load(std::memory_order_acquire)) {
+        // NOTE: See loopback_transport::recvfrom(); clear, re-arm, then look once more.
+        u64 count{};
+        [[maybe_unused]] ssize_t drained = ::read(m_rx_eventfd, &count, sizeof(count));
+        m_rx->armed.store(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (head == m_rx->tail.load(std::memory_order_acquire)) {
+            errno = EAGAIN;
+            return -1;
+        }
+    }
+
+    const shm_ring::slot &slot = m_rx->slots[head % shm_ring::SLOTS];
+    size_t copy = std::min({len, static_cast<size_t>(slot.length), MAX_DATAGRAM_BYTES});
+    std::memcpy(buf, slot.data, copy);
+    m_rx->head.store(head + 1, std::memory_order_release);
+
+    if (addr != nullptr) {
+        *addr = m_peer;
+    }
+
+    if (arrival != nullptr) {
+        *arrival = {.at = slot.sent_at, .codepoint = slot.codepoint};
+    }
+
+    return static_cast<ssize_t>(copy);
+}
+
+namespace shm {
+
+    bool is_same_host(const sockaddr_in &addr) noexcept {
+        u32 host = ntohl(addr.sin_addr.s_addr);
+        if (host == INADDR_ANY || (host >> 24) == (INADDR_LOOPBACK >> 24)) {
+            return true;
+        }
+
+        ifaddrs *interfaces = nullptr;
+        if (getifaddrs(&interfaces) < 0) {
+            return false;
+        }
+
+        bool local = false;
+        for (ifaddrs *it = interfaces; it != nullptr && !local; it = it->ifa_next) {
+            if (it->ifa_addr == nullptr || it->ifa_addr->sa_family != AF_INET) {
+                continue;
+            }
+
+            const auto *ifaddr = reinterpret_cast<const sockaddr_in *>(it->ifa_addr);
+            local = (ifaddr->sin_addr.s_addr == addr.sin_addr.s_addr);
+        }
+
+        freeifaddrs(interfaces);
+        return local;
+    }
+
+    linuxfd_t listen(const transport &transport, u64 *nonce) noexcept {
+        sockaddr_in local{};
+        if (transport.getsockname(&local) < 0) {
+            return -1;
+        }
+
+        if (getrandom(nonce, sizeof(*nonce), 0) != static_cast<ssize_t>(sizeof(*nonce))) {
+            return -1;
+        }
+
+        linuxfd_t fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return -1;
+        }
+
+        // NOTE: The name is guessable, so every offer must show which user sent it.
+        int passcred = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_PASSCRED, &passcred, sizeof(passcred)) < 0) {
+            ::close(fd);
+            return -1;
+        }
+
+        socklen_t len{};
+        sockaddr_un addr = abstract_address(ntohs(local.sin_port), &len);
+
+        if (::bind(fd, reinterpret_cast<const sockaddr *>(&addr), len) < 0) {
+            ::close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    std::shared_ptr<transport> offer(const sockaddr_in &peer, u64 nonce) noexcept {
+        linuxfd_t fds[passed_fds] = {-1, -1, -1};
+
+        fds[0] = memfd_create("rudp-shm", MFD_CLOEXEC);
+        fds[1] = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        fds[2] = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (std::any_of(fds, fds + passed_fds, [](linuxfd_t fd) { return fd < 0; }) ||
+            ftruncate(fds[0], static_cast<off_t>(region_bytes)) < 0) {
+            close_all(fds, passed_fds);
+            return nullptr;
+        }
+
+        void *region = mmap(nullptr, region_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+        if (region == MAP_FAILED) {
+            close_all(fds, passed_fds);
+            return nullptr;
+        }
+
+        for (size_t i = 0; i < 2; i++) {
+            shm_ring *ring = new (ring_at(region, i)) shm_ring;
+            ring->head.store(0);
+            ring->tail.store(0);
+            ring->armed.store(1);
+        }
+
+        // Hand the region and both eventfds to the passive side.
+        linuxfd_t sockfd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (sockfd < 0) {
+            munmap(region, region_bytes);
+            close_all(fds, passed_fds);
+            return nullptr;
+        }
+
+        socklen_t len{};
+        sockaddr_un addr = abstract_address(ntohs(peer.sin_port), &len);
+
+        iovec iov = {.iov_base = &nonce, .iov_len = sizeof(nonce)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))]{};
+
+        msghdr msg{};
+        msg.msg_name = &addr;
+        msg.msg_namelen = len;
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+        std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+        ssize_t sent = sendmsg(sockfd, &msg, MSG_DONTWAIT);
+        ::close(sockfd);
+        ::close(fds[0]);
+
+        if (sent < 0) {
+            munmap(region, region_bytes);
+            close_all(fds + 1, passed_fds - 1);
+            return nullptr;
+        }
+
+        return std::make_shared<shm_transport>(region, ring_at(region, 0), ring_at(region, 1),
+                                               fds[1], fds[2], peer);
+    }
+
+    std::shared_ptr<transport> accept(linuxfd_t listenfd, const sockaddr_in &peer,
+                                      u64 nonce) noexcept {
+        linuxfd_t fds[passed_fds] = {-1, -1, -1};
+        size_t received = 0;
+        int msg_flags = 0;
+
+        // NOTE: Anyone on the host may send to our name. An offer from another user, or which
+        // does not carry back the nonce from our SYNACK, is dropped and the next one looked at.
+        while (true) {
+            u64 carried = 0;
+            iovec iov = {.iov_base = &carried, .iov_len = sizeof(carried)};
+            alignas(cmsghdr) char control[CMSG_SPACE(passed_fds * sizeof(linuxfd_t)) +
+                                          CMSG_SPACE(sizeof(ucred))]{};
+
+            msghdr msg{};
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            ssize_t len = recvmsg(listenfd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+            if (len < 0) {
+                return nullptr;
+            }
+
+            const ucred *creds = nullptr;
+            std::fill(fds, fds + passed_fds, -1);
+            parse_control(msg, fds, &received, &creds);
+
+            if (creds != nullptr && creds->uid == geteuid() &&
+                len == static_cast<ssize_t>(sizeof(carried)) && !(msg.msg_flags & MSG_TRUNC) &&
+                carried == nonce) {
+                msg_flags = msg.msg_flags;
+                break;
+            }
+
+            close_all(fds, passed_fds);
+        }
+
+        struct stat st{};
+        if (received != passed_fds || (msg_flags & MSG_CTRUNC) || fstat(fds[0], &st) < 0 ||
+            static_cast<size_t>(st.st_size) != region_bytes) {
+            close_all(fds, passed_fds);
+            errno = EPROTO;
+            return nullptr;
+        }
+
+        void *region = mmap(nullptr, region_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+        ::close(fds[0]);
+
+        if (region == MAP_FAILED) {
+            close_all(fds + 1, passed_fds - 1);
+            return nullptr;
+        }
+
+        return std::make_shared<shm_transport>(region, ring_at(region, 1), ring_at(region, 0),
+                                               fds[2], fds[1], peer);
+    }
+
+}  // namespace shm
+
+}  // namespace rudp::internal
@@ -1,7 +1,13 @@
 
 #include "internal/simulator.hpp"
 
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
 #include <random>
+#include <span>
 #include <thread>
 #include <vector>
 
@@ -33,30 +39,73 @@ namespace {
     }
 }  // namespace
 
-ssize_t simulator::sendto(int sockfd, const void *buf, size_t len, int flags, const sockaddr *addr,
-                          socklen_t addrlen) {
+ssize_t simulator::sendmsg(transport &transport, std::span<const iovec> iov,
+                           const sockaddr_in &addr, ecn codepoint) {
     auto &sim = simulator::instance();
 
-    if (sim.should_drop()) {
-        return static_cast<ssize_t>(len);
+    // NOTE: The common case; avoid the copy and the RNG entirely.
+    if (!sim.enabled()) {
+        return transport.sendmsg(iov, addr, codepoint);
+    }
+
+    std::vector<u8> data(iov_length(iov));
+    if (sim.should_drop() || !sim.enqueue(addr, codepoint)) {
+        return static_cast<ssize_t>(data.size());
     }
 
-    std::vector<u8> data(static_cast<const u8 *>(buf), static_cast<const u8 *>(buf) + len);
+    gather(data.data(), iov);
     if (sim.should_corrupt()) {
         corrupt(data);
     }
 
     sim.simulate_latency();
 
-    ssize_t result = ::sendto(sockfd, data.data(), data.size(), flags, addr, addrlen);
+    const iovec joined{.iov_base = data.data(), .iov_len = data.size()};
+    ssize_t result = transport.sendmsg(std::span(&joined, 1), addr, codepoint);
     if (result > 0 && sim.should_duplicate()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(5 + rand() % 20));
-        ::sendto(sockfd, data.data(), data.size(), flags, addr, addrlen);
+        [[maybe_unused]] ssize_t duplicated =
+            transport.sendmsg(std::span(&joined, 1), addr, codepoint);
     }
 
     return result;
 }
 
+bool simulator::enabled() const noexcept {
+    return drop > 0.0f || corruption > 0.0f || duplication > 0.0f || max_latency_ms > 0 ||
+           ce_threshold > 0;
+}
+
+bool simulator::enqueue(const sockaddr_in &addr, ecn &codepoint) noexcept {
+    if (ce_threshold == 0) {
+        return true;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const u64 key = (u64{addr.sin_addr.s_addr} << 16) | addr.sin_port;
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    queue &state = m_queues.try_emplace(key, queue{.depth = 0, .drained_at = now}).first->second;
+
+    const std::chrono::duration<double, std::milli> elapsed = now - state.drained_at;
+    state.depth = std::max(0.0, state.depth - elapsed.count() * queue_rate);
+    state.drained_at = now;
+
+    if (state.depth < ce_threshold) {
+        state.depth += 1;
+        return true;
+    }
+
+    // NOTE: A CE mark stands in for the drop, so the datagram still joins the queue.
+    if (codepoint == ecn::not_ect) {
+        return false;
+    }
+
+    codepoint = ecn::ce;
+    state.depth += 1;
+    return true;
+}
+
 bool simulator::should_drop() const noexcept {
     return random_float() < drop;
 }
@@ -1,35 +1,41 @@
 #include "internal/socket.hpp"
 
-#include <sys/fcntl.h>
-#include <sys/socket.h>
-
+#include <atomic>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "internal/common.hpp"
 
 namespace rudp::internal {
 
-rudpfd_t g_next_fd = 0;
-std::unordered_map<rudpfd_t, socket> g_sockets;
+std::atomic<rudpfd_t> g_next_fd = 0;
 
-linuxfd_t create_raw_socket() {
-    linuxfd_t fd = ::socket(AF_INET, SOCK_DGRAM, 0);
-    if (fd < 0) {
-        return -1;
-    }
+// NOTE: Leaked deliberately. The event thread is never joined, so it may still be walking the
+// sockets while static destructors run at exit.
+std::unordered_map<rudpfd_t, socket> &g_sockets = *new std::unordered_map<rudpfd_t, socket>();
+std::mutex &g_sockets_mtx = *new std::mutex();
+std::vector<connection *> &g_connections = *new std::vector<connection *>();
 
-    int flags = fcntl(fd, F_GETFL, 0);
-    if (flags < 0) {
-        ::close(fd);
-        return -1;
-    }
+socket *find_socket(rudpfd_t fd) noexcept {
+    std::lock_guard<std::mutex> lock(g_sockets_mtx);
 
-    if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
-        ::close(fd);
-        return -1;
+    auto it = g_sockets.find(fd);
+    return (it == g_sockets.end()) ? nullptr : &it->second;
+}
+
+void insert_socket(rudpfd_t fd, socket &&sock) noexcept {
+    std::lock_guard<std::mutex> lock(g_sockets_mtx);
+
+    auto it = g_sockets.insert_or_assign(fd, std::move(sock)).first;
+    if (it->second.connected()) {
+        g_connections.push_back(it->second.connection());
     }
+}
 
-    return fd;
+bool is_established(rudpfd_t fd) noexcept {
+    socket *found = find_socket(fd);
+    return found != nullptr && found->connected() && found->connection()->established();
 }
 
 }  // namespace rudp::internal
@@ -0,0 +1,62 @@
+#include "internal/tlv.hpp"
+
+#include <cstring>
+#include <optional>
+#include <span>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+
+namespace rudp::internal {
+namespace {
+    constexpr size_t TLV_HEADER_BYTES = 2;
+}  // namespace
+
+bool append_option(std::span<u8> area, size_t &size, option kind,
+                   std::span<const u8> value) noexcept {
+    RUDP_ASSERT(value.size() <= 0xFF, "An option's value must fit its length byte.");
+
+    if (size + TLV_HEADER_BYTES + value.size() > area.size()) {
+        return false;
+    }
+
+    area[size++] = static_cast<u8>(kind);
+    area[size++] = static_cast<u8>(value.size());
+    if (!value.empty()) {
+        std::memcpy(&area[size], value.data(), value.size());
+    }
+    size += value.size();
+
+    return true;
+}
+
+std::optional<std::span<const u8>> find_option(std::span<const u8> area, option kind) noexcept {
+    size_t i = 0;
+    while (i + TLV_HEADER_BYTES <= area.size()) {
+        const u8 found = area[i];
+        const size_t len = area[i + 1];
+        i += TLV_HEADER_BYTES;
+
+        if (found == static_cast<u8>(kind)) {
+            return area.subspan(i, len);
+        }
+        i += len;
+    }
+
+    return std::nullopt;
+}
+
+bool valid_options(std::span<const u8> area) noexcept {
+    size_t i = 0;
+    while (i < area.size()) {
+        if (i + TLV_HEADER_BYTES > area.size()) {
+            return false;
+        }
+
+        i += TLV_HEADER_BYTES + area[i + 1];
+    }
+
+    return i == area.size();
+}
+
+}  // namespace rudp::internal
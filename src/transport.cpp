@@ -0,0 +1,192 @@
+#include "internal/transport.hpp"
+
+#include <sys/fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <span>
+
+#include "internal/assert.hpp"
+#include "internal/common.hpp"
+#include "internal/loopback.hpp"
+
+namespace rudp::internal {
+namespace {
+    linuxfd_t create_raw_socket() {
+        linuxfd_t fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+
+        int flags = ::fcntl(fd, F_GETFL, 0);
+        if (flags < 0) {
+            ::close(fd);
+            return -1;
+        }
+
+        if (::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            ::close(fd);
+            return -1;
+        }
+
+        int enabled = 1;
+        if (::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &enabled, sizeof(enabled)) < 0 ||
+            ::setsockopt(fd, IPPROTO_IP, IP_RECVTOS, &enabled, sizeof(enabled)) < 0) {
+            ::close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+}  // namespace
+
+std::shared_ptr<transport> transport::create(kind kind) noexcept {
+    switch (kind) {
+    case kind::udp: {
+        linuxfd_t fd = create_raw_socket();
+        if (fd < 0) {
+            // NOTE: errno is forwarded from socket(), fcntl() or setsockopt().
+            return nullptr;
+        }
+
+        return std::make_shared<udp_transport>(fd);
+    }
+    case kind::loopback:
+        return loopback_transport::create();
+    }
+
+    RUDP_UNREACHABLE();
+}
+
+udp_transport::~udp_transport() {
+    ::close(m_fd);
+}
+
+std::shared_ptr<transport> udp_transport::spawn() const noexcept {
+    auto spawned = transport::create(kind::udp);
+    if (!spawned) {
+        return nullptr;
+    }
+
+    struct sockaddr_in bound_addr{};
+    bound_addr.sin_family = AF_INET;
+    bound_addr.sin_addr.s_addr = INADDR_ANY;
+    bound_addr.sin_port = 0;
+
+    if (spawned->bind(bound_addr) < 0) {
+        return nullptr;
+    }
+
+    return spawned;
+}
+
+linuxfd_t udp_transport::fd() const noexcept {
+    return m_fd;
+}
+
+int udp_transport::bind(const sockaddr_in &addr) noexcept {
+    return ::bind(m_fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr));
+}
+
+int udp_transport::getsockname(sockaddr_in *addr) const noexcept {
+    socklen_t addrlen = sizeof(sockaddr_in);
+    return ::getsockname(m_fd, reinterpret_cast<sockaddr *>(addr), &addrlen);
+}
+
+ssize_t udp_transport::sendmsg(std::span<const iovec> iov, const sockaddr_in &addr,
+                               ecn codepoint) noexcept {
+    msghdr msg{};
+    msg.msg_name = const_cast<sockaddr_in *>(&addr);
+    msg.msg_namelen = sizeof(addr);
+    msg.msg_iov = const_cast<iovec *>(iov.data());
+    msg.msg_iovlen = iov.size();
+
+    // NOTE: The socket's own TOS is left at zero, so a codepoint is only attached when set.
+    alignas(cmsghdr) std::array<u8, CMSG_SPACE(sizeof(int))> control{};
+    if (codepoint != ecn::not_ect) {
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+
+        cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = IPPROTO_IP;
+        cmsg->cmsg_type = IP_TOS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+
+        const int tos = static_cast<int>(codepoint);
+        std::memcpy(CMSG_DATA(cmsg), &tos, sizeof(tos));
+    }
+
+    return ::sendmsg(m_fd, &msg, 0);
+}
+
+ssize_t udp_transport::recvfrom(void *buf, size_t len, sockaddr_in *addr,
+                                arrival *arrival) noexcept {
+    iovec iov{.iov_base = buf, .iov_len = len};
+    alignas(cmsghdr) std::array<u8, CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(int))>
+        control{};
+
+    msghdr msg{};
+    msg.msg_name = addr;
+    msg.msg_namelen = (addr != nullptr) ? sizeof(sockaddr_in) : 0;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+
+    ssize_t bytes = ::recvmsg(m_fd, &msg, 0);
+    if (bytes < 0 || arrival == nullptr) {
+        return bytes;
+    }
+
+    *arrival = {.at = std::chrono::steady_clock::now(), .codepoint = ecn::not_ect};
+
+    // NOTE: The kernel stamps arrival on the realtime clock, so only the time spent queued carries
+    // over to ours. A clock step can make that negative, in which case it is ignored.
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_TOS) {
+            const u8 tos = *CMSG_DATA(cmsg);
+            arrival->codepoint = static_cast<ecn>(tos & 0b11);
+            continue;
+        }
+
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPNS) {
+            continue;
+        }
+
+        timespec stamped{};
+        std::memcpy(&stamped, CMSG_DATA(cmsg), sizeof(stamped));
+        const auto queued = std::chrono::system_clock::now().time_since_epoch() -
+                            (std::chrono::seconds(stamped.tv_sec) +
+                             std::chrono::nanoseconds(stamped.tv_nsec));
+
+        if (queued > std::chrono::nanoseconds::zero()) {
+            arrival->at -= std::chrono::duration_cast<std::chrono::steady_clock::duration>(queued);
+        }
+    }
+
+    return bytes;
+}
+
+size_t iov_length(std::span<const iovec> iov) noexcept {
+    size_t len = 0;
+    for (const iovec &buffer : iov) {
+        len += buffer.iov_len;
+    }
+
+    return len;
+}
+
+void gather(u8 *output, std::span<const iovec> iov) noexcept {
+    for (const iovec &buffer : iov) {
+        std::memcpy(output, buffer.iov_base, buffer.iov_len);
+        output += buffer.iov_len;
+    }
+}
+
+}  // namespace rudp::internal
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <rudp.hpp>
+#include <rudp/async.hpp>
+
+#include "internal/simulator.hpp"
+
+// NOTE: Both ends of every connection run as coroutines on the test thread's loop.
+class AsyncIntegrationTest : public testing::Test {
+protected:
+    static constexpr size_t connections = 64;
+    static constexpr size_t msg_size = 16 * 1024;
+
+    void SetUp() override {
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr_in->sin_port = htons(1234);
+
+        data.resize(msg_size);
+        for (size_t i = 0; i < msg_size; i++) {
+            data[i] = static_cast<char>('A' + (i % 26));
+        }
+
+        ASSERT_TRUE(loop.valid());
+    }
+
+    struct sockaddr addr{};
+    std::vector<char> data;
+    rudp::async::loop loop;
+
+    size_t echoed = 0;
+
+    rudp::async::task<> echo(int fd) {
+        char buf[4096];
+
+        for (;;) {
+            ssize_t received = co_await loop.recv(fd, buf, sizeof(buf));
+            if (received <= 0) {
+                co_return;
+            }
+
+            ssize_t sent = 0;
+            while (sent < received) {
+                ssize_t bytes =
+                    co_await loop.send(fd, buf + sent, static_cast<size_t>(received - sent));
+                EXPECT_GT(bytes, 0);
+                sent += bytes;
+            }
+        }
+    }
+
+    rudp::async::task<> serve(int serverfd, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            int fd = static_cast<int>(co_await loop.accept(serverfd));
+            EXPECT_GE(fd, 0);
+            loop.spawn(echo(fd));
+        }
+    }
+
+    rudp::async::task<size_t> send_all(int fd) {
+        size_t sent = 0;
+        while (sent < msg_size) {
+            ssize_t bytes = co_await loop.send(fd, data.data() + sent, msg_size - sent);
+            EXPECT_GT(bytes, 0);
+            sent += static_cast<size_t>(bytes);
+        }
+        co_return sent;
+    }
+
+    rudp::async::task<> client() {
+        int fd = rudp::socket();
+        EXPECT_EQ(co_await loop.connect(fd, &addr, sizeof(addr)), 0);
+
+        EXPECT_EQ(co_await send_all(fd), msg_size) << "A task must hand its result to its awaiter.";
+
+        std::vector<char> buf(msg_size);
+        size_t received = 0;
+        while (received < msg_size) {
+            ssize_t bytes = co_await loop.recv(fd, buf.data() + received, msg_size - received);
+            EXPECT_GT(bytes, 0);
+            received += static_cast<size_t>(bytes);
+        }
+
+        EXPECT_EQ(memcmp(buf.data(), data.data(), msg_size), 0);
+        if (++echoed == connections) {
+            loop.stop();
+        }
+    }
+
+    rudp::async::task<> connect_only() {
+        int fd = rudp::socket();
+        EXPECT_EQ(co_await loop.connect(fd, &addr, sizeof(addr)), 0);
+        EXPECT_EQ(rudp::fcntl(fd, F_GETFL) & O_NONBLOCK, 0)
+            << "connect() must not leave O_NONBLOCK set.";
+        loop.stop();
+    }
+
+    rudp::async::task<> bad_descriptor() {
+        char byte{};
+        EXPECT_EQ(co_await loop.recv(-1, &byte, sizeof(byte)), -1);
+        EXPECT_EQ(errno, EBADF) << "Errors must reach the coroutine without suspending it.";
+    }
+};
+
+TEST_F(AsyncIntegrationTest, Echo) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, static_cast<int>(connections)), 0);
+
+    loop.spawn(serve(serverfd, connections));
+    for (size_t i = 0; i < connections; i++) {
+        loop.spawn(client());
+    }
+
+    // NOTE: The echo coroutines never finish as there is no close() yet, so the last client to
+    // finish stops the loop.
+    ASSERT_EQ(loop.run(), 0);
+    ASSERT_EQ(echoed, connections);
+}
+
+TEST_F(AsyncIntegrationTest, SocketFlagsUntouched) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    loop.spawn(serve(serverfd, 1));
+    loop.spawn(connect_only());
+    ASSERT_EQ(loop.run(), 0);
+
+    ASSERT_EQ(rudp::fcntl(serverfd, F_GETFL) & O_NONBLOCK, 0)
+        << "accept() must not leave O_NONBLOCK set.";
+}
+
+TEST_F(AsyncIntegrationTest, ErrorWithoutSuspending) {
+    loop.spawn(bad_descriptor());
+    ASSERT_EQ(loop.run(), 0);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <rudp.hpp>
+#include <vector>
+
+#include "internal/simulator.hpp"
+
+class CompressionIntegrationTest : public testing::Test {
+protected:
+    void connect(int group = 0) {
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+
+        serverfd = rudp::socket();
+        clientfd = rudp::socket();
+
+        int enabled = 1;
+        ASSERT_EQ(rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_COMPRESSION, &enabled,
+                                   sizeof(enabled)),
+                  0);
+        ASSERT_EQ(rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_FEC, &group, sizeof(group)),
+                  0);
+
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+
+    void TearDown() override {
+        rudp::internal::simulator::instance().reset();
+    }
+
+    struct sockaddr addr{};
+
+    int serverfd;
+    int clientfd;
+    int accepted_fd;
+
+    // NOTE: Log lines which repeat their shape but not their values.
+    static std::vector<char> logs(size_t len) {
+        std::vector<char> data;
+        data.reserve(len + 128);
+        for (unsigned i = 0; data.size() < len; i++) {
+            char line[128];
+            int written = snprintf(line, sizeof(line),
+                                   "{\"seq\":%u,\"level\":\"info\",\"msg\":\"served\",\"ms\":%u}\n",
+                                   i, i * 37 % 1000);
+            data.insert(data.end(), line, line + written);
+        }
+        data.resize(len);
+        return data;
+    }
+
+    static std::vector<char> noise(size_t len) {
+        std::mt19937 gen(42);
+        std::vector<char> data(len);
+        for (char &byte : data) {
+            byte = static_cast<char>(gen());
+        }
+        return data;
+    }
+
+    void transfer(const std::vector<char> &sent) {
+        ASSERT_EQ(rudp::send(clientfd, sent.data(), sent.size(), 0),
+                  static_cast<ssize_t>(sent.size()));
+
+        std::vector<char> received(sent.size());
+        size_t total = 0;
+        while (total < sent.size()) {
+            ssize_t got =
+                rudp::recv(accepted_fd, received.data() + total, sent.size() - total, 0);
+            ASSERT_GT(got, 0);
+            total += static_cast<size_t>(got);
+        }
+
+        ASSERT_EQ(memcmp(sent.data(), received.data(), sent.size()), 0);
+    }
+};
+
+TEST_F(CompressionIntegrationTest, Compressible) {
+    connect();
+
+    transfer(logs(128 * 1024));
+}
+
+TEST_F(CompressionIntegrationTest, Incompressible) {
+    connect();
+
+    // NOTE: Sent as is, then a run of logs once the skipping has backed off.
+    transfer(noise(64 * 1024));
+    transfer(logs(64 * 1024));
+}
+
+TEST_F(CompressionIntegrationTest, PacketLoss20) {
+    connect();
+    rudp::internal::simulator::instance().drop = 0.2f;
+
+    // NOTE: Retransmissions are compressed afresh.
+    transfer(logs(32 * 1024));
+}
+
+TEST_F(CompressionIntegrationTest, PacketLoss20WithFec) {
+    connect(4);
+    rudp::internal::simulator::instance().drop = 0.2f;
+
+    // NOTE: Segments are rebuilt from parity over their original payloads.
+    transfer(logs(32 * 1024));
+}
+
+TEST_F(CompressionIntegrationTest, Corruption20) {
+    connect();
+    rudp::internal::simulator::instance().corruption = 0.2f;
+
+    transfer(logs(32 * 1024));
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstring>
+#include <rudp.hpp>
+#include <vector>
+
+#include "internal/simulator.hpp"
+
+class EcnIntegrationTest : public testing::Test {
+protected:
+    void SetUp() override {
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+
+        serverfd = rudp::socket();
+        clientfd = rudp::socket();
+
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+
+    void TearDown() override {
+        rudp::internal::simulator::instance().reset();
+    }
+
+    struct sockaddr addr{};
+
+    int serverfd;
+    int clientfd;
+    int accepted_fd;
+
+    void transfer(size_t len) {
+        std::vector<char> sent(len);
+        for (size_t i = 0; i < len; i++) {
+            sent[i] = static_cast<char>('A' + (i * 7 % 26));
+        }
+
+        ASSERT_EQ(rudp::send(clientfd, sent.data(), sent.size(), 0),
+                  static_cast<ssize_t>(sent.size()));
+
+        std::vector<char> received(len);
+        size_t total = 0;
+        while (total < len) {
+            ssize_t got = rudp::recv(accepted_fd, received.data() + total, len - total, 0);
+            ASSERT_GT(got, 0);
+            total += static_cast<size_t>(got);
+        }
+
+        ASSERT_EQ(memcmp(sent.data(), received.data(), len), 0);
+    }
+
+    int congestion_window() {
+        int value = -1;
+        socklen_t len = sizeof(value);
+        EXPECT_EQ(
+            rudp::getsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_CONGESTION_WINDOW, &value, &len),
+            0);
+        return value;
+    }
+};
+
+TEST_F(EcnIntegrationTest, Unmarked) {
+    transfer(128 * 1024);
+
+    ASSERT_EQ(congestion_window(), 64) << "Without marks the window must stay fully open.";
+}
+
+TEST_F(EcnIntegrationTest, MarkedNarrowsWindow) {
+    auto &sim = rudp::internal::simulator::instance();
+    sim.queue_rate = 5;
+    sim.ce_threshold = 8;
+
+    transfer(128 * 1024);
+
+    ASSERT_LT(congestion_window(), 64) << "Marked data must narrow the window.";
+}
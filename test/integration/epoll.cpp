@@ -0,0 +1,160 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <rudp.hpp>
+#include <unordered_map>
+
+#include "internal/simulator.hpp"
+
+// NOTE: A single thread drives every socket, on both sides, from one epoll instance.
+class EpollIntegrationTest : public testing::Test {
+protected:
+    static constexpr size_t connections = 32;
+    static constexpr size_t msg_size = 16 * 1024;
+
+    void SetUp() override {
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr_in->sin_port = htons(1234);
+
+        data.resize(msg_size);
+        for (size_t i = 0; i < msg_size; i++) {
+            data[i] = static_cast<char>('A' + (i % 26));
+        }
+
+        epfd = rudp::epoll_create(1);
+        ASSERT_GE(epfd, 0);
+    }
+
+    struct sockaddr addr{};
+    std::vector<char> data;
+    int epfd;
+
+    void add(int fd, uint32_t events) {
+        struct epoll_event event{.events = events, .data = {.fd = fd}};
+        ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event), 0);
+    }
+
+    // NOTE: With external set, the instance is only waited on once its eventfd polls readable, as
+    // it would be from inside another event loop.
+    int wait(struct epoll_event *events, int maxevents, bool external) {
+        if (!external) {
+            return rudp::epoll_wait(epfd, events, maxevents, 5000);
+        }
+
+        struct pollfd pfd{.fd = rudp::epoll_eventfd(epfd), .events = POLLIN, .revents = 0};
+        while (::poll(&pfd, 1, 5000) == 1) {
+            int n = rudp::epoll_wait(epfd, events, maxevents, 0);
+            if (n != 0) {
+                return n;
+            }
+        }
+
+        return 0;
+    }
+
+    void echo(uint32_t trigger, bool external = false) {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, static_cast<int>(connections)), 0);
+        ASSERT_EQ(rudp::fcntl(serverfd, F_SETFL, O_NONBLOCK), 0);
+        add(serverfd, EPOLLIN | trigger);
+
+        struct client {
+            size_t sent;
+            size_t received;
+            std::vector<char> buffer;
+        };
+        std::unordered_map<int, client> clients;
+
+        for (size_t i = 0; i < connections; i++) {
+            int fd = rudp::socket();
+            ASSERT_EQ(rudp::fcntl(fd, F_SETFL, O_NONBLOCK), 0);
+            ASSERT_EQ(rudp::connect(fd, &addr, sizeof(addr)), -1);
+            ASSERT_EQ(errno, EINPROGRESS);
+
+            add(fd, EPOLLIN | EPOLLOUT | trigger);
+            clients.emplace(fd, client{.sent = 0, .received = 0, .buffer = {}});
+            clients[fd].buffer.resize(msg_size);
+        }
+
+        size_t done = 0;
+        struct epoll_event events[8];
+        char buf[4096];
+
+        while (done < connections) {
+            int n = wait(events, 8, external);
+            ASSERT_GT(n, 0) << "Every connection must make progress.";
+
+            for (int i = 0; i < n; i++) {
+                const int fd = events[i].data.fd;
+
+                if (fd == serverfd) {
+                    // NOTE: Edge-triggered sockets must be drained, so accept until EAGAIN.
+                    int accepted;
+                    while ((accepted = rudp::accept(serverfd, nullptr, nullptr)) >= 0) {
+                        ASSERT_EQ(rudp::fcntl(accepted, F_SETFL, O_NONBLOCK), 0);
+                        add(accepted, EPOLLIN | trigger);
+                    }
+                    ASSERT_EQ(errno, EAGAIN);
+                    continue;
+                }
+
+                auto it = clients.find(fd);
+                if (it == clients.end()) {
+                    // An accepted socket, which echoes whatever it reads.
+                    ssize_t bytes;
+                    while ((bytes = rudp::recv(fd, buf, sizeof(buf), 0)) > 0) {
+                        ASSERT_EQ(rudp::send(fd, buf, static_cast<size_t>(bytes), 0), bytes);
+                    }
+                    ASSERT_EQ(errno, EAGAIN);
+                    continue;
+                }
+
+                client &c = it->second;
+                if ((events[i].events & EPOLLOUT) && c.sent < msg_size) {
+                    ssize_t bytes = rudp::send(fd, data.data() + c.sent, msg_size - c.sent, 0);
+                    if (bytes > 0) {
+                        c.sent += static_cast<size_t>(bytes);
+                    }
+
+                    if (c.sent == msg_size) {
+                        struct epoll_event event{.events = EPOLLIN | trigger, .data = {.fd = fd}};
+                        ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &event), 0);
+                    }
+                }
+
+                if (events[i].events & EPOLLIN) {
+                    ssize_t bytes;
+                    while ((bytes = rudp::recv(fd, c.buffer.data() + c.received,
+                                               msg_size - c.received, 0)) > 0) {
+                        c.received += static_cast<size_t>(bytes);
+                    }
+
+                    if (c.received == msg_size) {
+                        ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr), 0);
+                        done++;
+                    }
+                }
+            }
+        }
+
+        for (const auto &[fd, c] : clients) {
+            ASSERT_EQ(memcmp(c.buffer.data(), data.data(), msg_size), 0)
+                << "Every client must have its data echoed back unchanged.";
+        }
+    }
+};
+
+TEST_F(EpollIntegrationTest, EchoLevelTriggered) { echo(0); }
+
+TEST_F(EpollIntegrationTest, EchoEdgeTriggered) { echo(EPOLLET); }
+
+TEST_F(EpollIntegrationTest, EchoExternalLoop) { echo(EPOLLET, true); }
@@ -0,0 +1,221 @@
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <rudp.hpp>
+#include <span>
+#include <vector>
+
+#include "internal/common.hpp"
+#include "internal/packet.hpp"
+#include "internal/simulator.hpp"
+#include "internal/tlv.hpp"
+#include "internal/transport.hpp"
+
+class FecIntegrationTest : public testing::Test {
+protected:
+    void connect(int group) {
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+
+        serverfd = rudp::socket();
+        clientfd = rudp::socket();
+
+        ASSERT_EQ(rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_FEC, &group, sizeof(group)),
+                  0);
+
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+
+    // NOTE: Stands in for a peer which understands repairs, by speaking the wire format itself, so
+    // that every packet the accepted socket sends can be seen.
+    std::shared_ptr<rudp::internal::transport> raw;
+    sockaddr_in raw_peer{};
+    rudp::u32 raw_acknum = 0;
+    size_t raw_repairs = 0;
+
+    void connect_raw(int group) {
+        using rudp::internal::flag;
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+
+        serverfd = rudp::socket();
+        ASSERT_EQ(rudp::setsockopt(serverfd, rudp::SOL_RUDP, rudp::RUDP_FEC, &group, sizeof(group)),
+                  0);
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        raw = rudp::internal::transport::create(rudp::internal::transport::kind::udp);
+        ASSERT_NE(raw, nullptr);
+
+        sockaddr_in listening = *addr_in;
+        listening.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        rudp::internal::packet syn(
+            rudp::internal::packet_header{.flags = static_cast<rudp::u8>(flag::SYN)});
+        const rudp::u32 net_capabilities = htonl(rudp::internal::CAPABILITY_FEC);
+        ASSERT_TRUE(syn.add_option(rudp::internal::option::capabilities,
+                                   std::span(reinterpret_cast<const rudp::u8 *>(&net_capabilities),
+                                             sizeof(net_capabilities))));
+        ASSERT_GT(rudp::internal::packet::sendto(*raw, syn, &listening), 0);
+
+        constexpr rudp::u8 synack = static_cast<rudp::u8>(flag::SYN) |
+                                    static_cast<rudp::u8>(flag::ACK);
+        std::optional<rudp::internal::packet> received;
+        while (!received.has_value() || (received->header.flags & synack) != synack) {
+            received = receive_raw(5000);
+            ASSERT_TRUE(received.has_value());
+        }
+
+        raw_acknum = received->header.seqnum + 1;
+        ack_raw();
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+
+    // NOTE: The next packet from the accepted socket, counting repairs, or std::nullopt once
+    // timeout_ms passes without one.
+    std::optional<rudp::internal::packet> receive_raw(int timeout_ms) {
+        pollfd pfd{.fd = raw->fd(), .events = POLLIN, .revents = 0};
+        if (poll(&pfd, 1, timeout_ms) != 1) {
+            return std::nullopt;
+        }
+
+        std::optional<rudp::internal::packet> received =
+            rudp::internal::packet::recvfrom(*raw, &raw_peer, nullptr);
+        if (received.has_value() &&
+            (received->header.flags & static_cast<rudp::u8>(rudp::internal::flag::REPAIR))) {
+            raw_repairs++;
+        }
+        return received;
+    }
+
+    void ack_raw() {
+        rudp::internal::packet ack(rudp::internal::packet_header{
+            .flags = static_cast<rudp::u8>(rudp::internal::flag::ACK),
+            .seqnum = 1,
+            .acknum = raw_acknum,
+        });
+        ASSERT_GT(rudp::internal::packet::sendto(*raw, ack, &raw_peer), 0);
+    }
+
+    // NOTE: Sends one byte from the accepted socket, and waits for its segment to arrive.
+    void send_byte() {
+        ASSERT_EQ(rudp::send(accepted_fd, "x", 1, 0), 1);
+
+        while (true) {
+            std::optional<rudp::internal::packet> received = receive_raw(5000);
+            ASSERT_TRUE(received.has_value());
+            if (received->header.length > 0 &&
+                !(received->header.flags & static_cast<rudp::u8>(rudp::internal::flag::REPAIR))) {
+                raw_acknum = received->header.seqnum + received->header.length;
+                return;
+            }
+        }
+    }
+
+    void TearDown() override {
+        rudp::internal::simulator::instance().reset();
+    }
+
+    struct sockaddr addr{};
+
+    int serverfd;
+    int clientfd;
+    int accepted_fd;
+
+    static std::vector<char> data(size_t len) {
+        std::vector<char> data(len);
+        for (size_t i = 0; i < len; i++) {
+            data[i] = static_cast<char>('A' + (i * 7 % 26));
+        }
+        return data;
+    }
+
+    void transfer(size_t len) {
+        std::vector<char> sent = data(len);
+        ASSERT_EQ(rudp::send(clientfd, sent.data(), sent.size(), 0),
+                  static_cast<ssize_t>(sent.size()));
+
+        std::vector<char> received(len);
+        size_t total = 0;
+        while (total < len) {
+            ssize_t got = rudp::recv(accepted_fd, received.data() + total, len - total, 0);
+            ASSERT_GT(got, 0);
+            total += static_cast<size_t>(got);
+        }
+
+        ASSERT_EQ(memcmp(sent.data(), received.data(), len), 0)
+            << "Rebuilt segments must match the ones which were lost.";
+    }
+};
+
+TEST_F(FecIntegrationTest, PacketLoss20) {
+    connect(4);
+    rudp::internal::simulator::instance().drop = 0.2f;
+
+    transfer(64 * 1024);
+}
+
+TEST_F(FecIntegrationTest, PacketLoss30SingleSegmentGroups) {
+    connect(1);
+    rudp::internal::simulator::instance().drop = 0.3f;
+
+    transfer(5 * 1024);
+}
+
+TEST_F(FecIntegrationTest, PartialGroup) {
+    connect(32);
+    rudp::internal::simulator::instance().drop = 0.2f;
+
+    // NOTE: Fewer segments than a group, so only the repair sent once they are out covers them.
+    transfer(3 * 1024 + 100);
+}
+
+TEST_F(FecIntegrationTest, Duplication50) {
+    connect(4);
+    rudp::internal::simulator::instance().duplication = 0.5f;
+
+    transfer(32 * 1024);
+}
+
+TEST_F(FecIntegrationTest, SmallMessagesRepairedPerGroup) {
+    connect_raw(8);
+
+    // NOTE: Each message is acknowledged before the next is sent, so the send buffer drains every
+    // time; only the two full groups are repaired.
+    for (int i = 0; i < 16; i++) {
+        send_byte();
+        ack_raw();
+    }
+    while (receive_raw(500).has_value()) {
+    }
+    ASSERT_EQ(raw_repairs, 2)
+        << "A partial group must not be repaired each time the send buffer drains.";
+
+    // NOTE: An unacknowledged partial group is repaired as it stands once it has waited.
+    send_byte();
+    while (raw_repairs == 2) {
+        ASSERT_TRUE(receive_raw(5000).has_value()) << "A partial group must still be repaired.";
+    }
+    ASSERT_EQ(raw_repairs, 3);
+}
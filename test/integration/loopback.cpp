@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <rudp.hpp>
+
+#include "internal/simulator.hpp"
+
+class LoopbackIntegrationTest : public testing::Test {
+protected:
+    void SetUp() override {
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+
+        serverfd = rudp::socket();
+        clientfd = rudp::socket();
+
+        int transport = rudp::RUDP_TRANSPORT_LOOPBACK;
+        ASSERT_EQ(rudp::setsockopt(serverfd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &transport,
+                                   sizeof(transport)),
+                  0);
+        ASSERT_EQ(rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &transport,
+                                   sizeof(transport)),
+                  0);
+
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        socklen_t len = sizeof(addr);
+        accepted_fd = rudp::accept(serverfd, &addr, &len);
+        ASSERT_GE(accepted_fd, 0);
+
+        msg_size = 512 * 1024;
+        client_data.resize(msg_size);
+
+        for (size_t i = 0; i < msg_size; i++) {
+            client_data[i] = static_cast<char>('A' + (i % 26));
+        }
+    }
+
+    struct sockaddr addr{};
+
+    int serverfd;
+    int clientfd;
+    int accepted_fd;
+    size_t msg_size;
+
+    std::vector<char> client_data;
+
+    size_t recv_all(int sock, std::vector<char> &buffer) {
+        size_t total = 0;
+        while (total < buffer.size()) {
+            ssize_t received = rudp::recv(sock, buffer.data() + total, buffer.size() - total, 0);
+            EXPECT_GT(received, 0);
+            total += static_cast<size_t>(received);
+        }
+        return total;
+    }
+};
+
+TEST_F(LoopbackIntegrationTest, AcceptedPeerIsLoopback) {
+    auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+    ASSERT_EQ(addr_in->sin_family, AF_INET);
+    ASSERT_EQ(addr_in->sin_addr.s_addr, htonl(INADDR_LOOPBACK));
+    ASSERT_NE(addr_in->sin_port, 0);
+}
+
+TEST_F(LoopbackIntegrationTest, ClientToServer) {
+    size_t sent = 0;
+    while (sent < msg_size) {
+        ssize_t n = rudp::send(clientfd, client_data.data() + sent, msg_size - sent, 0);
+        ASSERT_GT(n, 0);
+        sent += static_cast<size_t>(n);
+    }
+
+    std::vector<char> server_received(msg_size);
+    size_t total_received = recv_all(accepted_fd, server_received);
+
+    ASSERT_EQ(total_received, msg_size) << "The server must receive all bytes.";
+    ASSERT_EQ(memcmp(client_data.data(), server_received.data(), msg_size), 0)
+        << "The server must receive the same data sent by the client.";
+}
+
+TEST_F(LoopbackIntegrationTest, PacketLoss30) {
+    auto &sim = rudp::internal::simulator::instance();
+    sim.drop = 0.3f;
+
+    const size_t small = 5 * 1024;
+    ASSERT_EQ(rudp::send(clientfd, client_data.data(), small, 0), static_cast<ssize_t>(small));
+
+    std::vector<char> server_received(small);
+    size_t total_received = recv_all(accepted_fd, server_received);
+
+    ASSERT_EQ(total_received, small) << "The server must receive all bytes.";
+    ASSERT_EQ(memcmp(client_data.data(), server_received.data(), small), 0)
+        << "The server must receive the same data sent by the client.";
+}
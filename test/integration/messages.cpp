@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstring>
+#include <rudp.hpp>
+#include <vector>
+
+class MessagesIntegrationTest : public testing::Test {
+protected:
+    void SetUp() override {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+
+        int enabled = 1;
+        serverfd = rudp::socket();
+        clientfd = rudp::socket();
+
+        ASSERT_EQ(rudp::setsockopt(serverfd, rudp::SOL_RUDP, rudp::RUDP_MESSAGES, &enabled,
+                                   sizeof(enabled)),
+                  0);
+        ASSERT_EQ(rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_MESSAGES, &enabled,
+                                   sizeof(enabled)),
+                  0);
+
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+
+    struct sockaddr addr{};
+
+    int serverfd;
+    int clientfd;
+    int accepted_fd;
+
+    static std::vector<char> message(size_t len, char seed) {
+        std::vector<char> data(len);
+        for (size_t i = 0; i < len; i++) {
+            data[i] = static_cast<char>(seed + static_cast<char>(i % 26));
+        }
+        return data;
+    }
+};
+
+TEST_F(MessagesIntegrationTest, BoundariesPreserved) {
+    // NOTE: Either side of the segment size, so that records are both coalesced and fragmented.
+    const size_t sizes[] = {1, 100, 1023, 1024, 1025, 5000, 64 * 1024, 7};
+
+    char seed = 'A';
+    for (size_t len : sizes) {
+        std::vector<char> data = message(len, seed++);
+        ASSERT_EQ(rudp::send(clientfd, data.data(), data.size(), 0),
+                  static_cast<ssize_t>(data.size()));
+    }
+
+    std::vector<char> received(128 * 1024);
+    seed = 'A';
+    for (size_t len : sizes) {
+        ASSERT_EQ(rudp::recv(accepted_fd, received.data(), received.size(), 0),
+                  static_cast<ssize_t>(len))
+            << "Each recv() must return exactly one record.";
+        ASSERT_EQ(memcmp(received.data(), message(len, seed++).data(), len), 0);
+    }
+}
+
+TEST_F(MessagesIntegrationTest, Truncated) {
+    std::vector<char> first = message(3000, 'a');
+    std::vector<char> second = message(10, 'A');
+    ASSERT_EQ(rudp::send(clientfd, first.data(), first.size(), 0), 3000);
+    ASSERT_EQ(rudp::send(clientfd, second.data(), second.size(), 0), 10);
+
+    char received[100];
+    struct iovec iov{.iov_base = received, .iov_len = sizeof(received)};
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    ASSERT_EQ(rudp::recvmsg(accepted_fd, &msg, MSG_PEEK), static_cast<ssize_t>(sizeof(received)));
+    ASSERT_EQ(msg.msg_flags, MSG_TRUNC);
+
+    ASSERT_EQ(rudp::recvmsg(accepted_fd, &msg, 0), static_cast<ssize_t>(sizeof(received)));
+    ASSERT_EQ(msg.msg_flags, MSG_TRUNC) << "A record which does not fit must be reported.";
+    ASSERT_EQ(memcmp(received, first.data(), sizeof(received)), 0);
+
+    ASSERT_EQ(rudp::recvmsg(accepted_fd, &msg, 0), 10)
+        << "The rest of a truncated record must be discarded.";
+    ASSERT_EQ(msg.msg_flags, 0);
+    ASSERT_EQ(memcmp(received, second.data(), second.size()), 0);
+}
+
+TEST_F(MessagesIntegrationTest, SendmsgIsOneRecord) {
+    char header[] = "head:";
+    char body[] = "body";
+    struct iovec iov[] = {
+        {.iov_base = header, .iov_len = strlen(header)},
+        {.iov_base = body, .iov_len = strlen(body)},
+    };
+    struct msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
+    ASSERT_EQ(rudp::sendmsg(clientfd, &msg, 0), 9);
+    ASSERT_EQ(rudp::send(clientfd, "next", 4, 0), 4);
+
+    char received[64] = {};
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0), 9);
+    ASSERT_EQ(memcmp(received, "head:body", 9), 0);
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0), 4);
+}
+
+TEST_F(MessagesIntegrationTest, ZeroCopyIsOneRecord) {
+    std::vector<char> data = message(4000, 'z');
+    ASSERT_EQ(rudp::send_zc(clientfd, data.data(), data.size(), 0), 4000);
+
+    std::vector<char> received(8000);
+    ASSERT_EQ(rudp::recv(accepted_fd, received.data(), received.size(), 0), 4000);
+    ASSERT_EQ(memcmp(received.data(), data.data(), data.size()), 0);
+}
+
+TEST_F(MessagesIntegrationTest, TooLarge) {
+    std::vector<char> data(1024 * 1024);
+
+    ASSERT_EQ(rudp::send(clientfd, data.data(), data.size(), 0), -1);
+    ASSERT_EQ(errno, EMSGSIZE) << "A record must fit in the send buffer.";
+}
+
+TEST_F(MessagesIntegrationTest, TooLargeZeroCopy) {
+    std::vector<char> data(1024 * 1024);
+
+    ASSERT_EQ(rudp::send_zc(clientfd, data.data(), data.size(), 0), -1);
+    ASSERT_EQ(errno, EMSGSIZE) << "A zero-copy record must fit in the send buffer too.";
+}
+
+TEST_F(MessagesIntegrationTest, SendIsAtomic) {
+    // NOTE: Nothing reads, so the buffer fills; a record must then be refused rather than split.
+    std::vector<char> data(100 * 1024, 'x');
+    ssize_t sent = 0;
+    while ((sent = rudp::send(clientfd, data.data(), data.size(), MSG_DONTWAIT)) > 0) {
+        ASSERT_EQ(sent, static_cast<ssize_t>(data.size()));
+    }
+
+    ASSERT_EQ(errno, EAGAIN);
+}
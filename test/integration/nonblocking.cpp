@@ -0,0 +1,109 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <rudp.hpp>
+
+#include "internal/simulator.hpp"
+
+// NOTE: Everything here runs on the test thread alone, so any call which blocks hangs the test.
+class NonblockingIntegrationTest : public testing::Test {
+protected:
+    static constexpr size_t connections = 16;
+    static constexpr size_t msg_size = 64 * 1024;
+
+    void SetUp() override {
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr_in->sin_port = htons(1234);
+
+        serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, static_cast<int>(connections)), 0);
+        ASSERT_EQ(rudp::fcntl(serverfd, F_SETFL, O_NONBLOCK), 0);
+
+        for (size_t i = 0; i < connections; i++) {
+            int fd = rudp::socket();
+            ASSERT_EQ(rudp::fcntl(fd, F_SETFL, O_NONBLOCK), 0);
+            ASSERT_EQ(rudp::connect(fd, &addr, sizeof(addr)), -1);
+            ASSERT_EQ(errno, EINPROGRESS);
+            clients.push_back(fd);
+        }
+
+        while (accepted.size() < connections) {
+            int fd = rudp::accept(serverfd, nullptr, nullptr);
+            if (fd < 0) {
+                ASSERT_EQ(errno, EAGAIN);
+                continue;
+            }
+
+            ASSERT_EQ(rudp::fcntl(fd, F_SETFL, O_NONBLOCK), 0);
+            accepted.push_back(fd);
+        }
+
+        data.resize(msg_size);
+        for (size_t i = 0; i < msg_size; i++) {
+            data[i] = static_cast<char>('A' + (i % 26));
+        }
+    }
+
+    struct sockaddr addr{};
+
+    int serverfd;
+    std::vector<int> clients;
+    std::vector<int> accepted;
+    std::vector<char> data;
+};
+
+TEST_F(NonblockingIntegrationTest, ConcurrentTransfers) {
+    std::vector<size_t> sent(connections, 0);
+    std::vector<size_t> received(connections, 0);
+    std::vector<std::vector<char>> buffers(connections, std::vector<char>(msg_size));
+
+    size_t done = 0;
+    while (done < connections) {
+        done = 0;
+
+        for (size_t i = 0; i < connections; i++) {
+            if (sent[i] < msg_size) {
+                ssize_t n = rudp::send(clients[i], data.data() + sent[i], msg_size - sent[i], 0);
+                if (n < 0) {
+                    ASSERT_EQ(errno, EAGAIN);
+                } else {
+                    sent[i] += static_cast<size_t>(n);
+                }
+            }
+
+            if (received[i] < msg_size) {
+                ssize_t n = rudp::recv(accepted[i], buffers[i].data() + received[i],
+                                       msg_size - received[i], 0);
+                if (n < 0) {
+                    ASSERT_EQ(errno, EAGAIN);
+                } else {
+                    received[i] += static_cast<size_t>(n);
+                }
+            }
+
+            done += (received[i] == msg_size);
+        }
+    }
+
+    // NOTE: The listener queues connections in the order their handshakes complete, so the
+    // accepted sockets need not line up with the clients; we only check that nothing was lost.
+    for (size_t i = 0; i < connections; i++) {
+        ASSERT_EQ(memcmp(data.data(), buffers[i].data(), msg_size), 0)
+            << "Every connection must receive the same data sent by its client.";
+    }
+}
+
+TEST_F(NonblockingIntegrationTest, DontwaitOnBlockingSocket) {
+    ASSERT_EQ(rudp::fcntl(accepted[0], F_SETFL, 0), 0);
+
+    char byte{};
+    ASSERT_EQ(rudp::recv(accepted[0], &byte, sizeof(byte), MSG_DONTWAIT), -1);
+    ASSERT_EQ(errno, EAGAIN) << "MSG_DONTWAIT must not block regardless of O_NONBLOCK.";
+}
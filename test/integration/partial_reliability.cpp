@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <cstring>
+#include <rudp.hpp>
+#include <thread>
+
+#include "internal/simulator.hpp"
+
+class PartialReliabilityIntegrationTest : public testing::Test {
+protected:
+    void SetUp() override {
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+
+        serverfd = rudp::socket();
+        clientfd = rudp::socket();
+
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+
+    void TearDown() override {
+        rudp::internal::simulator::instance().reset();
+    }
+
+    struct sockaddr addr{};
+
+    int serverfd;
+    int clientfd;
+    int accepted_fd;
+
+    // NOTE: Sends while every packet is dropped, leaving the message lost on its first send.
+    void send_lost(int policy, int value) {
+        auto &sim = rudp::internal::simulator::instance();
+
+        sim.drop = 1.0f;
+        ASSERT_EQ(rudp::send_pr(clientfd, 0, "stale", 5, policy, value, 0), 5);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        sim.reset();
+    }
+};
+
+TEST_F(PartialReliabilityIntegrationTest, DeadlineSkipsLoss) {
+    send_lost(rudp::RUDP_PR_DEADLINE, 200);
+    ASSERT_EQ(rudp::send(clientfd, "fresh", 5, 0), 5);
+
+    const auto start = std::chrono::steady_clock::now();
+    char received[16] = {};
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0), 5);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1))
+        << "An expired message must stop holding up its stream without waiting to retransmit.";
+    ASSERT_STREQ(received, "fresh");
+}
+
+TEST_F(PartialReliabilityIntegrationTest, UnreliableSkipsLoss) {
+    // NOTE: The marker is lost along with the message, so this waits on its retransmission.
+    send_lost(rudp::RUDP_PR_UNRELIABLE, 0);
+    ASSERT_EQ(rudp::send(clientfd, "fresh", 5, 0), 5);
+
+    char received[16] = {};
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0), 5);
+    ASSERT_STREQ(received, "fresh") << "A lost unreliable message must never be retransmitted.";
+}
+
+TEST_F(PartialReliabilityIntegrationTest, OtherStreamsUnaffected) {
+    const int reliable = rudp::open_stream(clientfd);
+    send_lost(rudp::RUDP_PR_DEADLINE, 10 * 1000);
+
+    ASSERT_EQ(rudp::send_stream(clientfd, reliable, "reliable", 8, 0), 8);
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, 0), reliable);
+
+    char received[16] = {};
+    ASSERT_EQ(rudp::recv_stream(accepted_fd, reliable, received, sizeof(received), 0), 8);
+    ASSERT_STREQ(received, "reliable");
+
+    // NOTE: Still within its deadline, the message is retransmitted rather than abandoned.
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0), 5);
+    ASSERT_EQ(memcmp(received, "stale", 5), 0);
+}
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <rudp.hpp>
 
 class SendRecvIntegrationTest : public ::testing::Test {
@@ -98,3 +101,77 @@ TEST_F(SendRecvIntegrationTest, Duplex) {
     ASSERT_EQ(memcmp(server_data.data(), client_received.data(), msg_size), 0)
         << "The client must receive the same data sent by the server.";
 }
+
+TEST_F(SendRecvIntegrationTest, ZeroCopySendClientToServer) {
+    ASSERT_EQ(rudp::send_zc(clientfd, client_data.data(), client_data.size(), 0),
+              static_cast<ssize_t>(client_data.size()));
+
+    uint32_t first{};
+    uint32_t last{};
+    ASSERT_EQ(rudp::send_zc_completions(clientfd, &first, &last, 0), 0);
+    ASSERT_EQ(first, 0u);
+    ASSERT_EQ(last, 0u);
+
+    // NOTE: Once completed, the buffer is ours again and changing it cannot affect the stream.
+    std::fill(client_data.begin(), client_data.end(), '\0');
+
+    std::vector<char> server_received(msg_size);
+    size_t total_received = recv_all(accepted_fd, server_received);
+
+    ASSERT_EQ(total_received, msg_size) << "The server must receive all bytes.";
+    for (size_t i = 0; i < msg_size; i++) {
+        ASSERT_EQ(server_received[i], static_cast<char>('A' + (i % 26)))
+            << "The server must receive the buffer as it was when sent.";
+    }
+}
+
+TEST_F(SendRecvIntegrationTest, ZeroCopyClientToServer) {
+    ASSERT_EQ(rudp::send(clientfd, client_data.data(), client_data.size(), 0),
+              static_cast<ssize_t>(client_data.size()));
+
+    size_t total_received = 0;
+    while (total_received < msg_size) {
+        const void *buf = nullptr;
+        ssize_t received = rudp::recv_zc(accepted_fd, &buf, 0);
+        ASSERT_GT(received, 0);
+
+        ASSERT_EQ(memcmp(client_data.data() + total_received, buf, static_cast<size_t>(received)),
+                  0)
+            << "Every loan must hold the next bytes of the stream.";
+        ASSERT_EQ(rudp::release(accepted_fd, buf), 0);
+
+        total_received += static_cast<size_t>(received);
+    }
+
+    ASSERT_EQ(total_received, msg_size) << "The server must receive all bytes.";
+}
+
+TEST_F(SendRecvIntegrationTest, FramedScatterGather) {
+    constexpr uint32_t frames = 100;
+
+    for (uint32_t i = 0; i < frames; i++) {
+        uint32_t length = 1 + (i * 37) % 2048;
+        struct iovec iov[] = {
+            {.iov_base = &length, .iov_len = sizeof(length)},
+            {.iov_base = client_data.data(), .iov_len = length},
+        };
+        struct msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = 2;
+
+        ASSERT_EQ(rudp::sendmsg(clientfd, &msg, 0),
+                  static_cast<ssize_t>(sizeof(length) + length));
+    }
+
+    std::vector<char> body(2048);
+    for (uint32_t i = 0; i < frames; i++) {
+        uint32_t length{};
+        ASSERT_EQ(rudp::recv(accepted_fd, &length, sizeof(length), MSG_WAITALL),
+                  static_cast<ssize_t>(sizeof(length)));
+        ASSERT_EQ(length, 1 + (i * 37) % 2048) << "Every header must be read whole.";
+
+        ASSERT_EQ(rudp::recv(accepted_fd, body.data(), length, MSG_WAITALL),
+                  static_cast<ssize_t>(length));
+        ASSERT_EQ(memcmp(body.data(), client_data.data(), length), 0);
+    }
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <rudp.hpp>
+
+#include "internal/shm.hpp"
+#include "internal/simulator.hpp"
+#include "internal/transport.hpp"
+
+class ShmIntegrationTest : public testing::Test {
+protected:
+    void SetUp() override {
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr_in->sin_port = htons(1234);
+
+        msg_size = 512 * 1024;
+        client_data.resize(msg_size);
+
+        for (size_t i = 0; i < msg_size; i++) {
+            client_data[i] = static_cast<char>('A' + (i % 26));
+        }
+    }
+
+    struct sockaddr addr{};
+
+    int serverfd;
+    int clientfd;
+    int accepted_fd;
+    size_t msg_size;
+
+    std::vector<char> client_data;
+
+    void establish(int server_shm, int client_shm) {
+        serverfd = rudp::socket();
+        clientfd = rudp::socket();
+
+        ASSERT_EQ(rudp::setsockopt(serverfd, rudp::SOL_RUDP, rudp::RUDP_SHM, &server_shm,
+                                   sizeof(server_shm)),
+                  0);
+        ASSERT_EQ(rudp::setsockopt(clientfd, rudp::SOL_RUDP, rudp::RUDP_SHM, &client_shm,
+                                   sizeof(client_shm)),
+                  0);
+
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+
+    int shm_active(int sock) {
+        int value = -1;
+        socklen_t len = sizeof(value);
+        EXPECT_EQ(rudp::getsockopt(sock, rudp::SOL_RUDP, rudp::RUDP_SHM_ACTIVE, &value, &len), 0);
+        return value;
+    }
+
+    void send_all(int sock, const char *data, size_t len) {
+        size_t sent = 0;
+        while (sent < len) {
+            ssize_t n = rudp::send(sock, data + sent, len - sent, 0);
+            ASSERT_GT(n, 0);
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    size_t recv_all(int sock, std::vector<char> &buffer) {
+        size_t total = 0;
+        while (total < buffer.size()) {
+            ssize_t received = rudp::recv(sock, buffer.data() + total, buffer.size() - total, 0);
+            EXPECT_GT(received, 0);
+            total += static_cast<size_t>(received);
+        }
+        return total;
+    }
+};
+
+TEST_F(ShmIntegrationTest, BothOptedIn) {
+    establish(1, 1);
+
+    ASSERT_EQ(shm_active(clientfd), 1) << "connect() must only return once the switch is made.";
+    ASSERT_EQ(shm_active(accepted_fd), 1) << "accept() must only return once the switch is made.";
+}
+
+TEST_F(ShmIntegrationTest, ServerNotOptedIn) {
+    establish(0, 1);
+
+    ASSERT_EQ(shm_active(clientfd), 0);
+    ASSERT_EQ(shm_active(accepted_fd), 0);
+}
+
+TEST_F(ShmIntegrationTest, ClientNotOptedIn) {
+    establish(1, 0);
+
+    ASSERT_EQ(shm_active(clientfd), 0);
+    ASSERT_EQ(shm_active(accepted_fd), 0);
+}
+
+TEST_F(ShmIntegrationTest, ClientToServer) {
+    establish(1, 1);
+    send_all(clientfd, client_data.data(), msg_size);
+
+    std::vector<char> server_received(msg_size);
+    size_t total_received = recv_all(accepted_fd, server_received);
+
+    ASSERT_EQ(total_received, msg_size) << "The server must receive all bytes.";
+    ASSERT_EQ(memcmp(client_data.data(), server_received.data(), msg_size), 0)
+        << "The server must receive the same data sent by the client.";
+}
+
+TEST_F(ShmIntegrationTest, ServerToClient) {
+    establish(1, 1);
+    send_all(accepted_fd, client_data.data(), msg_size);
+
+    std::vector<char> client_received(msg_size);
+    size_t total_received = recv_all(clientfd, client_received);
+
+    ASSERT_EQ(total_received, msg_size) << "The client must receive all bytes.";
+    ASSERT_EQ(memcmp(client_data.data(), client_received.data(), msg_size), 0)
+        << "The client must receive the same data sent by the server.";
+}
+
+TEST_F(ShmIntegrationTest, PacketLoss30) {
+    establish(1, 1);
+
+    auto &sim = rudp::internal::simulator::instance();
+    sim.drop = 0.3f;
+
+    const size_t small = 5 * 1024;
+    send_all(clientfd, client_data.data(), small);
+
+    std::vector<char> server_received(small);
+    size_t total_received = recv_all(accepted_fd, server_received);
+
+    ASSERT_EQ(total_received, small) << "The server must receive all bytes.";
+    ASSERT_EQ(memcmp(client_data.data(), server_received.data(), small), 0)
+        << "The server must receive the same data sent by the client.";
+}
+
+TEST_F(ShmIntegrationTest, OfferWithoutNonceIgnored) {
+    std::shared_ptr<rudp::internal::transport> listening =
+        rudp::internal::transport::create(rudp::internal::transport::kind::udp);
+    ASSERT_NE(listening, nullptr);
+    ASSERT_EQ(listening->bind(*reinterpret_cast<const sockaddr_in *>(&addr)), 0);
+
+    rudp::u64 nonce = 0;
+    int listenfd = rudp::internal::shm::listen(*listening, &nonce);
+    ASSERT_GE(listenfd, 0);
+
+    const auto &peer = *reinterpret_cast<const sockaddr_in *>(&addr);
+    ASSERT_NE(rudp::internal::shm::offer(peer, nonce + 1), nullptr);
+    ASSERT_EQ(rudp::internal::shm::accept(listenfd, peer, nonce), nullptr)
+        << "An offer which does not carry back the nonce must be dropped.";
+    ASSERT_EQ(errno, EAGAIN);
+
+    ASSERT_NE(rudp::internal::shm::offer(peer, nonce + 1), nullptr);
+    ASSERT_NE(rudp::internal::shm::offer(peer, nonce), nullptr);
+    ASSERT_NE(rudp::internal::shm::accept(listenfd, peer, nonce), nullptr)
+        << "The offer carrying the nonce must be taken past any forged ahead of it.";
+
+    ::close(listenfd);
+}
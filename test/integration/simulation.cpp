@@ -2,6 +2,10 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <rudp.hpp>
 
 #include "internal/simulator.hpp"
@@ -105,3 +109,73 @@ TEST_F(SimulationIntegrationTest, PacketLoss30Latency1000to5000) {
     ASSERT_EQ(memcmp(client_data.data(), server_received.data(), msg_size), 0)
         << "The server must receive the same data sent by the client.";
 }
+
+TEST_F(SimulationIntegrationTest, PacketLoss30AdaptsRetransmitTime) {
+    auto &sim = rudp::internal::simulator::instance();
+    sim.drop = 0.3f;
+
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(rudp::send(clientfd, client_data.data(), client_data.size(), 0),
+              static_cast<ssize_t>(client_data.size()));
+
+    std::vector<char> server_received(msg_size);
+    size_t total_received = recv_all(accepted_fd, server_received);
+
+    ASSERT_EQ(total_received, msg_size) << "The server must receive all bytes.";
+    ASSERT_LT(std::chrono::steady_clock::now() - start, rudp::internal::constants::RETRANSMIT_TIME)
+        << "Timestamped round trips must bring the retransmission timeout down to the path's.";
+}
+
+TEST_F(SimulationIntegrationTest, Corruption30) {
+    auto &sim = rudp::internal::simulator::instance();
+    sim.corruption = 0.3f;
+
+    ASSERT_EQ(rudp::send(clientfd, client_data.data(), client_data.size(), 0),
+              static_cast<ssize_t>(client_data.size()));
+
+    std::vector<char> server_received(msg_size);
+    size_t total_received = recv_all(accepted_fd, server_received);
+
+    ASSERT_EQ(total_received, msg_size) << "The server must receive all bytes.";
+    ASSERT_EQ(memcmp(client_data.data(), server_received.data(), msg_size), 0)
+        << "Corrupted packets must be dropped and retransmitted rather than delivered.";
+}
+
+TEST_F(SimulationIntegrationTest, OnDataPacketLoss30) {
+    // NOTE: Shared with the callback, which the event thread may still be running should the test
+    // give up waiting on it.
+    struct delivery {
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::vector<char> received;
+    };
+    auto delivered = std::make_shared<delivery>();
+
+    ASSERT_EQ(rudp::on_data(accepted_fd,
+                            [delivered](std::span<const std::byte> data) {
+                                {
+                                    std::lock_guard<std::mutex> lock(delivered->mtx);
+                                    const auto *bytes =
+                                        reinterpret_cast<const char *>(data.data());
+                                    delivered->received.insert(delivered->received.end(), bytes,
+                                                               bytes + data.size());
+                                }
+                                delivered->cv.notify_one();
+                            }),
+              0);
+
+    auto &sim = rudp::internal::simulator::instance();
+    sim.drop = 0.3f;
+
+    ASSERT_EQ(rudp::send(clientfd, client_data.data(), client_data.size(), 0),
+              static_cast<ssize_t>(client_data.size()));
+
+    std::unique_lock<std::mutex> lock(delivered->mtx);
+    ASSERT_TRUE(delivered->cv.wait_for(lock, std::chrono::seconds(60), [&]() {
+        return delivered->received.size() >= msg_size;
+    })) << "The callback must see every byte in time, but saw "
+        << delivered->received.size() << " of " << msg_size << ".";
+
+    ASSERT_EQ(delivered->received, client_data)
+        << "The callback must see the same data sent by the client, in order, despite loss.";
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <cstring>
+#include <rudp.hpp>
+#include <thread>
+#include <vector>
+
+#include "internal/simulator.hpp"
+
+class StreamsIntegrationTest : public testing::Test {
+protected:
+    void SetUp() override {
+        rudp::internal::simulator::instance().reset();
+
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+
+        serverfd = rudp::socket();
+        clientfd = rudp::socket();
+
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+
+    void TearDown() override {
+        rudp::internal::simulator::instance().reset();
+    }
+
+    struct sockaddr addr{};
+
+    int serverfd;
+    int clientfd;
+    int accepted_fd;
+
+    void recv_all(int stream, std::vector<char> &buffer) {
+        size_t total = 0;
+        while (total < buffer.size()) {
+            ssize_t received = rudp::recv_stream(accepted_fd, stream, buffer.data() + total,
+                                                 buffer.size() - total, 0);
+            ASSERT_GT(received, 0);
+            total += static_cast<size_t>(received);
+        }
+    }
+};
+
+TEST_F(StreamsIntegrationTest, Interleaved) {
+    constexpr int count = 8;
+    constexpr size_t size = 20 * 1024;
+
+    int streams[count];
+    std::vector<char> sent[count];
+    for (int i = 0; i < count; i++) {
+        streams[i] = rudp::open_stream(clientfd);
+        ASSERT_GT(streams[i], 0);
+
+        sent[i].resize(size);
+        for (size_t j = 0; j < size; j++) {
+            sent[i][j] = static_cast<char>('A' + i + static_cast<int>(j % 7));
+        }
+    }
+
+    // NOTE: In pieces, alternating streams, so that their segments interleave on the wire.
+    constexpr size_t piece = 1500;
+    for (size_t offset = 0; offset < size; offset += piece) {
+        for (int i = 0; i < count; i++) {
+            const size_t len = std::min(piece, size - offset);
+            ASSERT_EQ(rudp::send_stream(clientfd, streams[i], sent[i].data() + offset, len, 0),
+                      static_cast<ssize_t>(len));
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        const int accepted = rudp::accept_stream(accepted_fd, 0);
+        ASSERT_GT(accepted, 0);
+
+        const int index = (accepted - 1) / 2;
+        std::vector<char> received(size);
+        recv_all(accepted, received);
+        ASSERT_EQ(memcmp(received.data(), sent[index].data(), size), 0);
+    }
+}
+
+TEST_F(StreamsIntegrationTest, LossHoldsUpOnlyItsStream) {
+    auto &sim = rudp::internal::simulator::instance();
+    const int lossy = rudp::open_stream(clientfd);
+    const int clear = rudp::open_stream(clientfd);
+
+    // NOTE: The first send of the lossy stream's segment is dropped, so it waits on a retransmit.
+    sim.drop = 1.0f;
+    ASSERT_EQ(rudp::send_stream(clientfd, lossy, "lost", 4, 0), 4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sim.reset();
+
+    ASSERT_EQ(rudp::send_stream(clientfd, clear, "clear", 5, 0), 5);
+
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, 0), clear);
+
+    char received[8] = {};
+    ASSERT_EQ(rudp::recv_stream(accepted_fd, clear, received, sizeof(received), 0), 5);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1))
+        << "Data behind a gap on another stream must not wait for its retransmission.";
+    ASSERT_EQ(memcmp(received, "clear", 5), 0);
+
+    // NOTE: Once retransmitted, the lost segment fills the gap and both are acknowledged.
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, 0), lossy);
+    ASSERT_EQ(rudp::recv_stream(accepted_fd, lossy, received, sizeof(received), 0), 4);
+    ASSERT_EQ(memcmp(received, "lost", 4), 0);
+
+    ASSERT_EQ(rudp::send(clientfd, "after", 5, 0), 5);
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0), 5);
+    ASSERT_EQ(memcmp(received, "after", 5), 0);
+}
@@ -95,3 +95,34 @@ TEST_F(AcceptUnitTest, Success) {
     ASSERT_EQ(accepted_addr->sin_family, AF_INET);
     ASSERT_NE(accepted_addr->sin_port, 0);  // client port is unknown
 }
+
+TEST_F(AcceptUnitTest, NonblockingNoneReady) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+    ASSERT_EQ(rudp::fcntl(serverfd, F_SETFL, O_NONBLOCK), 0);
+
+    ASSERT_EQ(rudp::accept(serverfd, nullptr, nullptr), -1);
+    ASSERT_EQ(errno, EAGAIN);
+}
+
+TEST_F(AcceptUnitTest, NonblockingNotInherited) {
+    reinterpret_cast<struct sockaddr_in *>(&addr)->sin_port = htons(1234);
+
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+    ASSERT_EQ(rudp::fcntl(serverfd, F_SETFL, O_NONBLOCK), 0);
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+    int accepted_fd = -1;
+    while (accepted_fd < 0) {
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_TRUE(accepted_fd >= 0 || errno == EAGAIN);
+    }
+
+    ASSERT_EQ(rudp::fcntl(accepted_fd, F_GETFL) & O_NONBLOCK, 0)
+        << "An accepted socket must not inherit O_NONBLOCK.";
+}
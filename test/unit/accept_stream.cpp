@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <rudp.hpp>
+#include <span>
+
+#include "internal/common.hpp"
+#include "internal/packet.hpp"
+#include "internal/transport.hpp"
+
+class AcceptStreamUnitTest : public testing::Test {
+protected:
+    AcceptStreamUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+
+    // NOTE: Stands in for a peer which numbers its streams as it pleases, by speaking the wire
+    // format itself. It is the active side, so the accepted socket numbers its own streams even.
+    std::shared_ptr<rudp::internal::transport> raw;
+    sockaddr_in raw_peer{};
+    rudp::u32 raw_seqnum = 0;
+    rudp::u32 raw_acknum = 0;
+    rudp::u32 raw_synced = 0;
+
+    void establish_raw() {
+        using rudp::internal::flag;
+
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        raw = rudp::internal::transport::create(rudp::internal::transport::kind::udp);
+        ASSERT_NE(raw, nullptr);
+
+        sockaddr_in listening = *reinterpret_cast<const sockaddr_in *>(&addr);
+        listening.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        rudp::internal::packet syn(
+            rudp::internal::packet_header{.flags = static_cast<rudp::u8>(flag::SYN)});
+        ASSERT_GT(rudp::internal::packet::sendto(*raw, syn, &listening), 0);
+
+        constexpr rudp::u8 synack = static_cast<rudp::u8>(flag::SYN) |
+                                    static_cast<rudp::u8>(flag::ACK);
+        std::optional<rudp::internal::packet> received;
+        while (!received.has_value() || (received->header.flags & synack) != synack) {
+            pollfd pfd{.fd = raw->fd(), .events = POLLIN, .revents = 0};
+            ASSERT_EQ(poll(&pfd, 1, 5000), 1);
+            received = rudp::internal::packet::recvfrom(*raw, &raw_peer, nullptr);
+        }
+
+        raw_seqnum = 1;
+        raw_acknum = received->header.seqnum + 1;
+
+        rudp::internal::packet ack(rudp::internal::packet_header{
+            .flags = static_cast<rudp::u8>(flag::ACK),
+            .seqnum = raw_seqnum,
+            .acknum = raw_acknum,
+        });
+        ASSERT_GT(rudp::internal::packet::sendto(*raw, ack, &raw_peer), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+
+    void send_raw(rudp::u16 stream, rudp::u32 offset, const char *byte) {
+        rudp::internal::packet data(rudp::internal::packet_header{
+            .seqnum = raw_seqnum,
+            .acknum = raw_acknum,
+            .length = 1,
+            .stream = stream,
+            .offset = offset,
+        });
+        data.view_data(std::span(reinterpret_cast<const rudp::u8 *>(byte), 1), nullptr);
+        ASSERT_GT(rudp::internal::packet::sendto(*raw, data, &raw_peer), 0);
+        raw_seqnum++;
+    }
+
+    // NOTE: Data is handled in sequence, so once this arrives everything sent before it has been.
+    void sync_raw() {
+        send_raw(0, raw_synced++, "z");
+
+        char byte{};
+        ASSERT_EQ(rudp::recv(accepted_fd, &byte, 1, 0), 1);
+        ASSERT_EQ(byte, 'z');
+    }
+};
+
+TEST_F(AcceptStreamUnitTest, SockDne) {
+    ASSERT_EQ(rudp::accept_stream(-1, 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(AcceptStreamUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+
+    ASSERT_EQ(rudp::accept_stream(fd, 0), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(AcceptStreamUnitTest, DontwaitNoStream) {
+    establish();
+
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, MSG_DONTWAIT), -1);
+    ASSERT_EQ(errno, EAGAIN);
+}
+
+TEST_F(AcceptStreamUnitTest, OpenedByFirstByte) {
+    establish();
+
+    const int first = rudp::open_stream(clientfd);
+    const int second = rudp::open_stream(clientfd);
+    ASSERT_EQ(rudp::send_stream(clientfd, second, "b", 1, 0), 1);
+    ASSERT_EQ(rudp::send_stream(clientfd, first, "a", 1, 0), 1);
+
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, 0), second)
+        << "Streams must be accepted in the order their first bytes arrive.";
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, 0), first);
+
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, MSG_DONTWAIT), -1);
+    ASSERT_EQ(errno, EAGAIN);
+}
+
+TEST_F(AcceptStreamUnitTest, OwnStreamNotAccepted) {
+    establish();
+
+    const int opened = rudp::open_stream(clientfd);
+    ASSERT_EQ(rudp::send_stream(clientfd, opened, "a", 1, 0), 1);
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, 0), opened);
+
+    ASSERT_EQ(rudp::send_stream(accepted_fd, opened, "b", 1, 0), 1);
+
+    char byte{};
+    ASSERT_EQ(rudp::recv_stream(clientfd, opened, &byte, 1, 0), 1);
+    ASSERT_EQ(rudp::accept_stream(clientfd, MSG_DONTWAIT), -1)
+        << "A reply on our own stream must not be offered back to us.";
+    ASSERT_EQ(errno, EAGAIN);
+}
+
+TEST_F(AcceptStreamUnitTest, PeerOnOwnStreamDropped) {
+    establish_raw();
+
+    send_raw(2, 0, "x");
+    sync_raw();
+
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, MSG_DONTWAIT), -1);
+    ASSERT_EQ(errno, EAGAIN);
+
+    const int opened = rudp::open_stream(accepted_fd);
+    ASSERT_EQ(opened, 2);
+
+    char byte{};
+    ASSERT_EQ(rudp::recv_stream(accepted_fd, opened, &byte, 1, MSG_DONTWAIT), -1)
+        << "Data on a stream of ours which we never opened must be dropped.";
+    ASSERT_EQ(errno, EAGAIN);
+}
+
+TEST_F(AcceptStreamUnitTest, PeerStreamsCapped) {
+    establish_raw();
+
+    constexpr int cap = 256;
+    // NOTE: The raw peer never retransmits, so it must not overrun the kernel's receive buffer.
+    for (int i = 0; i <= cap; i++) {
+        send_raw(static_cast<rudp::u16>(2 * i + 1), 0, "x");
+        if (i % 32 == 31) {
+            sync_raw();
+        }
+    }
+    sync_raw();
+
+    for (int i = 0; i < cap; i++) {
+        ASSERT_EQ(rudp::accept_stream(accepted_fd, MSG_DONTWAIT), 2 * i + 1);
+    }
+
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, MSG_DONTWAIT), -1)
+        << "The peer must not open streams past the cap.";
+    ASSERT_EQ(errno, EAGAIN);
+}
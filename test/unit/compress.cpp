@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "internal/common.hpp"
+#include "internal/compress.hpp"
+
+// NOTE: Decompresses into a buffer larger than the output it is given, and checks that nothing past
+// that output was written.
+static std::optional<size_t> decompress_guarded(const std::vector<rudp::u8> &block, size_t size,
+                                                std::vector<rudp::u8> &output) {
+    output.assign(size + 64, 0xA5);
+    const std::optional<size_t> result =
+        rudp::internal::lz_decompress(block, std::span(output).first(size));
+
+    EXPECT_TRUE(std::all_of(output.begin() + static_cast<std::ptrdiff_t>(size), output.end(),
+                            [](rudp::u8 byte) { return byte == 0xA5; }))
+        << "Decompression must never write past its output.";
+    return result;
+}
+
+static void round_trip(const std::vector<rudp::u8> &input, size_t capacity) {
+    std::vector<rudp::u8> block(capacity);
+    const size_t size = rudp::internal::lz_compress(input, block);
+    ASSERT_GT(size, 0);
+    ASSERT_LE(size, capacity);
+    block.resize(size);
+
+    std::vector<rudp::u8> output;
+    ASSERT_EQ(decompress_guarded(block, input.size(), output), input.size());
+    ASSERT_TRUE(std::equal(input.begin(), input.end(), output.begin()));
+
+    if (!input.empty()) {
+        ASSERT_EQ(decompress_guarded(block, input.size() - 1, output), std::nullopt)
+            << "A block too large for its output must be rejected, not cut short.";
+    }
+}
+
+TEST(CompressUnitTest, RoundTripEmpty) {
+    round_trip({}, 16);
+}
+
+TEST(CompressUnitTest, RoundTripIncompressible) {
+    std::vector<rudp::u8> input(rudp::internal::MAX_LZ_BLOCK);
+    rudp::u32 state = 0x12345678;
+    for (rudp::u8 &byte : input) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<rudp::u8>(state);
+    }
+
+    std::vector<rudp::u8> block(input.size());
+    ASSERT_EQ(rudp::internal::lz_compress(input, block), 0)
+        << "Input which does not shrink must be reported as not fitting.";
+
+    round_trip(input, 2 * input.size());
+}
+
+TEST(CompressUnitTest, RoundTripRepetitive) {
+    const std::vector<rudp::u8> input(rudp::internal::MAX_LZ_BLOCK, 'a');
+
+    std::vector<rudp::u8> block(input.size());
+    const size_t size = rudp::internal::lz_compress(input, block);
+    ASSERT_GT(size, 0);
+    ASSERT_LT(size, input.size() / 64);
+
+    round_trip(input, size);
+}
+
+TEST(CompressUnitTest, RoundTripMaximumSize) {
+    constexpr std::string_view text = "the quick brown fox ";
+    std::vector<rudp::u8> input(rudp::internal::MAX_LZ_BLOCK);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = static_cast<rudp::u8>(static_cast<size_t>(text[i % text.size()]) + i / 97 % 3);
+    }
+
+    round_trip(input, input.size());
+}
+
+TEST(CompressUnitTest, TruncatedLiteralRun) {
+    std::vector<rudp::u8> output;
+    ASSERT_EQ(decompress_guarded({0x50, 'a', 'b', 'c'}, 16, output), std::nullopt)
+        << "A literal run past the end of the block must be rejected.";
+    ASSERT_EQ(decompress_guarded({}, 16, output), std::nullopt);
+}
+
+TEST(CompressUnitTest, OffsetOutOfRange) {
+    std::vector<rudp::u8> output;
+    ASSERT_EQ(decompress_guarded({0x10, 'a', 0x01, 0x00, 0x00}, 16, output), 5);
+
+    ASSERT_EQ(decompress_guarded({0x10, 'a', 0x00, 0x00, 0x00}, 16, output), std::nullopt)
+        << "An offset of zero must be rejected.";
+    ASSERT_EQ(decompress_guarded({0x10, 'a', 0x02, 0x00, 0x00}, 16, output), std::nullopt)
+        << "An offset from before the start of the output must be rejected.";
+}
+
+TEST(CompressUnitTest, MatchPastOutput) {
+    std::vector<rudp::u8> output;
+    ASSERT_EQ(decompress_guarded({0x10, 'a', 0x01, 0x00, 0x00}, 4, output), std::nullopt)
+        << "A match running past the end of the output must be rejected.";
+    ASSERT_EQ(decompress_guarded({0x10, 'a', 0x01, 0x00, 0x10, 'b'}, 5, output), std::nullopt);
+}
+
+TEST(CompressUnitTest, OverlongLength) {
+    constexpr size_t size = rudp::internal::MAX_LZ_BLOCK;
+    std::vector<rudp::u8> output;
+
+    std::vector<rudp::u8> literals{0xF0};
+    literals.insert(literals.end(), size / 255 + 1, 255);
+    literals.push_back(0);
+    literals.insert(literals.end(), size + 255, 'a');
+    ASSERT_EQ(decompress_guarded(literals, size, output), std::nullopt)
+        << "A literal length past the output must be rejected.";
+
+    std::vector<rudp::u8> match{0x1F, 'a', 0x01, 0x00};
+    match.insert(match.end(), size / 255 + 1, 255);
+    match.push_back(0);
+    match.push_back(0x00);
+    ASSERT_EQ(decompress_guarded(match, size, output), std::nullopt)
+        << "A match length past the output must be rejected.";
+
+    const std::vector<rudp::u8> unterminated{0x1F, 'a', 0x01, 0x00, 255, 255};
+    ASSERT_EQ(decompress_guarded(unterminated, size, output), std::nullopt)
+        << "A length running off the end of the block must be rejected.";
+}
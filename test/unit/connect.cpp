@@ -64,6 +64,41 @@ TEST_F(ConnectUnitTest, SocketConnected) {
     ASSERT_EQ(errno, EOPNOTSUPP) << "A socket cannot connect twice.";
 }
 
+TEST_F(ConnectUnitTest, NonblockingInProgress) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::fcntl(clientfd, F_SETFL, O_NONBLOCK), 0);
+
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), -1);
+    ASSERT_EQ(errno, EINPROGRESS);
+
+    // NOTE: The handshake completes on the event thread, so a repeated connect() is the only way
+    // to observe it here.
+    while (rudp::connect(clientfd, &addr, sizeof(addr)) == -1 && errno == EALREADY) {
+    }
+    ASSERT_EQ(errno, EOPNOTSUPP) << "A connected socket cannot connect twice.";
+}
+
+TEST_F(ConnectUnitTest, SynRetransmitted) {
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::fcntl(clientfd, F_SETFL, O_NONBLOCK), 0);
+
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), -1);
+    ASSERT_EQ(errno, EINPROGRESS);
+
+    // NOTE: Nobody is listening yet, so only a retransmitted SYN can complete the handshake.
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    while (rudp::connect(clientfd, &addr, sizeof(addr)) == -1 && errno == EALREADY) {
+    }
+    ASSERT_EQ(errno, EOPNOTSUPP) << "The SYN must be retransmitted to the listener.";
+}
+
 TEST_F(ConnectUnitTest, SuccessFromCreated) {
     int serverfd = rudp::socket();
     ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "internal/common.hpp"
+#include "internal/crc32c.hpp"
+
+TEST(Crc32cUnitTest, CheckValue) {
+    constexpr std::string_view check = "123456789";
+    const std::span<const rudp::u8> data(reinterpret_cast<const rudp::u8 *>(check.data()),
+                                         check.size());
+
+    ASSERT_EQ(rudp::internal::crc32c_finish(
+                  rudp::internal::crc32c(rudp::internal::CRC32C_INITIAL, data)),
+              0xE3069283)
+        << "The checksum must be CRC32C, or peers computing it elsewhere will drop our packets.";
+    ASSERT_EQ(rudp::internal::crc32c_finish(
+                  rudp::internal::crc32c_software(rudp::internal::CRC32C_INITIAL, data)),
+              0xE3069283);
+}
+
+TEST(Crc32cUnitTest, HardwareMatchesSoftware) {
+    // NOTE: Several rounds of the hardware path's three strides, so that every join of them and
+    // every length of tail after them is covered.
+    std::vector<rudp::u8> data(3 * rudp::internal::constants::MAX_DATA_BYTES);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<rudp::u8>(i * 131 + (i >> 8));
+    }
+
+    std::vector<rudp::u8> copied(data.size());
+    for (size_t len = 0; len <= data.size(); len++) {
+        const std::span<const rudp::u8> prefix(data.data(), len);
+        const rudp::u32 expected =
+            rudp::internal::crc32c_software(rudp::internal::CRC32C_INITIAL, prefix);
+
+        ASSERT_EQ(rudp::internal::crc32c(rudp::internal::CRC32C_INITIAL, prefix), expected)
+            << "The paths must agree over " << len << " bytes.";
+        ASSERT_EQ(
+            rudp::internal::crc32c_copy(rudp::internal::CRC32C_INITIAL, prefix, copied.data()),
+            expected)
+            << "The paths must agree over " << len << " bytes when copying.";
+        ASSERT_TRUE(std::equal(prefix.begin(), prefix.end(), copied.begin()))
+            << "crc32c_copy() must copy all " << len << " bytes.";
+    }
+}
@@ -0,0 +1,26 @@
+#include <gtest/gtest.h>
+#include <sys/epoll.h>
+
+#include <rudp.hpp>
+
+TEST(EpollCreateUnitTest, SizeZero) {
+    ASSERT_EQ(rudp::epoll_create(0), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST(EpollCreateUnitTest, Success) {
+    int epfd = rudp::epoll_create(1);
+    ASSERT_GE(epfd, 0);
+
+    int fd = rudp::socket();
+    ASSERT_NE(epfd, fd) << "Instances and sockets must share one descriptor space.";
+}
+
+TEST(EpollCreateUnitTest, NotASocket) {
+    int epfd = rudp::epoll_create(1);
+    ASSERT_GE(epfd, 0);
+
+    char byte{};
+    ASSERT_EQ(rudp::send(epfd, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <sys/epoll.h>
+
+#include <rudp.hpp>
+
+TEST(EpollCtlUnitTest, EventNull) {
+    int epfd = rudp::epoll_create(1);
+    int fd = rudp::socket();
+
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, nullptr), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST(EpollCtlUnitTest, EpfdDne) {
+    int fd = rudp::socket();
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = fd}};
+
+    ASSERT_EQ(rudp::epoll_ctl(-1, EPOLL_CTL_ADD, fd, &event), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST(EpollCtlUnitTest, EpfdNotEpoll) {
+    int notepfd = rudp::socket();
+    int fd = rudp::socket();
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = fd}};
+
+    ASSERT_EQ(rudp::epoll_ctl(notepfd, EPOLL_CTL_ADD, fd, &event), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST(EpollCtlUnitTest, SockDne) {
+    int epfd = rudp::epoll_create(1);
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = -1}};
+
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, -1, &event), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST(EpollCtlUnitTest, Nested) {
+    int epfd = rudp::epoll_create(1);
+    int inner = rudp::epoll_create(1);
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = inner}};
+
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, inner, &event), -1);
+    ASSERT_EQ(errno, EPERM);
+}
+
+TEST(EpollCtlUnitTest, OpUnknown) {
+    int epfd = rudp::epoll_create(1);
+    int fd = rudp::socket();
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = fd}};
+
+    ASSERT_EQ(rudp::epoll_ctl(epfd, 42, fd, &event), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST(EpollCtlUnitTest, AddTwice) {
+    int epfd = rudp::epoll_create(1);
+    int fd = rudp::socket();
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = fd}};
+
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event), 0);
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event), -1);
+    ASSERT_EQ(errno, EEXIST);
+}
+
+TEST(EpollCtlUnitTest, ModNotAdded) {
+    int epfd = rudp::epoll_create(1);
+    int fd = rudp::socket();
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = fd}};
+
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &event), -1);
+    ASSERT_EQ(errno, ENOENT);
+}
+
+TEST(EpollCtlUnitTest, DelNotAdded) {
+    int epfd = rudp::epoll_create(1);
+    int fd = rudp::socket();
+
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr), -1);
+    ASSERT_EQ(errno, ENOENT);
+}
+
+TEST(EpollCtlUnitTest, AddModDel) {
+    int epfd = rudp::epoll_create(1);
+    int fd = rudp::socket();
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = fd}};
+
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event), 0);
+
+    event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &event), 0);
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr), 0);
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event), 0) << "A socket can be re-added.";
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <rudp.hpp>
+
+class EpollEventfdUnitTest : public testing::Test {
+protected:
+    EpollEventfdUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    static bool readable(int fd, int timeout) {
+        struct pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+        return ::poll(&pfd, 1, timeout) == 1 && (pfd.revents & POLLIN);
+    }
+};
+
+TEST_F(EpollEventfdUnitTest, EpfdDne) {
+    ASSERT_EQ(rudp::epoll_eventfd(-1), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(EpollEventfdUnitTest, EpfdNotEpoll) {
+    int fd = rudp::socket();
+
+    ASSERT_EQ(rudp::epoll_eventfd(fd), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(EpollEventfdUnitTest, Stable) {
+    int epfd = rudp::epoll_create(1);
+
+    int efd = rudp::epoll_eventfd(epfd);
+    ASSERT_GE(efd, 0);
+    ASSERT_EQ(rudp::epoll_eventfd(epfd), efd) << "An instance must own a single eventfd.";
+    ASSERT_FALSE(readable(efd, 0)) << "An empty instance must not be readable.";
+}
+
+TEST_F(EpollEventfdUnitTest, ReadableUntilDrained) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    int epfd = rudp::epoll_create(1);
+    int efd = rudp::epoll_eventfd(epfd);
+    struct epoll_event event{.events = EPOLLIN | EPOLLET, .data = {.fd = serverfd}};
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, serverfd, &event), 0);
+
+    struct epoll_event events[1];
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 0), 0);
+    ASSERT_FALSE(readable(efd, 0)) << "A drained instance must not be readable.";
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+    ASSERT_TRUE(readable(efd, 1000)) << "A ready socket must make the instance readable.";
+    ASSERT_TRUE(readable(efd, 0)) << "The eventfd must stay readable until the instance is waited.";
+
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 0), 1);
+    ASSERT_EQ(events[0].data.fd, serverfd);
+    ASSERT_FALSE(readable(efd, 0)) << "Reporting an edge must drain the eventfd.";
+}
+
+TEST_F(EpollEventfdUnitTest, ReadyBeforeRequested) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+    int epfd = rudp::epoll_create(1);
+    struct epoll_event event{.events = EPOLLOUT, .data = {.fd = clientfd}};
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, clientfd, &event), 0);
+
+    int efd = rudp::epoll_eventfd(epfd);
+    ASSERT_TRUE(readable(efd, 0)) << "Sockets queued before the request must be signalled.";
+}
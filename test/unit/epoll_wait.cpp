@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <cstdint>
+#include <rudp.hpp>
+
+class EpollWaitUnitTest : public testing::Test {
+protected:
+    EpollWaitUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+};
+
+TEST_F(EpollWaitUnitTest, EventsNull) {
+    int epfd = rudp::epoll_create(1);
+
+    ASSERT_EQ(rudp::epoll_wait(epfd, nullptr, 1, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(EpollWaitUnitTest, MaxeventsZero) {
+    int epfd = rudp::epoll_create(1);
+    struct epoll_event events[1];
+
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 0, 0), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(EpollWaitUnitTest, EpfdDne) {
+    struct epoll_event events[1];
+
+    ASSERT_EQ(rudp::epoll_wait(-1, events, 1, 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(EpollWaitUnitTest, Timeout) {
+    int epfd = rudp::epoll_create(1);
+    int fd = rudp::socket();
+    struct epoll_event event{.events = EPOLLIN | EPOLLOUT, .data = {.fd = fd}};
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event), 0);
+
+    struct epoll_event events[1];
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 20), 0) << "An unconnected socket is never ready.";
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST_F(EpollWaitUnitTest, ListenerReadable) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    int epfd = rudp::epoll_create(1);
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = serverfd}};
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, serverfd, &event), 0);
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+    struct epoll_event events[1];
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 1000), 1);
+    ASSERT_EQ(events[0].data.fd, serverfd);
+    ASSERT_EQ(events[0].events, static_cast<uint32_t>(EPOLLIN));
+}
+
+TEST_F(EpollWaitUnitTest, LevelTriggered) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+    int accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+    ASSERT_GE(accepted_fd, 0);
+
+    int epfd = rudp::epoll_create(1);
+    struct epoll_event event{.events = EPOLLIN, .data = {.fd = accepted_fd}};
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, accepted_fd, &event), 0);
+
+    char byte = 'x';
+    ASSERT_EQ(rudp::send(clientfd, &byte, sizeof(byte), 0), 1);
+
+    struct epoll_event events[1];
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 1000), 1);
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 0), 1) << "Unread data must be reported again.";
+
+    ASSERT_EQ(rudp::recv(accepted_fd, &byte, sizeof(byte), 0), 1);
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 0), 0) << "A drained socket must not be reported.";
+}
+
+TEST_F(EpollWaitUnitTest, EdgeTriggered) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+    int accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+    ASSERT_GE(accepted_fd, 0);
+
+    int epfd = rudp::epoll_create(1);
+    struct epoll_event event{.events = EPOLLIN | EPOLLET, .data = {.fd = accepted_fd}};
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, accepted_fd, &event), 0);
+
+    char byte = 'x';
+    ASSERT_EQ(rudp::send(clientfd, &byte, sizeof(byte), 0), 1);
+
+    struct epoll_event events[1];
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 1000), 1);
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 0), 0) << "An edge must only be reported once.";
+
+    ASSERT_EQ(rudp::send(clientfd, &byte, sizeof(byte), 0), 1);
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 1000), 1) << "New data must be a new edge.";
+}
+
+TEST_F(EpollWaitUnitTest, Oneshot) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+    int epfd = rudp::epoll_create(1);
+    struct epoll_event event{.events = EPOLLOUT | EPOLLONESHOT, .data = {.fd = clientfd}};
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, clientfd, &event), 0);
+
+    struct epoll_event events[1];
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 1000), 1);
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 0), 0) << "A oneshot must disarm once reported.";
+
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_MOD, clientfd, &event), 0);
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 0), 1) << "EPOLL_CTL_MOD must re-arm a oneshot.";
+}
+
+TEST_F(EpollWaitUnitTest, ZeroCopyCompletionErr) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+    // NOTE: Nothing is asked for, but EPOLLERR is always reported.
+    int epfd = rudp::epoll_create(1);
+    struct epoll_event event{.events = 0, .data = {.fd = clientfd}};
+    ASSERT_EQ(rudp::epoll_ctl(epfd, EPOLL_CTL_ADD, clientfd, &event), 0);
+
+    struct epoll_event events[1];
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 0), 0);
+
+    char byte = 'x';
+    ASSERT_EQ(rudp::send_zc(clientfd, &byte, sizeof(byte), 0), 1);
+
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 1000), 1) << "A completion must raise EPOLLERR.";
+    ASSERT_EQ(events[0].events, static_cast<uint32_t>(EPOLLERR));
+
+    uint32_t first{};
+    uint32_t last{};
+    ASSERT_EQ(rudp::send_zc_completions(clientfd, &first, &last, MSG_DONTWAIT), 0);
+    ASSERT_EQ(rudp::epoll_wait(epfd, events, 1, 0), 0) << "Reporting must clear EPOLLERR.";
+}
@@ -0,0 +1,41 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+
+#include <rudp.hpp>
+
+TEST(FcntlUnitTest, SockDne) {
+    ASSERT_EQ(rudp::fcntl(-1, F_GETFL), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST(FcntlUnitTest, CmdUnknown) {
+    int fd = rudp::socket();
+
+    ASSERT_EQ(rudp::fcntl(fd, F_GETFD), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST(FcntlUnitTest, GetflDefault) {
+    int fd = rudp::socket();
+
+    int flags = rudp::fcntl(fd, F_GETFL);
+    ASSERT_GE(flags, 0);
+    ASSERT_EQ(flags & O_NONBLOCK, 0) << "A socket must block by default.";
+}
+
+TEST(FcntlUnitTest, SetflNonblock) {
+    int fd = rudp::socket();
+
+    ASSERT_EQ(rudp::fcntl(fd, F_SETFL, rudp::fcntl(fd, F_GETFL) | O_NONBLOCK), 0);
+    ASSERT_NE(rudp::fcntl(fd, F_GETFL) & O_NONBLOCK, 0);
+
+    ASSERT_EQ(rudp::fcntl(fd, F_SETFL, rudp::fcntl(fd, F_GETFL) & ~O_NONBLOCK), 0);
+    ASSERT_EQ(rudp::fcntl(fd, F_GETFL) & O_NONBLOCK, 0);
+}
+
+TEST(FcntlUnitTest, SetflIgnoresUnsupported) {
+    int fd = rudp::socket();
+
+    ASSERT_EQ(rudp::fcntl(fd, F_SETFL, O_APPEND), 0);
+    ASSERT_EQ(rudp::fcntl(fd, F_GETFL) & O_APPEND, 0);
+}
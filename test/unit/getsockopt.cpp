@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <rudp.hpp>
+
+TEST(GetsockoptUnitTest, OptlenNull) {
+    int fd = rudp::socket();
+    int value{};
+
+    ASSERT_EQ(rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, nullptr), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST(GetsockoptUnitTest, SockDne) {
+    int value{};
+    socklen_t len = sizeof(value);
+
+    ASSERT_EQ(rudp::getsockopt(-1, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, &len), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST(GetsockoptUnitTest, OptlenTooSmall) {
+    int fd = rudp::socket();
+    int value{};
+    socklen_t len = 1;
+
+    ASSERT_EQ(rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, &len), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST(GetsockoptUnitTest, TransportDefault) {
+    int fd = rudp::socket();
+    int value = -1;
+    socklen_t len = sizeof(value);
+
+    ASSERT_EQ(rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, &len), 0);
+    ASSERT_EQ(value, rudp::RUDP_TRANSPORT_UDP);
+    ASSERT_EQ(len, sizeof(value));
+}
+
+TEST(GetsockoptUnitTest, TransportRoundTrip) {
+    int fd = rudp::socket();
+    int value = rudp::RUDP_TRANSPORT_LOOPBACK;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, sizeof(value)),
+              0);
+
+    value = -1;
+    socklen_t len = sizeof(value);
+    ASSERT_EQ(rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, &len), 0);
+    ASSERT_EQ(value, rudp::RUDP_TRANSPORT_LOOPBACK);
+}
+
+TEST(GetsockoptUnitTest, ShmRoundTrip) {
+    int fd = rudp::socket();
+    int value = 1;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_SHM, &value, sizeof(value)), 0);
+
+    value = -1;
+    socklen_t len = sizeof(value);
+    ASSERT_EQ(rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_SHM, &value, &len), 0);
+    ASSERT_EQ(value, 1);
+}
+
+TEST(GetsockoptUnitTest, ShmActiveUnconnected) {
+    int fd = rudp::socket();
+    int value = 1;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_SHM, &value, sizeof(value)), 0);
+
+    value = -1;
+    socklen_t len = sizeof(value);
+    ASSERT_EQ(rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_SHM_ACTIVE, &value, &len), 0);
+    ASSERT_EQ(value, 0) << "Opting in has no effect until a handshake completes.";
+}
+
+TEST(GetsockoptUnitTest, QueueingDelayUnconnected) {
+    int fd = rudp::socket();
+
+    int value = -1;
+    socklen_t len = sizeof(value);
+    ASSERT_EQ(rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_QUEUEING_DELAY, &value, &len), 0);
+    ASSERT_EQ(value, 0) << "Nothing has been received before a connection exists.";
+}
+
+TEST(GetsockoptUnitTest, CongestionWindowUnconnected) {
+    int fd = rudp::socket();
+
+    int value = -1;
+    socklen_t len = sizeof(value);
+    ASSERT_EQ(
+        rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_CONGESTION_WINDOW, &value, &len), 0);
+    ASSERT_EQ(value, 64) << "A connection starts with the full window.";
+}
+
+TEST(GetsockoptUnitTest, MessagesRoundTrip) {
+    int fd = rudp::socket();
+    int value = 1;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_MESSAGES, &value, sizeof(value)), 0);
+
+    value = -1;
+    socklen_t len = sizeof(value);
+    ASSERT_EQ(rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_MESSAGES, &value, &len), 0);
+    ASSERT_EQ(value, 1);
+}
+
+TEST(GetsockoptUnitTest, CompressionRoundTrip) {
+    int fd = rudp::socket();
+    int value = 1;
+    ASSERT_EQ(
+        rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_COMPRESSION, &value, sizeof(value)), 0);
+
+    value = -1;
+    socklen_t len = sizeof(value);
+    ASSERT_EQ(rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_COMPRESSION, &value, &len), 0);
+    ASSERT_EQ(value, 1);
+}
+
+TEST(GetsockoptUnitTest, FecRoundTrip) {
+    int fd = rudp::socket();
+    int value = 8;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_FEC, &value, sizeof(value)), 0);
+
+    value = -1;
+    socklen_t len = sizeof(value);
+    ASSERT_EQ(rudp::getsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_FEC, &value, &len), 0);
+    ASSERT_EQ(value, 8);
+}
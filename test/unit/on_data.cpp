@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <mutex>
+#include <rudp.hpp>
+#include <thread>
+#include <vector>
+
+class OnDataUnitTest : public testing::Test {
+protected:
+    OnDataUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+};
+
+TEST_F(OnDataUnitTest, SockDne) {
+    ASSERT_EQ(rudp::on_data(-1, [](std::span<const std::byte>) {}), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(OnDataUnitTest, SocketNotConnected) {
+    int fd = rudp::socket();
+
+    ASSERT_EQ(rudp::on_data(fd, [](std::span<const std::byte>) {}), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(OnDataUnitTest, DeliversOnEventThread) {
+    establish();
+
+    std::mutex mtx;
+    std::vector<char> received;
+    std::atomic<bool> on_user_thread{false};
+    const std::thread::id user_thread = std::this_thread::get_id();
+
+    ASSERT_EQ(rudp::on_data(accepted_fd,
+                            [&](std::span<const std::byte> data) {
+                                on_user_thread = on_user_thread ||
+                                                 (std::this_thread::get_id() == user_thread);
+
+                                std::lock_guard<std::mutex> lock(mtx);
+                                const auto *bytes = reinterpret_cast<const char *>(data.data());
+                                received.insert(received.end(), bytes, bytes + data.size());
+                            }),
+              0);
+
+    std::vector<char> sent(8 * 1024);
+    for (size_t i = 0; i < sent.size(); i++) {
+        sent[i] = static_cast<char>('A' + (i % 26));
+    }
+    ASSERT_EQ(rudp::send(clientfd, sent.data(), sent.size(), 0),
+              static_cast<ssize_t>(sent.size()));
+
+    while (true) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (received.size() >= sent.size()) {
+            break;
+        }
+    }
+
+    ASSERT_FALSE(on_user_thread) << "The callback must only run on the event thread.";
+    ASSERT_EQ(received, sent) << "The callback must see every byte, in order.";
+
+    char byte{};
+    ASSERT_EQ(rudp::recv(accepted_fd, &byte, sizeof(byte), MSG_DONTWAIT), -1);
+    ASSERT_EQ(errno, EAGAIN) << "Delivered data must bypass the receive buffer.";
+}
+
+TEST_F(OnDataUnitTest, Uninstall) {
+    establish();
+
+    ASSERT_EQ(rudp::on_data(accepted_fd, [](std::span<const std::byte>) {}), 0);
+    ASSERT_EQ(rudp::on_data(accepted_fd, nullptr), 0);
+
+    char byte = 'x';
+    ASSERT_EQ(rudp::send(clientfd, &byte, sizeof(byte), 0), 1);
+    ASSERT_EQ(rudp::recv(accepted_fd, &byte, sizeof(byte), 0), 1)
+        << "Without a callback, data must be buffered for recv().";
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstring>
+#include <rudp.hpp>
+
+class OpenStreamUnitTest : public testing::Test {
+protected:
+    OpenStreamUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+};
+
+TEST_F(OpenStreamUnitTest, SockDne) {
+    ASSERT_EQ(rudp::open_stream(-1), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(OpenStreamUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+
+    ASSERT_EQ(rudp::open_stream(fd), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(OpenStreamUnitTest, NumberedApart) {
+    establish();
+
+    ASSERT_EQ(rudp::open_stream(clientfd), 1);
+    ASSERT_EQ(rudp::open_stream(clientfd), 3);
+    ASSERT_EQ(rudp::open_stream(accepted_fd), 2) << "The peers must never number the same stream.";
+    ASSERT_EQ(rudp::open_stream(accepted_fd), 4);
+}
+
+TEST_F(OpenStreamUnitTest, Exhausted) {
+    establish();
+
+    for (int i = 0; i < (1 << 15); i++) {
+        ASSERT_GT(rudp::open_stream(clientfd), 0);
+    }
+
+    ASSERT_EQ(rudp::open_stream(clientfd), -1);
+    ASSERT_EQ(errno, ENOBUFS);
+}
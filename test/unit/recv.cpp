@@ -103,3 +103,16 @@ TEST_F(RecvUnitTest, Success) {
 
     ASSERT_GT(received, 0);
 }
+
+TEST_F(RecvUnitTest, DontwaitNoData) {
+    int clientfd = rudp::socket();
+    int serverfd = rudp::socket();
+
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+    char buffer[5]{};
+    ASSERT_EQ(rudp::recv(clientfd, buffer, sizeof(buffer), MSG_DONTWAIT), -1);
+    ASSERT_EQ(errno, EAGAIN);
+}
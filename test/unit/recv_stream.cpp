@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstring>
+#include <rudp.hpp>
+
+class RecvStreamUnitTest : public testing::Test {
+protected:
+    RecvStreamUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+};
+
+TEST_F(RecvStreamUnitTest, BufNull) {
+    establish();
+
+    ASSERT_EQ(rudp::recv_stream(accepted_fd, 0, nullptr, 1, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(RecvStreamUnitTest, SockDne) {
+    char byte{};
+
+    ASSERT_EQ(rudp::recv_stream(-1, 0, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(RecvStreamUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+    char byte{};
+
+    ASSERT_EQ(rudp::recv_stream(fd, 0, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(RecvStreamUnitTest, StreamUnknown) {
+    establish();
+    char byte{};
+
+    ASSERT_EQ(rudp::recv_stream(accepted_fd, 7, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(RecvStreamUnitTest, DontwaitNoData) {
+    establish();
+    char byte{};
+
+    const int opened = rudp::open_stream(accepted_fd);
+    ASSERT_EQ(rudp::recv_stream(accepted_fd, opened, &byte, sizeof(byte), MSG_DONTWAIT), -1);
+    ASSERT_EQ(errno, EAGAIN);
+}
+
+TEST_F(RecvStreamUnitTest, StreamsKeptApart) {
+    establish();
+
+    const int opened = rudp::open_stream(clientfd);
+    ASSERT_EQ(rudp::send_stream(clientfd, opened, "other", 5, 0), 5);
+    ASSERT_EQ(rudp::send(clientfd, "default", 7, 0), 7);
+
+    char received[16] = {};
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0), 7)
+        << "recv() must only see the default stream.";
+    ASSERT_EQ(memcmp(received, "default", 7), 0);
+
+    ASSERT_EQ(rudp::accept_stream(accepted_fd, 0), opened);
+    ASSERT_EQ(rudp::recv_stream(accepted_fd, opened, received, sizeof(received), 0), 5);
+    ASSERT_EQ(memcmp(received, "other", 5), 0);
+}
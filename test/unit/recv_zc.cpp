@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstring>
+#include <rudp.hpp>
+
+class RecvZcUnitTest : public testing::Test {
+protected:
+    RecvZcUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+};
+
+TEST_F(RecvZcUnitTest, BufNull) {
+    establish();
+
+    ASSERT_EQ(rudp::recv_zc(accepted_fd, nullptr, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(RecvZcUnitTest, SockDne) {
+    const void *buf = nullptr;
+
+    ASSERT_EQ(rudp::recv_zc(-1, &buf, 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(RecvZcUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+    const void *buf = nullptr;
+
+    ASSERT_EQ(rudp::recv_zc(fd, &buf, 0), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(RecvZcUnitTest, DontwaitNoData) {
+    establish();
+    const void *buf = nullptr;
+
+    ASSERT_EQ(rudp::recv_zc(accepted_fd, &buf, MSG_DONTWAIT), -1);
+    ASSERT_EQ(errno, EAGAIN);
+}
+
+TEST_F(RecvZcUnitTest, LoanSurvivesLaterReceives) {
+    establish();
+
+    const char first[] = "first";
+    ASSERT_EQ(rudp::send(clientfd, first, sizeof(first), 0), static_cast<ssize_t>(sizeof(first)));
+
+    const void *buf = nullptr;
+    ASSERT_EQ(rudp::recv_zc(accepted_fd, &buf, 0), static_cast<ssize_t>(sizeof(first)));
+
+    const char second[] = "second";
+    ASSERT_EQ(rudp::send(clientfd, second, sizeof(second), 0),
+              static_cast<ssize_t>(sizeof(second)));
+
+    char received[sizeof(second)];
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0),
+              static_cast<ssize_t>(sizeof(second)));
+
+    ASSERT_EQ(memcmp(buf, first, sizeof(first)), 0) << "A loan must be unaffected by later data.";
+    ASSERT_EQ(memcmp(received, second, sizeof(second)), 0);
+    ASSERT_EQ(rudp::release(accepted_fd, buf), 0);
+}
+
+TEST_F(RecvZcUnitTest, RemainderAfterRecv) {
+    establish();
+
+    const char data[] = "0123456789";
+    ASSERT_EQ(rudp::send(clientfd, data, sizeof(data), 0), static_cast<ssize_t>(sizeof(data)));
+
+    char head[4];
+    ASSERT_EQ(rudp::recv(accepted_fd, head, sizeof(head), 0), static_cast<ssize_t>(sizeof(head)));
+
+    const void *buf = nullptr;
+    ASSERT_EQ(rudp::recv_zc(accepted_fd, &buf, 0), static_cast<ssize_t>(sizeof(data) - 4))
+        << "A loan must start where recv() left off.";
+    ASSERT_EQ(memcmp(buf, data + 4, sizeof(data) - 4), 0);
+    ASSERT_EQ(rudp::release(accepted_fd, buf), 0);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstring>
+#include <rudp.hpp>
+#include <thread>
+
+class RecvmsgUnitTest : public testing::Test {
+protected:
+    RecvmsgUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+};
+
+TEST_F(RecvmsgUnitTest, MsgNull) {
+    establish();
+
+    ASSERT_EQ(rudp::recvmsg(accepted_fd, nullptr, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(RecvmsgUnitTest, SockDne) {
+    char byte{};
+    struct iovec iov{.iov_base = &byte, .iov_len = sizeof(byte)};
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    ASSERT_EQ(rudp::recvmsg(-1, &msg, 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(RecvmsgUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+
+    char byte{};
+    struct iovec iov{.iov_base = &byte, .iov_len = sizeof(byte)};
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    ASSERT_EQ(rudp::recvmsg(fd, &msg, 0), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(RecvmsgUnitTest, Scatters) {
+    establish();
+
+    const char data[] = "head:body";
+    ASSERT_EQ(rudp::send(clientfd, data, strlen(data), 0), static_cast<ssize_t>(strlen(data)));
+
+    char header[5];
+    char body[4];
+    struct iovec iov[] = {
+        {.iov_base = header, .iov_len = sizeof(header)},
+        {.iov_base = body, .iov_len = sizeof(body)},
+    };
+    struct msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
+    ASSERT_EQ(rudp::recvmsg(accepted_fd, &msg, MSG_WAITALL), static_cast<ssize_t>(strlen(data)));
+    ASSERT_EQ(memcmp(header, "head:", sizeof(header)), 0);
+    ASSERT_EQ(memcmp(body, "body", sizeof(body)), 0);
+    ASSERT_EQ(msg.msg_flags, 0);
+}
+
+TEST_F(RecvmsgUnitTest, Peek) {
+    establish();
+
+    const char data[] = "peek";
+    ASSERT_EQ(rudp::send(clientfd, data, sizeof(data), 0), static_cast<ssize_t>(sizeof(data)));
+
+    char first[2];
+    char second[sizeof(data) - 2];
+    struct iovec iov[] = {
+        {.iov_base = first, .iov_len = sizeof(first)},
+        {.iov_base = second, .iov_len = sizeof(second)},
+    };
+    struct msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
+    ASSERT_EQ(rudp::recvmsg(accepted_fd, &msg, MSG_PEEK | MSG_WAITALL),
+              static_cast<ssize_t>(sizeof(data)));
+    ASSERT_EQ(memcmp(first, "pe", sizeof(first)), 0);
+    ASSERT_EQ(memcmp(second, "ek", sizeof(second)), 0);
+
+    char received[sizeof(data)];
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0),
+              static_cast<ssize_t>(sizeof(data)))
+        << "Peeked bytes must remain on the buffer.";
+    ASSERT_STREQ(received, data);
+}
+
+TEST_F(RecvmsgUnitTest, WaitallAcrossSends) {
+    establish();
+
+    char received[sizeof("wait") + sizeof("all")] = {};
+    struct iovec iov{.iov_base = received, .iov_len = sizeof(received)};
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    std::thread sender([this]() {
+        for (const char *part : {"wait", "all"}) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            ASSERT_EQ(rudp::send(clientfd, part, strlen(part) + 1, 0),
+                      static_cast<ssize_t>(strlen(part) + 1));
+        }
+    });
+
+    ASSERT_EQ(rudp::recvmsg(accepted_fd, &msg, MSG_WAITALL), static_cast<ssize_t>(sizeof(received)))
+        << "MSG_WAITALL must not return until every buffer is full.";
+    sender.join();
+
+    ASSERT_STREQ(received, "wait");
+    ASSERT_STREQ(received + 5, "all");
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <rudp.hpp>
+
+class ReleaseUnitTest : public testing::Test {
+protected:
+    ReleaseUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+};
+
+TEST_F(ReleaseUnitTest, SockDne) {
+    char byte{};
+
+    ASSERT_EQ(rudp::release(-1, &byte), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(ReleaseUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+    char byte{};
+
+    ASSERT_EQ(rudp::release(fd, &byte), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(ReleaseUnitTest, NotLoaned) {
+    int serverfd = rudp::socket();
+    ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+    char byte = 'x';
+    ASSERT_EQ(rudp::send(clientfd, &byte, sizeof(byte), 0), 1);
+
+    int accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+    const void *buf = nullptr;
+    ASSERT_EQ(rudp::recv_zc(accepted_fd, &buf, 0), 1);
+
+    ASSERT_EQ(rudp::release(accepted_fd, &byte), -1);
+    ASSERT_EQ(errno, EINVAL) << "Only a loaned address can be released.";
+
+    ASSERT_EQ(rudp::release(accepted_fd, buf), 0);
+    ASSERT_EQ(rudp::release(accepted_fd, buf), -1);
+    ASSERT_EQ(errno, EINVAL) << "A loan can only be released once.";
+}
@@ -100,3 +100,17 @@ TEST_F(SendUnitTest, Success) {
     ssize_t sent = rudp::send(clientfd, message, strlen(message), 0);
     ASSERT_EQ(sent, static_cast<ssize_t>(strlen(message)));
 }
+
+TEST_F(SendUnitTest, DontwaitNotEstablished) {
+    // NOTE: Nothing listens here, so the handshake never completes.
+    reinterpret_cast<struct sockaddr_in *>(&addr)->sin_port = htons(1235);
+
+    int clientfd = rudp::socket();
+    ASSERT_EQ(rudp::fcntl(clientfd, F_SETFL, O_NONBLOCK), 0);
+    ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), -1);
+    ASSERT_EQ(errno, EINPROGRESS);
+
+    const char *message = "hello";
+    ASSERT_EQ(rudp::send(clientfd, message, strlen(message), MSG_DONTWAIT), -1);
+    ASSERT_EQ(errno, EAGAIN);
+}
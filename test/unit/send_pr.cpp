@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstring>
+#include <rudp.hpp>
+
+class SendPrUnitTest : public testing::Test {
+protected:
+    SendPrUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+};
+
+
+TEST_F(SendPrUnitTest, BufNull) {
+    establish();
+
+    ASSERT_EQ(rudp::send_pr(clientfd, 0, nullptr, 1, rudp::RUDP_PR_UNRELIABLE, 0, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(SendPrUnitTest, SockDne) {
+    char byte{};
+
+    ASSERT_EQ(rudp::send_pr(-1, 0, &byte, sizeof(byte), rudp::RUDP_PR_UNRELIABLE, 0, 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(SendPrUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+    char byte{};
+
+    ASSERT_EQ(rudp::send_pr(fd, 0, &byte, sizeof(byte), rudp::RUDP_PR_UNRELIABLE, 0, 0), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(SendPrUnitTest, PolicyInvalid) {
+    establish();
+    char byte{};
+
+    ASSERT_EQ(rudp::send_pr(clientfd, 0, &byte, sizeof(byte), 42, 0, 0), -1);
+    ASSERT_EQ(errno, EINVAL);
+
+    ASSERT_EQ(rudp::send_pr(clientfd, 0, &byte, sizeof(byte), rudp::RUDP_PR_DEADLINE, -1, 0), -1);
+    ASSERT_EQ(errno, EINVAL);
+
+    ASSERT_EQ(rudp::send_pr(clientfd, 0, &byte, sizeof(byte), rudp::RUDP_PR_RETRANSMITS, 20, 0),
+              -1);
+    ASSERT_EQ(errno, EINVAL) << "A message cannot outlast the connection's own retransmit limit.";
+}
+
+TEST_F(SendPrUnitTest, StreamNotOpened) {
+    establish();
+    char byte{};
+
+    ASSERT_EQ(rudp::send_pr(clientfd, 1, &byte, sizeof(byte), rudp::RUDP_PR_UNRELIABLE, 0, 0),
+              -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(SendPrUnitTest, TooLarge) {
+    establish();
+    char data[1025]{};
+
+    ASSERT_EQ(rudp::send_pr(clientfd, 0, data, sizeof(data), rudp::RUDP_PR_UNRELIABLE, 0, 0), -1);
+    ASSERT_EQ(errno, EMSGSIZE);
+}
+
+TEST_F(SendPrUnitTest, ReliableNotLimited) {
+    establish();
+    char data[4096];
+    memset(data, 'r', sizeof(data));
+
+    ASSERT_EQ(rudp::send_pr(clientfd, 0, data, sizeof(data), rudp::RUDP_PR_RELIABLE, 0, 0),
+              static_cast<ssize_t>(sizeof(data)))
+        << "A reliable message is an ordinary send, so must not be held to one packet.";
+
+    char received[sizeof(data)] = {};
+    size_t total = 0;
+    while (total < sizeof(received)) {
+        ssize_t bytes = rudp::recv(accepted_fd, received + total, sizeof(received) - total, 0);
+        ASSERT_GT(bytes, 0);
+        total += static_cast<size_t>(bytes);
+    }
+
+    ASSERT_EQ(memcmp(received, data, sizeof(data)), 0);
+}
+
+TEST_F(SendPrUnitTest, DeliveredWithoutLoss) {
+    establish();
+
+    ASSERT_EQ(rudp::send_pr(clientfd, 0, "one", 3, rudp::RUDP_PR_UNRELIABLE, 0, 0), 3);
+    ASSERT_EQ(rudp::send_pr(clientfd, 0, "two", 3, rudp::RUDP_PR_DEADLINE, 1000, 0), 3);
+    ASSERT_EQ(rudp::send_pr(clientfd, 0, "three", 5, rudp::RUDP_PR_RETRANSMITS, 2, 0), 5);
+    ASSERT_EQ(rudp::send(clientfd, "four", 4, 0), 4);
+
+    const char expected[] = "onetwothreefour";
+    char received[sizeof(expected)] = {};
+    size_t total = 0;
+    while (total < strlen(expected)) {
+        ssize_t bytes = rudp::recv(accepted_fd, received + total, sizeof(received) - total, 0);
+        ASSERT_GT(bytes, 0);
+        total += static_cast<size_t>(bytes);
+    }
+
+    ASSERT_STREQ(received, expected);
+}
+
+TEST_F(SendPrUnitTest, ExpiredBeforeSent) {
+    establish();
+
+    ASSERT_EQ(rudp::send_pr(clientfd, 0, "stale", 5, rudp::RUDP_PR_DEADLINE, 0, 0), 5);
+    ASSERT_EQ(rudp::send(clientfd, "fresh", 5, 0), 5);
+
+    char received[16] = {};
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0), 5);
+    ASSERT_STREQ(received, "fresh") << "A message past its deadline must never be sent.";
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstring>
+#include <rudp.hpp>
+
+class SendStreamUnitTest : public testing::Test {
+protected:
+    SendStreamUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+};
+
+TEST_F(SendStreamUnitTest, BufNull) {
+    establish();
+
+    ASSERT_EQ(rudp::send_stream(clientfd, 0, nullptr, 1, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(SendStreamUnitTest, SockDne) {
+    char byte{};
+
+    ASSERT_EQ(rudp::send_stream(-1, 0, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(SendStreamUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+    char byte{};
+
+    ASSERT_EQ(rudp::send_stream(fd, 0, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(SendStreamUnitTest, StreamOutOfRange) {
+    establish();
+    char byte{};
+
+    ASSERT_EQ(rudp::send_stream(clientfd, -1, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EINVAL);
+
+    ASSERT_EQ(rudp::send_stream(clientfd, 1 << 16, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(SendStreamUnitTest, StreamNotOpened) {
+    establish();
+    char byte{};
+
+    ASSERT_EQ(rudp::send_stream(clientfd, 1, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(SendStreamUnitTest, DefaultStreamIsSend) {
+    establish();
+
+    ASSERT_EQ(rudp::send_stream(clientfd, 0, "hello", 5, 0), 5);
+
+    char received[5];
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), 0), 5);
+    ASSERT_EQ(memcmp(received, "hello", 5), 0);
+}
+
+TEST_F(SendStreamUnitTest, BufferPerStream) {
+    establish();
+
+    // NOTE: Nothing reads, so stream 0 fills; another stream must still have room of its own.
+    std::vector<char> data(64 * 1024, 'x');
+    while (rudp::send(clientfd, data.data(), data.size(), MSG_DONTWAIT) > 0) {
+    }
+    ASSERT_EQ(errno, EAGAIN);
+
+    const int opened = rudp::open_stream(clientfd);
+    ASSERT_EQ(rudp::send_stream(clientfd, opened, data.data(), data.size(), MSG_DONTWAIT),
+              static_cast<ssize_t>(data.size()));
+}
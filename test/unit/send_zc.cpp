@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <cstring>
+#include <rudp.hpp>
+
+class SendZcUnitTest : public testing::Test {
+protected:
+    SendZcUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+};
+
+TEST_F(SendZcUnitTest, BufNull) {
+    establish();
+
+    ASSERT_EQ(rudp::send_zc(clientfd, nullptr, 1, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(SendZcUnitTest, SockDne) {
+    char byte{};
+
+    ASSERT_EQ(rudp::send_zc(-1, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(SendZcUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+    char byte{};
+
+    ASSERT_EQ(rudp::send_zc(fd, &byte, sizeof(byte), 0), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(SendZcUnitTest, ZeroLength) {
+    establish();
+    char byte{};
+
+    ASSERT_EQ(rudp::send_zc(clientfd, &byte, 0, 0), 0);
+
+    uint32_t first{};
+    uint32_t last{};
+    ASSERT_EQ(rudp::send_zc_completions(clientfd, &first, &last, MSG_DONTWAIT), -1)
+        << "An empty send must not be given an id.";
+    ASSERT_EQ(errno, EAGAIN);
+}
+
+TEST_F(SendZcUnitTest, TakesWholeBuffer) {
+    establish();
+
+    // NOTE: Larger than the send buffer, which a zero-copy send does not occupy.
+    std::vector<char> data(1024 * 1024, 'z');
+    ASSERT_EQ(rudp::send_zc(clientfd, data.data(), data.size(), 0),
+              static_cast<ssize_t>(data.size()));
+
+    std::vector<char> received(data.size());
+    size_t total = 0;
+    while (total < received.size()) {
+        ssize_t bytes =
+            rudp::recv(accepted_fd, received.data() + total, received.size() - total, 0);
+        ASSERT_GT(bytes, 0);
+        total += static_cast<size_t>(bytes);
+    }
+
+    ASSERT_EQ(memcmp(received.data(), data.data(), data.size()), 0);
+
+    uint32_t first{};
+    uint32_t last{};
+    ASSERT_EQ(rudp::send_zc_completions(clientfd, &first, &last, 0), 0);
+    ASSERT_EQ(first, 0u);
+    ASSERT_EQ(last, 0u);
+}
+
+TEST_F(SendZcUnitTest, InterleavedWithSend) {
+    establish();
+
+    const char copied[] = "copied ";
+    const char borrowed[] = "borrowed ";
+    const char after[] = "after";
+
+    ASSERT_EQ(rudp::send(clientfd, copied, strlen(copied), 0),
+              static_cast<ssize_t>(strlen(copied)));
+    ASSERT_EQ(rudp::send_zc(clientfd, borrowed, strlen(borrowed), 0),
+              static_cast<ssize_t>(strlen(borrowed)));
+    ASSERT_EQ(rudp::send(clientfd, after, sizeof(after), 0), static_cast<ssize_t>(sizeof(after)));
+
+    const char expected[] = "copied borrowed after";
+    char received[sizeof(expected)] = {};
+    size_t total = 0;
+    while (total < sizeof(expected)) {
+        ssize_t bytes = rudp::recv(accepted_fd, received + total, sizeof(received) - total, 0);
+        ASSERT_GT(bytes, 0);
+        total += static_cast<size_t>(bytes);
+    }
+
+    ASSERT_STREQ(received, expected) << "Zero-copy sends must keep their place in the stream.";
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <rudp.hpp>
+
+class SendZcCompletionsUnitTest : public testing::Test {
+protected:
+    SendZcCompletionsUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+};
+
+TEST_F(SendZcCompletionsUnitTest, RangeNull) {
+    establish();
+    uint32_t id{};
+
+    ASSERT_EQ(rudp::send_zc_completions(clientfd, nullptr, &id, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+
+    ASSERT_EQ(rudp::send_zc_completions(clientfd, &id, nullptr, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(SendZcCompletionsUnitTest, SockDne) {
+    uint32_t first{};
+    uint32_t last{};
+
+    ASSERT_EQ(rudp::send_zc_completions(-1, &first, &last, 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(SendZcCompletionsUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+    uint32_t first{};
+    uint32_t last{};
+
+    ASSERT_EQ(rudp::send_zc_completions(fd, &first, &last, 0), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(SendZcCompletionsUnitTest, DontwaitNoneCompleted) {
+    establish();
+    uint32_t first{};
+    uint32_t last{};
+
+    ASSERT_EQ(rudp::send_zc_completions(clientfd, &first, &last, MSG_DONTWAIT), -1);
+    ASSERT_EQ(errno, EAGAIN);
+}
+
+TEST_F(SendZcCompletionsUnitTest, CoalescesRange) {
+    establish();
+
+    const char data[3][8] = {"zero", "one", "two"};
+    for (const auto &buf : data) {
+        ASSERT_EQ(rudp::send_zc(clientfd, buf, sizeof(buf), 0), static_cast<ssize_t>(sizeof(buf)));
+    }
+
+    char received[sizeof(data)];
+    size_t total = 0;
+    while (total < sizeof(received)) {
+        ssize_t bytes = rudp::recv(accepted_fd, received + total, sizeof(received) - total, 0);
+        ASSERT_GT(bytes, 0);
+        total += static_cast<size_t>(bytes);
+    }
+
+    // NOTE: Completions may be reported piecemeal, but must cover each id once and in order.
+    uint32_t expected = 0;
+    while (expected < 3) {
+        uint32_t first{};
+        uint32_t last{};
+        ASSERT_EQ(rudp::send_zc_completions(clientfd, &first, &last, 0), 0);
+        ASSERT_EQ(first, expected);
+        ASSERT_GE(last, first);
+        expected = last + 1;
+    }
+
+    ASSERT_EQ(expected, 3u);
+
+    uint32_t first{};
+    uint32_t last{};
+    ASSERT_EQ(rudp::send_zc_completions(clientfd, &first, &last, MSG_DONTWAIT), -1)
+        << "A completion must only be reported once.";
+    ASSERT_EQ(errno, EAGAIN);
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstring>
+#include <rudp.hpp>
+
+class SendmsgUnitTest : public testing::Test {
+protected:
+    SendmsgUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = htons(1234);
+    }
+    struct sockaddr addr;
+
+    int clientfd;
+    int accepted_fd;
+
+    void establish() {
+        int serverfd = rudp::socket();
+        ASSERT_EQ(rudp::bind(serverfd, &addr, sizeof(addr)), 0);
+        ASSERT_EQ(rudp::listen(serverfd, 1), 0);
+
+        clientfd = rudp::socket();
+        ASSERT_EQ(rudp::connect(clientfd, &addr, sizeof(addr)), 0);
+
+        accepted_fd = rudp::accept(serverfd, nullptr, nullptr);
+        ASSERT_GE(accepted_fd, 0);
+    }
+};
+
+TEST_F(SendmsgUnitTest, MsgNull) {
+    establish();
+
+    ASSERT_EQ(rudp::sendmsg(clientfd, nullptr, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(SendmsgUnitTest, IovNull) {
+    establish();
+
+    struct msghdr msg{};
+    msg.msg_iovlen = 1;
+
+    ASSERT_EQ(rudp::sendmsg(clientfd, &msg, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(SendmsgUnitTest, BaseNull) {
+    establish();
+
+    struct iovec iov{.iov_base = nullptr, .iov_len = 1};
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    ASSERT_EQ(rudp::sendmsg(clientfd, &msg, 0), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(SendmsgUnitTest, TooManyBuffers) {
+    establish();
+
+    char byte{};
+    std::vector<struct iovec> iov(IOV_MAX + 1, {.iov_base = &byte, .iov_len = sizeof(byte)});
+    struct msghdr msg{};
+    msg.msg_iov = iov.data();
+    msg.msg_iovlen = iov.size();
+
+    ASSERT_EQ(rudp::sendmsg(clientfd, &msg, 0), -1);
+    ASSERT_EQ(errno, EMSGSIZE);
+}
+
+TEST_F(SendmsgUnitTest, ZeroLength) {
+    establish();
+
+    struct iovec iov{.iov_base = nullptr, .iov_len = 0};
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    ASSERT_EQ(rudp::sendmsg(clientfd, &msg, 0), 0);
+}
+
+TEST_F(SendmsgUnitTest, SockDne) {
+    char byte{};
+    struct iovec iov{.iov_base = &byte, .iov_len = sizeof(byte)};
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    ASSERT_EQ(rudp::sendmsg(-1, &msg, 0), -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(SendmsgUnitTest, SocketCreated) {
+    int fd = rudp::socket();
+
+    char byte{};
+    struct iovec iov{.iov_base = &byte, .iov_len = sizeof(byte)};
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    ASSERT_EQ(rudp::sendmsg(fd, &msg, 0), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+}
+
+TEST_F(SendmsgUnitTest, Gathers) {
+    establish();
+
+    char header[] = "head:";
+    char body[] = "body";
+    struct iovec iov[] = {
+        {.iov_base = header, .iov_len = strlen(header)},
+        {.iov_base = nullptr, .iov_len = 0},
+        {.iov_base = body, .iov_len = sizeof(body)},
+    };
+    struct msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 3;
+
+    const ssize_t total = static_cast<ssize_t>(strlen(header) + sizeof(body));
+    ASSERT_EQ(rudp::sendmsg(clientfd, &msg, 0), total);
+
+    char received[sizeof("head:body")] = {};
+    ASSERT_EQ(rudp::recv(accepted_fd, received, sizeof(received), MSG_WAITALL), total);
+    ASSERT_STREQ(received, "head:body");
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <rudp.hpp>
+
+class SetsockoptUnitTest : public testing::Test {
+protected:
+    SetsockoptUnitTest() : addr{} {
+        auto *addr_in = reinterpret_cast<struct sockaddr_in *>(&addr);
+        addr_in->sin_family = AF_INET;
+        addr_in->sin_addr.s_addr = INADDR_ANY;
+        addr_in->sin_port = 0;
+    }
+    struct sockaddr addr;
+};
+
+TEST_F(SetsockoptUnitTest, OptvalNull) {
+    int fd = rudp::socket();
+
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, nullptr, sizeof(int)), -1);
+    ASSERT_EQ(errno, EFAULT);
+}
+
+TEST_F(SetsockoptUnitTest, LevelUnknown) {
+    int fd = rudp::socket();
+    int value = rudp::RUDP_TRANSPORT_LOOPBACK;
+
+    ASSERT_EQ(rudp::setsockopt(fd, SOL_SOCKET, rudp::RUDP_TRANSPORT, &value, sizeof(value)), -1);
+    ASSERT_EQ(errno, ENOPROTOOPT);
+}
+
+TEST_F(SetsockoptUnitTest, OptnameUnknown) {
+    int fd = rudp::socket();
+    int value = 0;
+
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, -1, &value, sizeof(value)), -1);
+    ASSERT_EQ(errno, ENOPROTOOPT);
+}
+
+TEST_F(SetsockoptUnitTest, SockDne) {
+    int value = rudp::RUDP_TRANSPORT_LOOPBACK;
+
+    ASSERT_EQ(rudp::setsockopt(-1, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, sizeof(value)),
+              -1);
+    ASSERT_EQ(errno, EBADF);
+}
+
+TEST_F(SetsockoptUnitTest, TransportBadLength) {
+    int fd = rudp::socket();
+    int value = rudp::RUDP_TRANSPORT_LOOPBACK;
+
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, 1), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(SetsockoptUnitTest, TransportBadValue) {
+    int fd = rudp::socket();
+    int value = 42;
+
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, sizeof(value)),
+              -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(SetsockoptUnitTest, TransportSocketBound) {
+    int fd = rudp::socket();
+    ASSERT_EQ(rudp::bind(fd, &addr, sizeof(addr)), 0);
+
+    int value = rudp::RUDP_TRANSPORT_LOOPBACK;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, sizeof(value)),
+              -1);
+    ASSERT_EQ(errno, EOPNOTSUPP) << "A transport cannot be changed once bound.";
+}
+
+TEST_F(SetsockoptUnitTest, TransportSuccess) {
+    int fd = rudp::socket();
+    int value = rudp::RUDP_TRANSPORT_LOOPBACK;
+
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_TRANSPORT, &value, sizeof(value)),
+              0);
+    ASSERT_EQ(rudp::bind(fd, &addr, sizeof(addr)), 0);
+}
+
+TEST_F(SetsockoptUnitTest, ShmBadLength) {
+    int fd = rudp::socket();
+    char value = 1;
+
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_SHM, &value, sizeof(value)), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(SetsockoptUnitTest, ShmSocketListening) {
+    int fd = rudp::socket();
+    ASSERT_EQ(rudp::bind(fd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(fd, 1), 0);
+
+    int value = 1;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_SHM, &value, sizeof(value)), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP) << "The fast path is negotiated by the handshake.";
+}
+
+TEST_F(SetsockoptUnitTest, MessagesBadLength) {
+    int fd = rudp::socket();
+    char value = 1;
+
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_MESSAGES, &value, sizeof(value)),
+              -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(SetsockoptUnitTest, MessagesSocketListening) {
+    int fd = rudp::socket();
+    ASSERT_EQ(rudp::bind(fd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(fd, 1), 0);
+
+    int value = 1;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_MESSAGES, &value, sizeof(value)),
+              -1);
+    ASSERT_EQ(errno, EOPNOTSUPP) << "Accepted sockets inherit the mode when listen() is called.";
+}
+
+TEST_F(SetsockoptUnitTest, ShmActiveReadOnly) {
+    int fd = rudp::socket();
+    int value = 1;
+
+    ASSERT_EQ(
+        rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_SHM_ACTIVE, &value, sizeof(value)), -1);
+    ASSERT_EQ(errno, ENOPROTOOPT);
+}
+
+TEST_F(SetsockoptUnitTest, QueueingDelayReadOnly) {
+    int fd = rudp::socket();
+    int value = 1;
+
+    ASSERT_EQ(
+        rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_QUEUEING_DELAY, &value, sizeof(value)),
+        -1);
+    ASSERT_EQ(errno, ENOPROTOOPT);
+}
+
+TEST_F(SetsockoptUnitTest, CongestionWindowReadOnly) {
+    int fd = rudp::socket();
+    int value = 1;
+
+    ASSERT_EQ(
+        rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_CONGESTION_WINDOW, &value, sizeof(value)),
+        -1);
+    ASSERT_EQ(errno, ENOPROTOOPT);
+}
+
+TEST_F(SetsockoptUnitTest, FecGroupOutOfRange) {
+    int fd = rudp::socket();
+
+    int value = 33;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_FEC, &value, sizeof(value)), -1);
+    ASSERT_EQ(errno, EINVAL) << "A repair covers at most 32 segments.";
+
+    value = -1;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_FEC, &value, sizeof(value)), -1);
+    ASSERT_EQ(errno, EINVAL);
+}
+
+TEST_F(SetsockoptUnitTest, FecSocketListening) {
+    int fd = rudp::socket();
+    ASSERT_EQ(rudp::bind(fd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(fd, 1), 0);
+
+    int value = 4;
+    ASSERT_EQ(rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_FEC, &value, sizeof(value)), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP) << "Accepted sockets inherit the group when listen() is called.";
+}
+
+TEST_F(SetsockoptUnitTest, CompressionSocketListening) {
+    int fd = rudp::socket();
+    ASSERT_EQ(rudp::bind(fd, &addr, sizeof(addr)), 0);
+    ASSERT_EQ(rudp::listen(fd, 1), 0);
+
+    int value = 1;
+    ASSERT_EQ(
+        rudp::setsockopt(fd, rudp::SOL_RUDP, rudp::RUDP_COMPRESSION, &value, sizeof(value)), -1);
+    ASSERT_EQ(errno, EOPNOTSUPP) << "Accepted sockets inherit the option when listen() is called.";
+}